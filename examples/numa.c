@@ -0,0 +1,126 @@
+/* compare local and remote memory bandwidth and the throughput of block
+   compression with dynamic scheduling and with NUMA-aware chunk runs */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "zfp.h"
+
+#ifdef _OPENMP
+
+/* keeps sums from being optimized away */
+static volatile double checksum;
+
+/* sum of n doubles starting at p */
+static double
+sum(const double* p, size_t n)
+{
+  double s = 0;
+  size_t i;
+  for (i = 0; i < n; i++)
+    s += p[i];
+  return s;
+}
+
+/* bandwidth in GB/s of every thread reading the slab of thread (t + shift) % threads */
+static double
+bandwidth(const double* data, size_t n, int shift, int reps)
+{
+  double time, total = 0;
+  int r;
+  time = omp_get_wtime();
+  for (r = 0; r < reps; r++) {
+    #pragma omp parallel reduction(+:total) proc_bind(spread)
+    {
+      int threads = omp_get_num_threads();
+      int t = (omp_get_thread_num() + shift) % threads;
+      size_t first = n * t / threads;
+      size_t last = n * (t + 1) / threads;
+      total += sum(data + first, last - first);
+    }
+  }
+  time = omp_get_wtime() - time;
+  checksum = total;
+  return reps * n * sizeof(double) / (time * 1e9);
+}
+
+/* throughput in MB/s of compressing field through a plan made with method */
+static double
+throughput(const zfp_stream* zfp, const zfp_field* field, int threads, int method, int reps)
+{
+  zfp_plan* plan = zfp_plan_create(zfp, field, threads, 16.f, method);
+  size_t bytes = zfp_field_size(field, NULL) * sizeof(double);
+  double time;
+  int r;
+  zfp_plan_compress(plan, field->data);
+  time = omp_get_wtime();
+  for (r = 0; r < reps; r++)
+    zfp_plan_compress(plan, field->data);
+  time = omp_get_wtime() - time;
+  zfp_plan_free(plan);
+  return reps * bytes / (1024 * 1024 * time);
+}
+
+int main(int argc, char* argv[])
+{
+  size_t nx = 256;
+  double tolerance = 1e-3;
+  int threads = omp_get_max_threads();
+  int reps = 10;
+  zfp_field* field;
+  zfp_stream* zfp;
+  double* data;
+  size_t n, k;
+
+  switch (argc) {
+    case 4:
+      sscanf(argv[3], "%d", &threads);
+      /* FALLTHROUGH */
+    case 3:
+      sscanf(argv[2], "%lf", &tolerance);
+      /* FALLTHROUGH */
+    case 2:
+      sscanf(argv[1], "%zu", &nx);
+      break;
+  }
+  omp_set_num_threads(threads);
+
+  /* first touch places each z slab on the node of the thread that owns it */
+  n = nx * nx * nx;
+  data = (double*)malloc(n * sizeof(double));
+  #pragma omp parallel for schedule(static) proc_bind(spread)
+  for (k = 0; k < nx; k++) {
+    size_t i;
+    for (i = 0; i < nx * nx; i++) {
+      double x = (double)(i % nx) / nx, y = (double)(i / nx) / nx, z = (double)k / nx;
+      data[k * nx * nx + i] = sin(6 * x) * cos(5 * y) + z * z;
+    }
+  }
+
+  printf("threads=%d n=%zu^3\n", threads, nx);
+  printf("read local  %.2f GB/s\n", bandwidth(data, n, 0, reps));
+  printf("read remote %.2f GB/s\n", bandwidth(data, n, threads / 2, reps));
+
+  field = zfp_field_3d(data, zfp_type_double, nx, nx, nx);
+  zfp = zfp_stream_open(NULL);
+  zfp_stream_set_accuracy(zfp, tolerance);
+  printf("compress dynamic %.0f MB/s\n", throughput(zfp, field, threads, ZFP_BEST_CACHE, reps));
+  printf("compress numa    %.0f MB/s\n", throughput(zfp, field, threads, ZFP_BEST_CACHE | ZFP_BLOCKS_NUMA, reps));
+  printf("compress pinned  %.0f MB/s\n", throughput(zfp, field, threads, ZFP_BEST_CACHE | ZFP_BLOCKS_NUMA | ZFP_BLOCKS_PIN, reps));
+
+  zfp_stream_close(zfp);
+  zfp_field_free(field);
+  free(data);
+
+  return 0;
+}
+
+#else
+
+int main(void)
+{
+  fprintf(stderr, "numa requires OpenMP\n");
+  return EXIT_FAILURE;
+}
+
+#endif
@@ -20,6 +20,9 @@
 #define ZFP_MAX_PREC    64 /* maximum precision supported */
 #define ZFP_MIN_EXP  -1074 /* minimum floating-point base-2 exponent */
 
+/* number of blocks transformed together by batched block functions */
+#define ZFP_BATCH_SIZE 8
+
 /* header masks (enable via bitwise or; reader must use same mask) */
 #define ZFP_HEADER_NONE   0x0u /* no header */
 #define ZFP_HEADER_MAGIC  0x1u /* embed 64-bit magic */
@@ -47,7 +50,12 @@
 #define ZFP_MODE_SHORT_BITS  12 /* number of mode bits in short format */
 #define ZFP_MODE_LONG_BITS   64 /* number of mode bits in long format */
 #define ZFP_HEADER_MAX_BITS 148 /* max number of header bits */
-#define ZFP_HEADER_BLOCKS_MAX_BITS 448
+#define ZFP_HEADER_BLOCKS_MAX_BITS 704 /* fixed part of block header */
+#define ZFP_HEADER_BLOCKS_V1_BITS  448 /* fixed part of 32-bit block header */
+#define ZFP_BLOCKS_HEADER_VERSION    2 /* block header version written */
+#define ZFP_BLOCKS_HEADER_VERSIONED 0x80u /* flags versioned block header */
+#define ZFP_BLOCKS_HEADER_STATS     0x40u /* block header carries chunk stats */
+#define ZFP_BLOCKS_BEGS_TRAILER (~(size_t)0) /* header begs stored after chunks */
 #define ZFP_MODE_SHORT_MAX  ((1u << ZFP_MODE_SHORT_BITS) - 2)
 
 /* rounding mode for reducing bias; see build option ZFP_ROUNDING_MODE */
@@ -57,6 +65,11 @@
 
 #define ZFP_BEST_CACHE 1 /*Break blocks to maximize cache behavior per blocks*/
 #define ZFP_MAKE_EQUAL 2 /*Make blocks as regular as possible*/
+#define ZFP_BLOCKS_STATS 0x100 /*or with method to record min, max and mean of each chunk*/
+#define ZFP_BLOCKS_NUMA  0x200 /*or with method to give each thread a fixed run of chunks*/
+#define ZFP_BLOCKS_PIN   0x400 /*with ZFP_BLOCKS_NUMA, bind threads to OpenMP places*/
+#define ZFP_BLOCKS_FLAGS (ZFP_BLOCKS_STATS | ZFP_BLOCKS_NUMA | ZFP_BLOCKS_PIN)
+#define ZFP_DEFAULT_CACHE_BYTES 0x100000 /*per-thread cache assumed by partitioner*/
 
 /* types ------------------------------------------------------------------- */
 
@@ -72,15 +85,31 @@ typedef int zfp_bool; /* Boolean type */
 typedef enum {
   zfp_exec_serial = 0, /* serial execution (default) */
   zfp_exec_omp    = 1, /* OpenMP multi-threaded execution */
-  zfp_exec_cuda   = 2  /* CUDA parallel execution */
+  zfp_exec_cuda   = 2, /* CUDA parallel execution */
+  zfp_exec_threads = 3 /* persistent POSIX thread pool execution */
 } zfp_exec_policy;
 
+/*
+** When built with ZFP_WITH_SIMD on x86-64, AVX2 or AVX-512 codec kernels are
+** selected at run time.  Setting environment variable ZFP_SIMD to avx2 or
+** none caps this selection; it is read once, on first use.
+*/
+
 /* OpenMP execution parameters */
 typedef struct {
-  uint threads;    /* number of requested threads */
-  uint chunk_size; /* number of blocks per chunk (1D only) */
+  uint threads;      /* number of requested threads */
+  uint chunk_size;   /* number of blocks per chunk (1D only) */
+  uint64* index;     /* optional table of chunk bit offsets (may be NULL) */
+  size_t index_size; /* number of index entries (one more than chunks) */
 } zfp_exec_params_omp;
 
+/* thread pool execution parameters */
+typedef struct {
+  uint threads;      /* number of requested threads */
+  uint64* index;     /* optional table of chunk bit offsets (may be NULL) */
+  size_t index_size; /* number of index entries (one more than chunks) */
+} zfp_exec_params_threads;
+
 typedef struct {
   zfp_exec_policy policy; /* execution policy (serial, omp, ...) */
   void* params;           /* execution parameters */
@@ -157,17 +186,64 @@ typedef struct {
 /*beginning and number of elements in each chunk*/
 typedef struct{
   size_t bx,by,bz,bw; //Block size in each dimension*/
-  int nbeg;
+  size_t nbeg;
   size_t *begs;
+  size_t *costs; /*optional estimated cost of each chunk (NULL to estimate)*/
+  int nbusy;     /*number of entries in busy*/
+  double *busy;  /*seconds each thread spent on chunks during last call*/
+  double *stats; /*optional min, max and mean of each chunk (NULL for none)*/
+  int affinity;  /*ZFP_BLOCKS_NUMA and ZFP_BLOCKS_PIN flags (0 for dynamic scheduling)*/
 } zfp_blocks;
 
 
 /*beginning and number of elements in each chunk*/
 typedef struct{
   zfp_stream **streams;
-  int nstreams;
+  size_t nstreams;
 } zfp_streams;
 
+/*compression of same-shaped fields set up once and reused; calls through
+  a plan make no heap allocations*/
+typedef struct{
+  zfp_field field;      /*shape, type and strides planned for*/
+  int nthreads;         /*number of threads to use*/
+  zfp_stream *stream;   /*parameters, with bit stream over buffer*/
+  zfp_blocks *blocks;   /*chunk grid; begs of the container in buffer*/
+  zfp_chunks *chunks;   /*chunk descriptors*/
+  zfp_streams *threads; /*one stream over buffer per thread*/
+  size_t *order;        /*order in which chunks are handed to threads*/
+  size_t *slots;        /*worst-case bit offset of each chunk in buffer*/
+  size_t *scratch;      /*workspace for packing chunks*/
+  size_t *runs;         /*first chunk of each thread with ZFP_BLOCKS_NUMA*/
+  void *buffer;         /*single-stream block container*/
+  size_t bytes;         /*capacity of buffer*/
+} zfp_plan;
+
+/*receives compressed bytes in order; returns number of bytes consumed*/
+typedef size_t (*zfp_blocks_sink)(void *context, const void *data, size_t bytes);
+
+/*handle of a compression running in the background*/
+typedef struct zfp_async zfp_async;
+
+/*called from the background thread with the compressed size once done*/
+typedef void (*zfp_async_callback)(void *context, size_t bytes);
+
+/* memory-mapped and positioned file I/O for block containers (POSIX only) */
+#if defined(__unix__) || defined(__APPLE__)
+  #define ZFP_BLOCKS_FILE_IO
+#endif
+
+#ifdef ZFP_BLOCKS_FILE_IO
+/*block container mapped read-only from a file*/
+typedef struct{
+  void *data;         /*mapped file contents*/
+  size_t bytes;       /*length of mapping*/
+  zfp_stream *stream; /*stream over mapping, positioned at its start*/
+  zfp_field *field;   /*field metadata from header*/
+  zfp_blocks *blocks; /*chunk grid and begs from header*/
+} zfp_blocks_map;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -277,26 +353,32 @@ zfp_stream_maximum_size_blocks(
 );
 
 
-int zfp_break_axis(const int n,/*Number of elements in  axis*/ 
-                const int nparts, /*Number of parts to break axis into*/ 
-                int *fwind, /*begining index for each block*/
-                int *ewind /*Number of elements per block*/
+int zfp_break_axis(const size_t n,/*Number of elements in  axis*/ 
+                const size_t nparts, /*Number of parts to break axis into*/ 
+                size_t *fwind, /*begining index for each block*/
+                size_t *ewind /*Number of elements per block*/
 );
 zfp_blocks *zfp_optimal_parts_from_size(const int ndim,/*dimension*/
-                   const int *n, /*elements in each dimension*/
+                   const size_t *n, /*elements in each dimension*/
                    const float chunks_per_block,/*Approximate chunks in each block*/
                    const int method /*Method (1-cache, 2-equal) */ 
 );
+/*Chunk grid giving each of nthreads several chunks whose input, read
+  through the field strides, fits in cache_bytes (0 for default)*/
+zfp_blocks *zfp_optimal_parts_for_threads(const zfp_field *field, /*field to partition*/
+                   const int nthreads, /*number of threads to balance*/
+                   const size_t cache_bytes /*per-thread L2 or LLC share*/
+);
 /*Create chunk make for block size*/
 zfp_chunks *zfp_chunks_from_blocks(const int ndim, /*number of dimensions*/
-                                const int *nsize, /*length of each axis*/
+                                const size_t *nsize, /*length of each axis*/
                                 const zfp_blocks *blocks
                                 );
 
 
 
 zfp_blocks *zfp_break_into_blocks(const int ndim, /*number of dimensions*/
-                       const int *nsize, /*size of dimenson*/ 
+                       const size_t *nsize, /*size of dimenson*/ 
                        const int storage_per_block, /*amount of memory per block*/
                        const int elem_size, /*size of each elemnt*/ 
                        const float est_compression_rate, /*compression reate*/ 
@@ -385,6 +467,43 @@ zfp_stream_omp_chunk_size(
   const zfp_stream* stream /* compressed stream */
 );
 
+/* table of OpenMP chunk bit offsets (NULL if not set) */
+uint64*                    /* index with zfp_stream_omp_index_size() entries */
+zfp_stream_omp_index(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* number of entries in OpenMP chunk offset table */
+size_t                     /* number of entries (0 if not set) */
+zfp_stream_omp_index_size(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* number of chunks an OpenMP (de)compression of field is partitioned into */
+size_t                     /* number of chunks (0 if OpenMP is unavailable) */
+zfp_stream_omp_chunks(
+  const zfp_stream* stream, /* compressed stream */
+  const zfp_field* field    /* field to (de)compress */
+);
+
+/* number of thread pool threads to use */
+uint                       /* number of threads (0 for default) */
+zfp_stream_threads(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* table of thread pool chunk bit offsets (NULL if not set) */
+uint64*                    /* index with zfp_stream_threads_index_size() entries */
+zfp_stream_threads_index(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* number of entries in thread pool chunk offset table */
+size_t                     /* number of entries (0 if not set) */
+zfp_stream_threads_index_size(
+  const zfp_stream* stream /* compressed stream */
+);
+
 /* set execution policy */
 zfp_bool                 /* true upon success */
 zfp_stream_set_execution(
@@ -406,6 +525,40 @@ zfp_stream_set_omp_chunk_size(
   uint chunk_size     /* number of blocks per chunk (0 for default) */
 );
 
+/*
+** Set OpenMP execution policy and table of chunk bit offsets.  When set,
+** the array is partitioned into size - 1 chunks; compression fills in the
+** bit offset of each chunk relative to the start of the compressed data,
+** and decompression uses the same table to decode chunks in parallel.
+** The table is owned by the caller and must outlive its use by the stream.
+*/
+zfp_bool              /* true upon success */
+zfp_stream_set_omp_index(
+  zfp_stream* stream, /* compressed stream */
+  uint64* index,      /* table of size entries (NULL to clear) */
+  size_t size         /* number of entries (at least two) */
+);
+
+/*
+** Set thread pool execution policy and number of threads.  The pool is
+** started once per process and reused by every call; it does not change
+** OpenMP or any other global threading state.  Calls made while another
+** call holds the pool run on the calling thread alone.
+*/
+zfp_bool              /* true upon success */
+zfp_stream_set_threads(
+  zfp_stream* stream, /* compressed stream */
+  uint threads        /* number of threads to use (0 for default) */
+);
+
+/* set thread pool execution policy and table of chunk bit offsets */
+zfp_bool              /* true upon success */
+zfp_stream_set_threads_index(
+  zfp_stream* stream, /* compressed stream */
+  uint64* index,      /* table of size entries (NULL to clear) */
+  size_t size         /* number of entries (at least two) */
+);
+
 /* high-level API: compression mode and parameter settings ----------------- */
 
 /* unspecified configuration */
@@ -460,16 +613,28 @@ zfp_blocks *zfp_blocks_alloc(void);
 
 //zfp_blocks *zfp_blocks_alloc_begs(const size_t nblocks, const size_t *begs);
 /*allocate streams structiore*/
-zfp_streams *zfp_streams_alloc(const int nstreams);
+zfp_streams *zfp_streams_alloc(const size_t nstreams);
 
 /*allocate number of */
 void zfp_alloc_nblocks(zfp_blocks *block, const size_t nblocks);
 
+/*Record min, max and mean of each chunk when compressing with blocks and
+  store them in the block header*/
+void zfp_blocks_enable_stats(zfp_blocks *blocks);
+
+/*Indices of chunks whose values may lie in [lo,hi], going by their stats
+  (all chunks without stats); ichunks may be NULL to only count them*/
+size_t zfp_blocks_chunks_in_range(const zfp_blocks *blocks, /*block description*/
+                                  const double lo, /*lowest value wanted*/
+                                  const double hi, /*highest value wanted*/
+                                  size_t *ichunks /*chunk indices (nbeg entries)*/
+);
+
 
 
 /* allocate field struct */
 zfp_chunks* /* pointer to default initialized field */
-zfp_chunks_alloc(const int nchunks);
+zfp_chunks_alloc(const size_t nchunks);
 
 
 /* allocate metadata for 1D field f[nx] */
@@ -708,6 +873,33 @@ zfp_compress(
   const zfp_field* field /* field metadata */
 );
 
+/*
+** Start zfp_compress on a thread pool worker and return right away.  Neither
+** the field data nor the stream may be modified or freed until the handle
+** has been passed to zfp_wait, which every handle must be exactly once.
+** Without thread support, compression completes before the call returns.
+** The callback may call zfp_test on its own handle but not zfp_wait.
+*/
+zfp_async*                    /* completion handle (NULL upon failure) */
+zfp_compress_async(
+  zfp_stream* stream,          /* compressed stream */
+  const zfp_field* field,      /* field metadata */
+  zfp_async_callback callback, /* called once done (may be NULL) */
+  void* context                /* passed through to callback */
+);
+
+/* true if background compression has completed (set before the callback) */
+zfp_bool
+zfp_test(
+  zfp_async* handle /* completion handle */
+);
+
+/* wait for background compression and its callback to complete and free handle */
+size_t              /* return value of the compression call */
+zfp_wait(
+  zfp_async* handle /* completion handle */
+);
+
 #ifdef _OPENMP
 #include <omp.h>
 
@@ -719,12 +911,107 @@ size_t zfp_blocks_compress_single_stream(
   const int method /*method for compression*/
 );
 
+/*Compress field in bounded batches of chunks, handing header, chunks and a
+  trailing begs table to sink in order; readable by
+  zfp_blocks_decompress_single_stream when the stream spans exactly the
+  bytes emitted (0 returned on sink failure)*/
+size_t zfp_blocks_compress_to_sink(
+  zfp_stream* stream,    /* compression parameters */
+  const zfp_field* field, /* field metadata */
+  const int nthreads,/*number of threads to use*/
+  const float blocks_per_chunk, /*number of blocks per chunk*/
+  const int method, /*method for compression*/
+  zfp_blocks_sink sink, /*destination of compressed bytes*/
+  void *context /*passed through to sink*/
+);
+
+/*Start zfp_blocks_compress_single_stream on a background thread and return
+  right away; complete with zfp_wait as for zfp_compress_async*/
+zfp_async *zfp_blocks_compress_async(
+  zfp_stream* stream,    /* compressed stream */
+  const zfp_field* field, /* field metadata */
+  const int nthreads,/*number of threads to use*/
+  const float blocks_per_chunk, /*number of blocks per chunk*/
+  const int method, /*method for compression*/
+  zfp_async_callback callback, /*called once done (may be NULL)*/
+  void *context /*passed through to callback*/
+);
+
 size_t zfp_blocks_decompress_single_stream(
   zfp_stream* stream,    /* compressed stream */
   zfp_field* field, /* field metadata */
   const int nthreads/*number of threads to use*/
 );
 
+/*Decompress only the chunks of a single stream that intersect box into
+  field, whose extents match the box and whose strides address the caller
+  buffer; the container is read at the current stream position, which is
+  left unchanged; returns bytes of compressed chunks read (0 upon failure)*/
+size_t zfp_blocks_decompress_region(
+  zfp_stream* stream,    /* compressed stream */
+  zfp_field* field, /* destination of sub-box */
+  const zfp_chunk *box, /*first (fx..) and one past last (ex..) element*/
+  const int nthreads/*number of threads to use*/
+);
+
+#ifdef ZFP_BLOCKS_FILE_IO
+/*Map a block container file read-only and parse its header; decompress
+  map->stream with zfp_blocks_decompress_single_stream or
+  zfp_blocks_decompress_region without copying (NULL upon failure)*/
+zfp_blocks_map *zfp_blocks_map_open(const char *path /*block container file*/);
+
+/*Hint read-ahead of chunks intersecting box (all chunks when box is NULL);
+  returns number of chunks advised*/
+int zfp_blocks_map_advise(const zfp_blocks_map *map, /*mapped container*/
+  const zfp_chunk *box /*first (fx..) and one past last (ex..) element*/
+);
+
+/*Unmap file and free map*/
+void zfp_blocks_map_close(zfp_blocks_map *map);
+
+/*Compress field so that threads pwrite each chunk at its final file position
+  while others compress, then write the block header at offset; returns bytes
+  written (0 upon failure)*/
+size_t zfp_blocks_compress_to_fd(
+  zfp_stream* stream,    /* compression parameters */
+  const zfp_field* field, /* field metadata */
+  const int nthreads,/*number of threads to use*/
+  const float blocks_per_chunk, /*number of blocks per chunk*/
+  const int method, /*method for compression*/
+  const int fd, /*file descriptor open for writing*/
+  const size_t offset /*byte position of container in file*/
+);
+
+/*Decompress block container at offset of file, each thread preading the
+  chunks it decodes; field metadata is set from the header*/
+size_t zfp_blocks_decompress_from_fd(
+  zfp_field* field, /* field metadata */
+  const int nthreads,/*number of threads to use*/
+  const int fd, /*file descriptor open for reading*/
+  const size_t offset /*byte position of container in file*/
+);
+#endif
+
+/*Plan compression of fields shaped like field (data may be NULL; when set
+  it is sampled to order chunks by cost)*/
+zfp_plan *zfp_plan_create(
+    const zfp_stream *stream,     /* compression parameters */
+    const zfp_field *field,       /* field metadata */
+    const int nthreads,           /*number of threads to use*/
+    const float blocks_per_chunk, /*number of blocks per chunk*/
+    const int method              /*method for compression*/
+);
+
+/*Compress data into plan->buffer as a single-stream block container;
+  returns its length in bytes*/
+size_t zfp_plan_compress(zfp_plan *plan, const void *data);
+
+/*Decompress the container in plan->buffer into data (0 if it was not
+  written with the same shape, grid and parameters)*/
+size_t zfp_plan_decompress(zfp_plan *plan, void *data);
+
+void zfp_plan_free(zfp_plan *plan);
+
 /* compress entire field (nonzero return value upon success) */
 size_t                   /* cumulative number of bytes of compressed storage */
 zfp_blocks_compress_internal(
@@ -756,18 +1043,34 @@ zfp_blocks_decompress(
   zfp_stream* stream, /* compressed stream */
   zfp_field* field,    /* field metadata */
   const int nthreads,/*number of threads to use*/
-  const zfp_blocks *blocks   /*block description*/
+  zfp_blocks *blocks   /*block description (busy times are updated)*/
 );
 
 /*Create a series of zfp streams*/
 zfp_streams *zfp_create_streams(const zfp_stream *zfp_in,
-                                const int nblocks, /*number of blocks*/
+                                const size_t nblocks, /*number of blocks*/
                                 const size_t *blocks_boundaries/*block boundaries*/
                                 );
 
 /*Free zfp streams (not bitstream memory)*/
 void zfp_streams_free(zfp_streams *streams);
 
+/*Use compressed chunk sizes in begs (e.g. of previous timestep) as chunk costs*/
+void zfp_blocks_costs_from_begs(zfp_blocks *blocks);
+
+/*Time compression of a slab of field with chunk grids around that of
+  zfp_optimal_parts_for_threads and return the fastest grid for all of field*/
+zfp_blocks *zfp_autotune_parts(const zfp_stream *stream, /*compression parameters*/
+                               const zfp_field *field, /*field to partition*/
+                               const int nthreads, /*number of threads to use*/
+                               const size_t cache_bytes /*per-thread cache (0 for default)*/
+);
+
+/*Seconds thread spent (de)compressing chunks during last call using blocks*/
+double zfp_blocks_thread_busy(const zfp_blocks *blocks, /*block description*/
+                              const int ithread /*thread number*/
+);
+
 zfp_streams *zfp_blocks_compress_multi(
     zfp_stream *stream,           /* compressed stream */
     const zfp_field *field,       /* field metadata */
@@ -898,14 +1201,17 @@ array.  In the latter case, p points to the first scalar; (nx, ny, nz) specify
 the size of the block, with 1 <= nx, ny, nz <= 4; and (sx, sy, sz) specify the
 strides, i.e. the number of scalars to advance to get to the next scalar along
 each dimension.  The functions return the number of bits of compressed storage
-needed for the compressed block.
+needed for the compressed block.  The batched functions compress n complete
+blocks whose first scalars are given by p[0], ..., p[n - 1], in that order, and
+produce the same stream as compressing the blocks one at a time; they return
+the total number of bits.
 */
 
 /*set chubj*/
-void zfp_set_chunk_1d(zfp_chunk *chunk, const int fx, const int ex);
-void zfp_set_chunk_2d(zfp_chunk *chunk, const int fx, const int fy, const int ex, const int ey);
-void zfp_set_chunk_3d(zfp_chunk *chunk, const int fx, const int fy, const int fz, const int ex, const int ey, const int ez);
-void zfp_set_chunk_4d(zfp_chunk *chunk, const int fx, const int fy, const int fz, const int fw, const int ex, const int ey, const int ez, const int ew);
+void zfp_set_chunk_1d(zfp_chunk *chunk, const size_t fx, const size_t ex);
+void zfp_set_chunk_2d(zfp_chunk *chunk, const size_t fx, const size_t fy, const size_t ex, const size_t ey);
+void zfp_set_chunk_3d(zfp_chunk *chunk, const size_t fx, const size_t fy, const size_t fz, const size_t ex, const size_t ey, const size_t ez);
+void zfp_set_chunk_4d(zfp_chunk *chunk, const size_t fx, const size_t fy, const size_t fz, const size_t fw, const size_t ex, const size_t ey, const size_t ez, const size_t ew);
 
 /* encode 1D contiguous block of 4 values */
 size_t zfp_encode_block_int32_1(zfp_stream* stream, const int32* block);
@@ -923,6 +1229,12 @@ size_t zfp_encode_partial_block_strided_int64_1(zfp_stream* stream, const int64*
 size_t zfp_encode_partial_block_strided_float_1(zfp_stream* stream, const float* p, size_t nx, ptrdiff_t sx);
 size_t zfp_encode_partial_block_strided_double_1(zfp_stream* stream, const double* p, size_t nx, ptrdiff_t sx);
 
+/* encode 1D batch of complete blocks from strided array */
+size_t zfp_encode_blocks_strided_int32_1(zfp_stream* stream, const int32* const* p, size_t n, ptrdiff_t sx);
+size_t zfp_encode_blocks_strided_int64_1(zfp_stream* stream, const int64* const* p, size_t n, ptrdiff_t sx);
+size_t zfp_encode_blocks_strided_float_1(zfp_stream* stream, const float* const* p, size_t n, ptrdiff_t sx);
+size_t zfp_encode_blocks_strided_double_1(zfp_stream* stream, const double* const* p, size_t n, ptrdiff_t sx);
+
 /* encode 2D contiguous block of 4x4 values */
 size_t zfp_encode_block_int32_2(zfp_stream* stream, const int32* block);
 size_t zfp_encode_block_int64_2(zfp_stream* stream, const int64* block);
@@ -934,6 +1246,12 @@ size_t zfp_encode_partial_block_strided_int32_2(zfp_stream* stream, const int32*
 size_t zfp_encode_partial_block_strided_int64_2(zfp_stream* stream, const int64* p, size_t nx, size_t ny, ptrdiff_t sx, ptrdiff_t sy);
 size_t zfp_encode_partial_block_strided_float_2(zfp_stream* stream, const float* p, size_t nx, size_t ny, ptrdiff_t sx, ptrdiff_t sy);
 size_t zfp_encode_partial_block_strided_double_2(zfp_stream* stream, const double* p, size_t nx, size_t ny, ptrdiff_t sx, ptrdiff_t sy);
+
+/* encode 2D batch of complete blocks from strided array */
+size_t zfp_encode_blocks_strided_int32_2(zfp_stream* stream, const int32* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy);
+size_t zfp_encode_blocks_strided_int64_2(zfp_stream* stream, const int64* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy);
+size_t zfp_encode_blocks_strided_float_2(zfp_stream* stream, const float* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy);
+size_t zfp_encode_blocks_strided_double_2(zfp_stream* stream, const double* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy);
 size_t zfp_encode_block_strided_int32_2(zfp_stream* stream, const int32* p, ptrdiff_t sx, ptrdiff_t sy);
 size_t zfp_encode_block_strided_int64_2(zfp_stream* stream, const int64* p, ptrdiff_t sx, ptrdiff_t sy);
 size_t zfp_encode_block_strided_float_2(zfp_stream* stream, const float* p, ptrdiff_t sx, ptrdiff_t sy);
@@ -955,6 +1273,12 @@ size_t zfp_encode_partial_block_strided_int64_3(zfp_stream* stream, const int64*
 size_t zfp_encode_partial_block_strided_float_3(zfp_stream* stream, const float* p, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
 size_t zfp_encode_partial_block_strided_double_3(zfp_stream* stream, const double* p, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
 
+/* encode 3D batch of complete blocks from strided array */
+size_t zfp_encode_blocks_strided_int32_3(zfp_stream* stream, const int32* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+size_t zfp_encode_blocks_strided_int64_3(zfp_stream* stream, const int64* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+size_t zfp_encode_blocks_strided_float_3(zfp_stream* stream, const float* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+size_t zfp_encode_blocks_strided_double_3(zfp_stream* stream, const double* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+
 /* encode 4D contiguous block of 4x4x4x4 values */
 size_t zfp_encode_block_int32_4(zfp_stream* stream, const int32* block);
 size_t zfp_encode_block_int64_4(zfp_stream* stream, const int64* block);
@@ -971,11 +1295,18 @@ size_t zfp_encode_partial_block_strided_int64_4(zfp_stream* stream, const int64*
 size_t zfp_encode_partial_block_strided_float_4(zfp_stream* stream, const float* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
 size_t zfp_encode_partial_block_strided_double_4(zfp_stream* stream, const double* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
 
+/* encode 4D batch of complete blocks from strided array */
+size_t zfp_encode_blocks_strided_int32_4(zfp_stream* stream, const int32* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
+size_t zfp_encode_blocks_strided_int64_4(zfp_stream* stream, const int64* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
+size_t zfp_encode_blocks_strided_float_4(zfp_stream* stream, const float* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
+size_t zfp_encode_blocks_strided_double_4(zfp_stream* stream, const double* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
+
 /* low-level API: decoder -------------------------------------------------- */
 
 /*
-Each function below decompresses a single block and returns the number of bits
-of compressed storage consumed.  See corresponding encoder functions above for
+Each function below decompresses a single block (or, for the batched functions,
+n complete blocks) and returns the number of bits of compressed storage
+consumed.  See corresponding encoder functions above for
 further details.
 */
 
@@ -995,6 +1326,12 @@ size_t zfp_decode_partial_block_strided_int64_1(zfp_stream* stream, int64* p, si
 size_t zfp_decode_partial_block_strided_float_1(zfp_stream* stream, float* p, size_t nx, ptrdiff_t sx);
 size_t zfp_decode_partial_block_strided_double_1(zfp_stream* stream, double* p, size_t nx, ptrdiff_t sx);
 
+/* decode 1D batch of complete blocks from strided array */
+size_t zfp_decode_blocks_strided_int32_1(zfp_stream* stream, int32* const* p, size_t n, ptrdiff_t sx);
+size_t zfp_decode_blocks_strided_int64_1(zfp_stream* stream, int64* const* p, size_t n, ptrdiff_t sx);
+size_t zfp_decode_blocks_strided_float_1(zfp_stream* stream, float* const* p, size_t n, ptrdiff_t sx);
+size_t zfp_decode_blocks_strided_double_1(zfp_stream* stream, double* const* p, size_t n, ptrdiff_t sx);
+
 /* decode 2D contiguous block of 4x4 values */
 size_t zfp_decode_block_int32_2(zfp_stream* stream, int32* block);
 size_t zfp_decode_block_int64_2(zfp_stream* stream, int64* block);
@@ -1011,6 +1348,12 @@ size_t zfp_decode_partial_block_strided_int64_2(zfp_stream* stream, int64* p, si
 size_t zfp_decode_partial_block_strided_float_2(zfp_stream* stream, float* p, size_t nx, size_t ny, ptrdiff_t sx, ptrdiff_t sy);
 size_t zfp_decode_partial_block_strided_double_2(zfp_stream* stream, double* p, size_t nx, size_t ny, ptrdiff_t sx, ptrdiff_t sy);
 
+/* decode 2D batch of complete blocks from strided array */
+size_t zfp_decode_blocks_strided_int32_2(zfp_stream* stream, int32* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy);
+size_t zfp_decode_blocks_strided_int64_2(zfp_stream* stream, int64* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy);
+size_t zfp_decode_blocks_strided_float_2(zfp_stream* stream, float* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy);
+size_t zfp_decode_blocks_strided_double_2(zfp_stream* stream, double* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy);
+
 /* decode 3D contiguous block of 4x4x4 values */
 size_t zfp_decode_block_int32_3(zfp_stream* stream, int32* block);
 size_t zfp_decode_block_int64_3(zfp_stream* stream, int64* block);
@@ -1027,6 +1370,12 @@ size_t zfp_decode_partial_block_strided_int64_3(zfp_stream* stream, int64* p, si
 size_t zfp_decode_partial_block_strided_float_3(zfp_stream* stream, float* p, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
 size_t zfp_decode_partial_block_strided_double_3(zfp_stream* stream, double* p, size_t nx, size_t ny, size_t nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
 
+/* decode 3D batch of complete blocks from strided array */
+size_t zfp_decode_blocks_strided_int32_3(zfp_stream* stream, int32* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+size_t zfp_decode_blocks_strided_int64_3(zfp_stream* stream, int64* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+size_t zfp_decode_blocks_strided_float_3(zfp_stream* stream, float* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+size_t zfp_decode_blocks_strided_double_3(zfp_stream* stream, double* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz);
+
 /* decode 4D contiguous block of 4x4x4x4 values */
 size_t zfp_decode_block_int32_4(zfp_stream* stream, int32* block);
 size_t zfp_decode_block_int64_4(zfp_stream* stream, int64* block);
@@ -1043,6 +1392,12 @@ size_t zfp_decode_partial_block_strided_int64_4(zfp_stream* stream, int64* p, si
 size_t zfp_decode_partial_block_strided_float_4(zfp_stream* stream, float* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
 size_t zfp_decode_partial_block_strided_double_4(zfp_stream* stream, double* p, size_t nx, size_t ny, size_t nz, size_t nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
 
+/* decode 4D batch of complete blocks from strided array */
+size_t zfp_decode_blocks_strided_int32_4(zfp_stream* stream, int32* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
+size_t zfp_decode_blocks_strided_int64_4(zfp_stream* stream, int64* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
+size_t zfp_decode_blocks_strided_float_4(zfp_stream* stream, float* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
+size_t zfp_decode_blocks_strided_double_4(zfp_stream* stream, double* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw);
+
 /* low-level API: utility functions ---------------------------------------- */
 
 /* convert dims-dimensional contiguous block to 32-bit integer type */
@@ -1056,9 +1411,9 @@ void zfp_demote_int32_to_int8(int8* oblock, const int32* iblock, uint dims);
 void zfp_demote_int32_to_uint8(uint8* oblock, const int32* iblock, uint dims);
 void zfp_demote_int32_to_int16(int16* oblock, const int32* iblock, uint dims);
 void zfp_demote_int32_to_uint16(uint16* oblock, const int32* iblock, uint dims);
-int zfp_total_chunks(const int ndim, const zfp_blocks *blocks, int *nchunk_blocks);
+size_t zfp_total_chunks(const int ndim, const zfp_blocks *blocks, size_t *nchunk_blocks);
 
-int zfp_field_to_n(const zfp_field *field, int *n);
+int zfp_field_to_n(const zfp_field *field, size_t *n);
 
 
 
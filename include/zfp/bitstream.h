@@ -60,6 +60,9 @@ uint stream_write_bit(bitstream* stream, uint bit);
 /* read 0 <= n <= 64 bits */
 uint64 stream_read_bits(bitstream* stream, bitstream_count n);
 
+/* read through next one-bit but no more than n bits; return number of zero-bits read */
+bitstream_count stream_read_zeros(bitstream* stream, bitstream_count n);
+
 /* write 0 <= n <= 64 low bits of value and return remaining bits */
 uint64 stream_write_bits(bitstream* stream, uint64 value, bitstream_count n);
 
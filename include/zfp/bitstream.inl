@@ -156,6 +156,20 @@ stream_read_word(bitstream* s)
   return w;
 }
 
+/* count trailing zero-bits in nonzero word */
+static bitstream_count
+stream_ctz(bitstream_word w)
+{
+#if defined(__GNUC__)
+  return (bitstream_count)__builtin_ctzll(w);
+#else
+  bitstream_count n = 0;
+  for (; !(w & 1u); w >>= 1)
+    n++;
+  return n;
+#endif
+}
+
 /* write a single word to memory */
 static void
 stream_write_word(bitstream* s, bitstream_word value)
@@ -284,6 +298,41 @@ stream_read_bits(bitstream* s, bitstream_count n)
   return value;
 }
 
+/* read through next one-bit but no more than n bits; return number of zero-bits read */
+inline_ bitstream_count
+stream_read_zeros(bitstream* s, bitstream_count n)
+{
+  bitstream_count z = 0;
+  while (z < n) {
+    bitstream_count m;
+    bitstream_word w;
+    if (!s->bits) {
+      s->buffer = stream_read_word(s);
+      s->bits = wsize;
+    }
+    /* examine up to m buffered bits at once */
+    m = n - z < s->bits ? n - z : s->bits;
+    w = m < s->bits ? (bitstream_word)(s->buffer & (((bitstream_word)1 << m) - 1)) : s->buffer;
+    if (w) {
+      /* consume zero-bits and first one-bit */
+      m = stream_ctz(w);
+      s->bits -= m + 1;
+      /* shift in two steps since m + 1 may equal wsize */
+      s->buffer >>= m;
+      s->buffer >>= 1;
+      return z + m;
+    }
+    /* assert: next m bits are zero */
+    s->bits -= m;
+    if (s->bits)
+      s->buffer >>= m;
+    else
+      s->buffer = 0;
+    z += m;
+  }
+  return z;
+}
+
 /* write 0 <= n <= 64 low bits of value and return remaining bits */
 inline_ uint64
 stream_write_bits(bitstream* s, uint64 value, bitstream_count n)
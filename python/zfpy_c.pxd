@@ -34,16 +34,16 @@ cdef extern from "zfp.h":
 
     ctypedef struct zfp_chunk:
         size_t fx, fy, fz, fw
-        size_t ex, fy, fz, fw
+        size_t ex, ey, ez, ew
 
     ctypedef struct zfp_chunks:
         size_t nchunks
         zfp_chunk **chunks
    
     ctypedef struct zfp_blocks:
-        int bx, by, bz, bw
-        int nbeg
-        int *begs
+        size_t bx, by, bz, bw
+        size_t nbeg
+        size_t *begs
 
 
 
@@ -58,6 +58,7 @@ cdef extern from "zfp.h":
     cython.uint ZFP_HEADER_META
     cython.uint ZFP_HEADER_MODE
     cython.uint ZFP_HEADER_FULL
+    cython.uint ZFP_HEADER_MAX_BITS
 
     # function declarations
     zfp_stream* zfp_stream_open(bitstream* stream)
@@ -75,8 +76,8 @@ cdef extern from "zfp.h":
     zfp_mode zfp_stream_set_mode(zfp_stream* stream, stdint.uint64_t mode)
     zfp_mode zfp_stream_compression_mode(zfp_stream* stream)
     double zfp_stream_accuracy(zfp_stream* stream)
-    zfp_blocks *zfp_optimal_parts_from_size(const int ndim , const int *n, const float chunks_per_block,const int method)
-    zfp_chunks *zfp_chunks_from_blocks(const int ndim, const int *nsize,zfp_blocks *blocks)
+    zfp_blocks *zfp_optimal_parts_from_size(const int ndim , const size_t *n, const float chunks_per_block,const int method)
+    zfp_chunks *zfp_chunks_from_blocks(const int ndim, const size_t *nsize,zfp_blocks *blocks)
     double zfp_stream_rate(zfp_stream* stream, cython.uint dims)
     cython.uint zfp_stream_precision(const zfp_stream* stream)
     zfp_chunk* zfp_chunk_alloc()
@@ -99,13 +100,15 @@ cdef extern from "zfp.h":
     size_t zfp_decompress(zfp_stream* stream, zfp_field* field) nogil
     size_t zfp_compress_chunk(zfp_stream* stream, const zfp_chunk * chunk, const zfp_field* field) nogil
     size_t zfp_decompress_chunk(zfp_stream* stream, const zfp_chunk *chunk, zfp_field* field) nogil
+    size_t zfp_blocks_compress_internal(zfp_stream* stream, const zfp_field* field, const int nthreads, zfp_blocks* blocks) nogil
+    size_t zfp_blocks_decompress(zfp_stream* stream, zfp_field* field, const int nthreads, zfp_blocks* blocks) nogil
     size_t zfp_write_header(zfp_stream* stream, const zfp_field* field, cython.uint mask)
     size_t zfp_read_header(zfp_stream* stream, zfp_field* field, cython.uint mask)
     void zfp_stream_params(zfp_stream* stream, cython.uint* minbits, cython.uint* maxbits, cython.uint* maxprec, int* minexp);
 
-    void zfp_set_chunk_1d(zfp_chunk* field, int fx, int ex)
-    void zfp_set_chunk_2d(zfp_chunk* field, int fx,int fy,  int ex, int ey)
-    void zfp_set_chunk_3d(zfp_chunk* field, int fx,int fy, int fz, int ex, int ny, int ez)
-    void zfp_set_chunk_4d(zfp_chunk* field, int fx,int fy, int fz, int fw, int nx, int ey, int ez, int ew)
+    void zfp_set_chunk_1d(zfp_chunk* field, size_t fx, size_t ex)
+    void zfp_set_chunk_2d(zfp_chunk* field, size_t fx, size_t fy, size_t ex, size_t ey)
+    void zfp_set_chunk_3d(zfp_chunk* field, size_t fx, size_t fy, size_t fz, size_t ex, size_t ey, size_t ez)
+    void zfp_set_chunk_4d(zfp_chunk* field, size_t fx, size_t fy, size_t fz, size_t fw, size_t ex, size_t ey, size_t ez, size_t ew)
 
 cdef gen_padded_int_list(orig_array, pad=*, length=*)
@@ -5,9 +5,11 @@ import cython
 import ctypes
 import math
 import multiprocess
-from libc.stdlib cimport malloc, free
+from libc.stdlib cimport malloc, calloc, free
+from cython.parallel cimport prange
 from cython cimport view
 from libc.stdint cimport uint8_t
+from libc.stdint cimport uint64_t
 from libc.stdint cimport intptr_t
 from cpython.buffer cimport PyObject_GetBuffer, PyBUF_SIMPLE, Py_buffer
 from cpython.mem cimport PyMem_Free
@@ -146,7 +148,7 @@ cdef class zfp_chunkit:
     def __init__(self, np.ndarray arr, float chunks_per_block, method="BEST_CACHE"):
         self.ndim = arr.ndim
         cdef int ndim = arr.ndim
-        cdef int* nsize_array = <int*>malloc(ndim * sizeof(int))
+        cdef size_t* nsize_array = <size_t*>malloc(ndim * sizeof(size_t))
         self.ns_python = []
         self.n123 = 1
         method_opts = {"BEST_CACHE": 1, "MAKE_EQUAL": 2}
@@ -183,7 +185,7 @@ cdef class zfp_chunkit:
         return self.nchunks
 
     cpdef get_ndim(self):
-        return self.get_ndim()
+        return self.ndim
 
     cpdef get_dtype(self):
         return self.dtype
@@ -191,6 +193,22 @@ cdef class zfp_chunkit:
     cpdef get_shape(self):
         return self.ns_python
 
+    cpdef get_chunk_extents(self):
+        """Return (nchunks, ndim, 2) array holding the first and one past the
+        last index of each chunk along each NumPy axis"""
+        cdef np.ndarray[np.int64_t, ndim=3] extents = np.empty((self.nchunks, self.ndim, 2), dtype=np.int64)
+        cdef zfp_chunk* chunk
+        cdef size_t ichunk
+        cdef int k
+        for ichunk in range(self.nchunks):
+            chunk = self.chunks.chunks[ichunk]
+            first = (chunk.fx, chunk.fy, chunk.fz, chunk.fw)
+            end = (chunk.ex, chunk.ey, chunk.ez, chunk.ew)
+            for k in range(self.ndim):
+                extents[ichunk, k, 0] = first[self.ndim - 1 - k]
+                extents[ichunk, k, 1] = end[self.ndim - 1 - k]
+        return extents
+
 
 
 cdef zfp_field* init_field_raw(object py_raw_array, zfp_chunkit chunks) except NULL:
@@ -278,12 +296,42 @@ cdef class Memory:
 
 
 
-cpdef bytes compress_numpy(
+cdef np.ndarray _output_buffer(object out, size_t maxsize):
+    # uint8 array over the writable buffer out, or a new one when out is None,
+    # with room for the maxsize bytes compression may write
+    cdef np.ndarray buf
+    if out is None:
+        return np.empty(maxsize, dtype=np.uint8)
+    try:
+        buf = np.frombuffer(out, dtype=np.uint8)
+    except (TypeError, ValueError):
+        raise TypeError("out must support the contiguous buffer protocol")
+    if not buf.flags.writeable:
+        raise ValueError("out must be a writable buffer")
+    if <size_t>buf.shape[0] < maxsize:
+        raise ValueError(
+            "out holds {} bytes but compression may require {}".format(
+                buf.shape[0],
+                maxsize
+            )
+        )
+    return buf
+
+cdef object _compressed_view(np.ndarray buf, object out, size_t compressed_size):
+    # memoryview of the compressed bytes; an array allocated for the
+    # worst-case size is shrunk so that the view does not keep it alive
+    if out is None:
+        buf.resize(compressed_size, refcheck=False)
+    return memoryview(buf)[:compressed_size]
+
+cpdef object compress_numpy(
     np.ndarray arr,
     double tolerance = -1,
     double rate = -1,
     int precision = -1,
     write_header=True,
+    out=None,
+    copy=True,
 ):
     # Input validation
     if arr is None:
@@ -305,31 +353,50 @@ cpdef bytes compress_numpy(
     # store the compressed array
     cdef bytes compress_str = None
     cdef size_t maxsize = zfp_stream_maximum_size(stream, field)
+    cdef bitstream* bstream = NULL
+    cdef np.ndarray buf
+    cdef size_t compressed_size = 0
     try:
-        with Memory(maxsize) as data:
-            bstream = stream_open(data, maxsize)
-            zfp_stream_set_bit_stream(stream, bstream)
-            zfp_stream_rewind(stream)
-            # write the full header so we can reconstruct the numpy array on
-            # decompression
-            if write_header and zfp_write_header(stream, field, HEADER_FULL) == 0:
-                raise RuntimeError("Failed to write header to stream")
-            with nogil:
-                compressed_size = zfp_compress(stream, field)
-                
-            if compressed_size == 0:
-                raise RuntimeError("Failed to write to stream")
-            # copy the compressed data into a perfectly sized bytes object
-            compress_str = (<char *>data)[:compressed_size]
+        if out is None and copy:
+            with Memory(maxsize) as data:
+                bstream = stream_open(data, maxsize)
+                zfp_stream_set_bit_stream(stream, bstream)
+                zfp_stream_rewind(stream)
+                # write the full header so we can reconstruct the numpy array on
+                # decompression
+                if write_header and zfp_write_header(stream, field, HEADER_FULL) == 0:
+                    raise RuntimeError("Failed to write header to stream")
+                with nogil:
+                    compressed_size = zfp_compress(stream, field)
+
+                if compressed_size == 0:
+                    raise RuntimeError("Failed to write to stream")
+                # copy the compressed data into a perfectly sized bytes object
+                compress_str = (<char *>data)[:compressed_size]
+            return compress_str
+
+        # compress in place into out or an array that outlives this call
+        buf = _output_buffer(out, maxsize)
+        bstream = stream_open(<void *>buf.data, maxsize)
+        zfp_stream_set_bit_stream(stream, bstream)
+        zfp_stream_rewind(stream)
+        if write_header and zfp_write_header(stream, field, HEADER_FULL) == 0:
+            raise RuntimeError("Failed to write header to stream")
+        with nogil:
+            compressed_size = zfp_compress(stream, field)
+        if compressed_size == 0:
+            raise RuntimeError("Failed to write to stream")
     finally:
         zfp_field_free(field)
         zfp_stream_close(stream)
-        stream_close(bstream)
-
-    return compress_str
-cpdef bytes compress_numpy_portion(object py_raw_array, zfp_chunkit chunkit, int ichunk,
-                                   double tolerance = -1, double rate = -1, 
-                                   int precision = -1, write_header=True):
+        if bstream:
+            stream_close(bstream)
+
+    return _compressed_view(buf, out, compressed_size)
+cpdef object compress_numpy_portion(object py_raw_array, zfp_chunkit chunkit, size_t ichunk,
+                                    double tolerance = -1, double rate = -1, 
+                                    int precision = -1, write_header=True,
+                                    out=None, copy=True):
     
     # Input validation
     if py_raw_array is None:
@@ -350,30 +417,250 @@ cpdef bytes compress_numpy_portion(object py_raw_array, zfp_chunkit chunkit, int
     # store the compressed array
     cdef bytes compress_str = None
     cdef size_t maxsize = zfp_stream_maximum_size_chunk(stream, field, chunkit.chunks.chunks[ichunk])
+    cdef bitstream* bstream = NULL
+    cdef np.ndarray buf
+    cdef size_t compressed_size = 0
     try:
-        with Memory(maxsize) as data:
-
-            bstream = stream_open(data, maxsize)
-            zfp_stream_set_bit_stream(stream, bstream)
-            zfp_stream_rewind(stream)
-
-            # write the full header so we can reconstruct the numpy array on
-            # decompression
-            if write_header and zfp_write_header(stream, field, HEADER_FULL) == 0:
-                raise RuntimeError("Failed to write header to stream")
-            with nogil:
-                compressed_size = zfp_compress_chunk(stream, chunkit.chunks.chunks[ichunk], field)
-            if compressed_size == 0:
-                raise RuntimeError("Failed to write to stream")
-            # copy the compressed data into a perfectly sized bytes object
-            compress_str = (<char *>data)[:compressed_size]
+        if out is None and copy:
+            with Memory(maxsize) as data:
+
+                bstream = stream_open(data, maxsize)
+                zfp_stream_set_bit_stream(stream, bstream)
+                zfp_stream_rewind(stream)
+
+                # write the full header so we can reconstruct the numpy array on
+                # decompression
+                if write_header and zfp_write_header(stream, field, HEADER_FULL) == 0:
+                    raise RuntimeError("Failed to write header to stream")
+                with nogil:
+                    compressed_size = zfp_compress_chunk(stream, chunkit.chunks.chunks[ichunk], field)
+                if compressed_size == 0:
+                    raise RuntimeError("Failed to write to stream")
+                # copy the compressed data into a perfectly sized bytes object
+                compress_str = (<char *>data)[:compressed_size]
+            return compress_str
+
+        # compress in place into out or an array that outlives this call
+        buf = _output_buffer(out, maxsize)
+        bstream = stream_open(<void *>buf.data, maxsize)
+        zfp_stream_set_bit_stream(stream, bstream)
+        zfp_stream_rewind(stream)
+        if write_header and zfp_write_header(stream, field, HEADER_FULL) == 0:
+            raise RuntimeError("Failed to write header to stream")
+        with nogil:
+            compressed_size = zfp_compress_chunk(stream, chunkit.chunks.chunks[ichunk], field)
+        if compressed_size == 0:
+            raise RuntimeError("Failed to write to stream")
 
+    finally:
+        zfp_field_free(field)
+        zfp_stream_close(stream)
+        if bstream:
+            stream_close(bstream)
+
+    return _compressed_view(buf, out, compressed_size)
+
+cpdef tuple compress_numpy_chunks(object py_raw_array, zfp_chunkit chunkit, int nthreads = -1,
+                                  double tolerance = -1, double rate = -1,
+                                  int precision = -1, out=None):
+    """Compress all chunks of chunkit in parallel without holding the GIL.
+
+    Returns a (data, offsets) pair: a uint8 array holding a full zfp header
+    followed by the chunks, and the byte offset of each chunk in data, with
+    offsets[nchunks] the total size.  When given, out is the writable
+    buffer to compress into and data is a view of it.
+    """
+    # Input validation
+    if py_raw_array is None:
+        raise TypeError("Input array cannot be None")
+    num_params_set = sum([1 for x in [tolerance, rate, precision] if x >= 0])
+    if num_params_set > 1:
+        raise ValueError("Only one of tolerance, rate, or precision can be set")
+    if nthreads <= 0:
+        nthreads = multiprocess.cpu_count()
+
+    # Setup zfp structs to begin compression
+    cdef zfp_field* field = init_field_raw(py_raw_array, chunkit)
+    cdef zfp_stream* stream = zfp_stream_open(NULL)
+    cdef bitstream* bstream = NULL
+    cdef zfp_type ztype = zfp_type_none
+    cdef int ndim = len(chunkit.ns_python)
+    _set_compression_mode(stream, ztype, ndim, tolerance, rate, precision)
+
+    # every chunk is first compressed into its own worst-case slot
+    cdef size_t maxsize = (ZFP_HEADER_MAX_BITS + 63) // 64 * 8
+    cdef size_t ichunk
+    for ichunk in range(chunkit.nchunks):
+        maxsize += zfp_stream_maximum_size_chunk(stream, field, chunkit.chunks.chunks[ichunk])
+
+    cdef np.ndarray[np.uint8_t, ndim=1] data = _output_buffer(out, maxsize)
+    cdef np.ndarray[np.uint64_t, ndim=1] offsets = np.empty(chunkit.nchunks + 1, dtype=np.uint64)
+    cdef size_t compressed_size = 0
+    try:
+        bstream = stream_open(<void *>data.data, maxsize)
+        zfp_stream_set_bit_stream(stream, bstream)
+        zfp_stream_rewind(stream)
+        # write the full header so the mode is known on decompression
+        if zfp_write_header(stream, field, HEADER_FULL) == 0:
+            raise RuntimeError("Failed to write header to stream")
+        with nogil:
+            compressed_size = zfp_blocks_compress_internal(stream, field, nthreads, chunkit.blocks)
+        if compressed_size == 0:
+            raise RuntimeError("Failed to write to stream")
+        for ichunk in range(chunkit.nchunks + 1):
+            offsets[ichunk] = chunkit.blocks.begs[ichunk] // 8
+    finally:
+        zfp_field_free(field)
+        zfp_stream_close(stream)
+        if bstream:
+            stream_close(bstream)
+
+    return data[:compressed_size], offsets
+
+cpdef decompress_numpy_chunks(const uint8_t[::1] compressed_data, offsets,
+                              object py_raw_array, zfp_chunkit chunkit,
+                              int nthreads = -1):
+    """Decompress all chunks written by compress_numpy_chunks into
+    py_raw_array in parallel without holding the GIL."""
+    if compressed_data is None:
+        raise TypeError("compressed_data cannot be None")
+    if len(offsets) != chunkit.nchunks + 1:
+        raise ValueError("Expected {} chunk offsets but got {}".format(
+            chunkit.nchunks + 1, len(offsets)))
+    if offsets[chunkit.nchunks] > len(compressed_data):
+        raise ValueError("Chunk offsets extend past compressed_data")
+    if nthreads <= 0:
+        nthreads = multiprocess.cpu_count()
+
+    cdef size_t ichunk
+    for ichunk in range(chunkit.nchunks + 1):
+        chunkit.blocks.begs[ichunk] = 8 * <size_t>offsets[ichunk]
+
+    cdef zfp_field* field = init_field_raw(py_raw_array, chunkit)
+    cdef const void* comp_data_pointer = <const void *>&compressed_data[0]
+    cdef bitstream* bstream = stream_open(
+        <void *>comp_data_pointer,
+        len(compressed_data)
+    )
+    cdef zfp_stream* stream = zfp_stream_open(bstream)
+    cdef size_t ret = 0
+
+    try:
+        if zfp_read_header(stream, field, HEADER_FULL) == 0:
+            raise ValueError("Failed to read required zfp header")
+        with nogil:
+            ret = zfp_blocks_decompress(stream, field, nthreads, chunkit.blocks)
+        if ret == 0:
+            raise RuntimeError("error during zfp decompression")
     finally:
         zfp_field_free(field)
         zfp_stream_close(stream)
         stream_close(bstream)
 
-    return compress_str
+cpdef decompress_numpy_chunk_list(const uint8_t[::1] compressed_data, offsets,
+                                  zfp_chunkit chunkit, ichunks, outs,
+                                  int nthreads = -1):
+    """Decompress chunks ichunks of data written by compress_numpy_chunks,
+    each into the C-contiguous array in outs shaped like the chunk, in
+    parallel without holding the GIL."""
+    if compressed_data is None:
+        raise TypeError("compressed_data cannot be None")
+    if len(ichunks) != len(outs):
+        raise ValueError("Expected one output array per chunk")
+    if len(offsets) != chunkit.nchunks + 1:
+        raise ValueError("Expected {} chunk offsets but got {}".format(
+            chunkit.nchunks + 1, len(offsets)))
+    if nthreads <= 0:
+        nthreads = multiprocess.cpu_count()
+
+    cdef Py_ssize_t n = len(ichunks)
+    cdef Py_ssize_t k
+    cdef uint8_t* base = <uint8_t *>&compressed_data[0]
+    cdef size_t size = len(compressed_data)
+    cdef zfp_field* field = zfp_field_alloc()
+    cdef bitstream* bstream = stream_open(<void *>base, size)
+    cdef zfp_stream* stream = zfp_stream_open(bstream)
+    cdef zfp_field** fields = <zfp_field**>calloc(n + 1, sizeof(zfp_field*))
+    cdef bitstream** bstreams = <bitstream**>calloc(n + 1, sizeof(bitstream*))
+    cdef zfp_stream** streams = <zfp_stream**>calloc(n + 1, sizeof(zfp_stream*))
+    cdef size_t* ret = <size_t*>calloc(n + 1, sizeof(size_t))
+    cdef uint64_t mode
+    cdef zfp_type ztype
+    cdef zfp_chunk* chunk
+    cdef size_t ichunk, first, last
+    cdef void* pointer
+
+    try:
+        if not fields or not bstreams or not streams or not ret:
+            raise MemoryError()
+        # every chunk is decoded with the parameters in the leading header
+        if zfp_read_header(stream, field, HEADER_FULL) == 0:
+            raise ValueError("Failed to read required zfp header")
+        mode = zfp_stream_mode(stream)
+        ztype = field[0]._type
+        dtype = ztype_to_dtype(ztype)
+
+        for k in range(n):
+            ichunk = ichunks[k]
+            if ichunk >= chunkit.nchunks:
+                raise IndexError("Chunk {} out of range".format(ichunk))
+            first = offsets[ichunk]
+            last = offsets[ichunk + 1]
+            if first > last or last > size:
+                raise ValueError("Chunk offsets extend past compressed_data")
+
+            # a chunk starts on a block boundary, so it decodes like a
+            # stand-alone field of its own extent
+            chunk = chunkit.chunks.chunks[ichunk]
+            nx = chunk.ex - chunk.fx
+            ny = chunk.ey - chunk.fy
+            nz = chunk.ez - chunk.fz
+            nw = chunk.ew - chunk.fw
+            shape = (nw, nz, ny, nx)[4 - chunkit.ndim:]
+            out = outs[k]
+            if not isinstance(out, np.ndarray):
+                raise TypeError("outs must hold NumPy arrays")
+            if out.dtype != dtype or tuple(out.shape) != shape:
+                raise ValueError(
+                    "Out ndarray has dtype {} and shape {} but chunk {} has "
+                    "dtype {} and shape {}".format(
+                        out.dtype, out.shape, ichunk, np.dtype(dtype), shape))
+            if not out.flags.c_contiguous or not out.flags.writeable:
+                raise ValueError("Out ndarray must be writable and C-contiguous")
+
+            pointer = <void *>(<np.ndarray>out).data
+            if chunkit.ndim == 1:
+                fields[k] = zfp_field_1d(pointer, ztype, nx)
+            elif chunkit.ndim == 2:
+                fields[k] = zfp_field_2d(pointer, ztype, nx, ny)
+            elif chunkit.ndim == 3:
+                fields[k] = zfp_field_3d(pointer, ztype, nx, ny, nz)
+            else:
+                fields[k] = zfp_field_4d(pointer, ztype, nx, ny, nz, nw)
+            bstreams[k] = stream_open(<void *>(base + first), last - first)
+            streams[k] = zfp_stream_open(bstreams[k])
+            zfp_stream_set_mode(streams[k], mode)
+
+        for k in prange(n, nogil=True, num_threads=nthreads, schedule='dynamic'):
+            ret[k] = zfp_decompress(streams[k], fields[k])
+        for k in range(n):
+            if ret[k] == 0:
+                raise RuntimeError("error during zfp decompression")
+    finally:
+        for k in range(n):
+            if fields and fields[k]:
+                zfp_field_free(fields[k])
+            if streams and streams[k]:
+                zfp_stream_close(streams[k])
+            if bstreams and bstreams[k]:
+                stream_close(bstreams[k])
+        free(fields)
+        free(bstreams)
+        free(streams)
+        free(ret)
+        zfp_field_free(field)
+        zfp_stream_close(stream)
+        stream_close(bstream)
 
 cdef view.array _decompress_with_view(
     zfp_field* field,
@@ -447,6 +734,59 @@ cdef _validate_4d_list(in_list, list_name):
             "User-provided {} is not an iterable"
         )
 
+cdef np.ndarray _output_array(out, dtype, shape):
+    # NumPy array over out that decompression of an array of the given dtype
+    # and (C-ordered) shape may write into
+    cdef np.ndarray output
+    if isinstance(out, np.ndarray):
+        output = out
+
+        # check that numpy and user-provided types match
+        if out.dtype != dtype:
+            raise ValueError(
+                "Out ndarray has dtype {} but decompression is using "
+                "{}. Use out=ndarray.data to avoid this check.".format(
+                    out.dtype,
+                    dtype
+                )
+            )
+
+        # check that numpy and user-provided shape match
+        numpy_shape = out.shape
+        user_shape = [x for x in shape if x > 0]
+        if not all(
+                [x == y for x, y in
+                 zip_longest(numpy_shape, user_shape)
+                ]
+        ):
+            raise ValueError(
+                "Out ndarray has shape {} but decompression is using "
+                "{}.  Use out=ndarray.data to avoid this check.".format(
+                    numpy_shape,
+                    user_shape
+                )
+            )
+        # zfp writes a dense C-ordered array
+        if not out.flags.c_contiguous or not out.flags.writeable:
+            raise ValueError("Out ndarray must be writable and C-contiguous")
+    else:
+        # np.frombuffer would silently give a read-only array
+        if memoryview(out).readonly:
+            raise ValueError("Out buffer must be writable")
+        output = np.frombuffer(out, dtype=dtype)
+        output = output.reshape(shape)
+    return output
+
+cdef _check_not_in_place(const uint8_t[::1] compressed_data, np.ndarray output):
+    # compressed_data is a fresh memoryview, so compare the bytes it spans
+    # with those of output rather than the Python objects
+    cdef intptr_t cbeg = <intptr_t>&compressed_data[0]
+    cdef intptr_t cend = cbeg + compressed_data.shape[0]
+    cdef intptr_t obeg = <intptr_t>output.data
+    cdef intptr_t oend = obeg + output.nbytes
+    if cbeg < oend and obeg < cend:
+        raise ValueError("Cannot decompress in-place")
+
 cpdef np.ndarray _decompress(
     const uint8_t[::1] compressed_data,
     zfp_type ztype,
@@ -458,8 +798,6 @@ cpdef np.ndarray _decompress(
 ):
     if compressed_data is None:
         raise TypeError("compressed_data cannot be None")
-    if compressed_data is out:
-        raise ValueError("Cannot decompress in-place")
     _validate_4d_list(shape, "shape")
 
     cdef const void* comp_data_pointer = <const void*>&compressed_data[0]
@@ -488,39 +826,8 @@ cpdef np.ndarray _decompress(
         if out is None:
             output = np.asarray(_decompress_with_view(field, stream))
         else:
-            dtype = ztype_to_dtype(ztype)
-            if isinstance(out, np.ndarray):
-                output = out
-
-                # check that numpy and user-provided types match
-                if out.dtype != dtype:
-                    raise ValueError(
-                        "Out ndarray has dtype {} but decompression is using "
-                        "{}. Use out=ndarray.data to avoid this check.".format(
-                            out.dtype,
-                            dtype
-                        )
-                    )
-
-                # check that numpy and user-provided shape match
-                numpy_shape = out.shape
-                user_shape = [x for x in shape if x > 0]
-                if not all(
-                        [x == y for x, y in
-                         zip_longest(numpy_shape, user_shape)
-                        ]
-                ):
-                    raise ValueError(
-                        "Out ndarray has shape {} but decompression is using "
-                        "{}.  Use out=ndarray.data to avoid this check.".format(
-                            numpy_shape,
-                            user_shape
-                        )
-                    )
-            else:
-                output = np.frombuffer(out, dtype=dtype)
-                output = output.reshape(shape)
-
+            output = _output_array(out, ztype_to_dtype(ztype), shape)
+            _check_not_in_place(compressed_data, output)
             _decompress_with_user_array(field, stream, <void *>output.data)
 
     finally:
@@ -532,6 +839,7 @@ cpdef np.ndarray _decompress(
 
 cpdef np.ndarray decompress_numpy(
     const uint8_t[::1] compressed_data,
+    out=None,
 ):
     if compressed_data is None:
         raise TypeError("compressed_data cannot be None")
@@ -548,7 +856,14 @@ cpdef np.ndarray decompress_numpy(
     try:
         if zfp_read_header(stream, field, HEADER_FULL) == 0:
             raise ValueError("Failed to read required zfp header")
-        output = np.asarray(_decompress_with_view(field, stream))
+        if out is None:
+            output = np.asarray(_decompress_with_view(field, stream))
+        else:
+            shape = (field[0].nw, field[0].nz, field[0].ny, field[0].nx)
+            shape = tuple([x for x in shape if x > 0])
+            output = _output_array(out, ztype_to_dtype(field[0]._type), shape)
+            _check_not_in_place(compressed_data, output)
+            _decompress_with_user_array(field, stream, <void *>output.data)
     finally:
         zfp_field_free(field)
         zfp_stream_close(stream)
@@ -560,7 +875,7 @@ cpdef np.ndarray decompress_numpy_portion(
     const uint8_t[::1] compressed_data,
        object py_raw_array,
         zfp_chunkit chunkit,
-        int ichunk
+        size_t ichunk
 ):
 
 
@@ -19,8 +19,13 @@ static size_t
 chunk_count_omp(const zfp_stream* stream, size_t blocks, uint threads)
 {
   size_t chunk_size = (size_t)zfp_stream_omp_chunk_size(stream);
+  size_t index_size = zfp_stream_omp_index_size(stream);
+  size_t chunks;
+  /* an offset table, when given, dictates the number of chunks */
+  if (index_size)
+    return index_size - 1;
   /* if no chunk size is specified, assign one chunk per thread */
-  size_t chunks = chunk_size ? (blocks + chunk_size - 1) / chunk_size : threads;
+  chunks = chunk_size ? (blocks + chunk_size - 1) / chunk_size : threads;
   /* each chunk must contain at least one block */
   chunks = MIN(chunks, blocks);
   /* OpenMP 2.0 loop counters must be ints */
@@ -1,4 +1,13 @@
-#ifdef _OPENMP
+#if defined(_OPENMP) || defined(ZFP_WITH_THREADS)
+
+/* table of chunk bit offsets of the current execution policy (NULL if not set) */
+static uint64*
+chunk_index_par(const zfp_stream* stream)
+{
+  if (zfp_stream_execution(stream) == zfp_exec_threads)
+    return zfp_stream_threads_index(stream);
+  return zfp_stream_omp_index(stream);
+}
 
 /* block index at which chunk begins */
 static size_t
@@ -17,8 +26,6 @@ compress_init_par(zfp_stream* stream, const zfp_field* field, size_t chunks, siz
   size_t size;
   size_t chunk;
 
-
-
   /* determine maximum size buffer needed per thread */
   zfp_field f = *field;
   switch (zfp_field_dimensionality(field)) {
@@ -81,12 +88,17 @@ compress_finish_par(zfp_stream* stream, bitstream** src, size_t chunks)
 {
   bitstream* dst = zfp_stream_bit_stream(stream);
   zfp_bool copy = (stream_data(dst) != stream_data(*src));
-  bitstream_offset offset = stream_wtell(dst);
+  bitstream_offset base = stream_wtell(dst);
+  bitstream_offset offset = base;
+  uint64* index = chunk_index_par(stream);
   size_t chunk;
 
   /* flush each stream and concatenate if necessary */
   for (chunk = 0; chunk < chunks; chunk++) {
     bitstream_size bits = stream_wtell(src[chunk]);
+    /* record chunk offset relative to start of compressed data */
+    if (index)
+      index[chunk] = offset - base;
     offset += bits;
     stream_flush(src[chunk]);
     /* concatenate streams if they are not already contiguous */
@@ -101,6 +113,69 @@ compress_finish_par(zfp_stream* stream, bitstream** src, size_t chunks)
   free(src);
   if (!copy)
     stream_wseek(dst, offset);
+  if (index)
+    index[chunks] = offset - base;
+}
+
+/* bit offset of chunk relative to start of compressed data */
+static bitstream_offset
+chunk_bit_offset(const zfp_stream* stream, size_t blocks, size_t chunks, size_t chunk)
+{
+  const uint64* index = chunk_index_par(stream);
+  /* use offset table when available; otherwise each block has maxbits bits */
+  if (index)
+    return index[chunk];
+  return (bitstream_offset)chunk_offset(blocks, chunks, chunk) * stream->maxbits;
+}
+
+/* initialize per-thread bit streams for parallel decompression */
+static bitstream**
+decompress_init_par(zfp_stream* stream, size_t chunks, size_t blocks)
+{
+  bitstream* src = zfp_stream_bit_stream(stream);
+  bitstream_offset base = stream_rtell(src);
+  bitstream** bs;
+  size_t chunk;
+
+  /* chunk offsets are unknown in variable-rate mode without an index */
+  if (!chunk_index_par(stream) && stream->minbits != stream->maxbits)
+    return NULL;
+
+  /* position one bit stream at the beginning of each chunk */
+  bs = (bitstream**)malloc(chunks * sizeof(bitstream*));
+  if (!bs)
+    return NULL;
+  for (chunk = 0; chunk < chunks; chunk++) {
+    bs[chunk] = stream_open(stream_data(src), stream_capacity(src));
+    if (!bs[chunk])
+      break;
+    stream_rseek(bs[chunk], base + chunk_bit_offset(stream, blocks, chunks, chunk));
+  }
+
+  /* handle memory allocation failure */
+  if (chunk < chunks) {
+    while (chunk--)
+      stream_close(bs[chunk]);
+    free(bs);
+    bs = NULL;
+  }
+
+  return bs;
+}
+
+/* position bit stream at end of last chunk and free per-thread streams */
+static void
+decompress_finish_par(zfp_stream* stream, bitstream** src, size_t chunks, size_t blocks)
+{
+  bitstream* dst = zfp_stream_bit_stream(stream);
+  bitstream_offset offset = stream_rtell(dst) + chunk_bit_offset(stream, blocks, chunks, chunks);
+  size_t chunk;
+
+  for (chunk = 0; chunk < chunks; chunk++)
+    stream_close(src[chunk]);
+  free(src);
+
+  stream_rseek(dst, offset);
 }
 
 #endif
@@ -0,0 +1,266 @@
+#ifdef ZFP_WITH_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#include "zfp.h"
+
+/* work item handed to a pool thread */
+typedef void (*thread_task)(void* context, size_t item);
+
+/* background task queued for the next idle pool thread */
+typedef struct thread_post {
+  thread_task task;         /* called with item zero */
+  void* context;            /* passed through to task */
+  struct thread_post* next; /* next queued task */
+} thread_post;
+
+/* persistent pool of worker threads sharing one queue of items */
+typedef struct {
+  pthread_mutex_t mutex; /* guards all members below */
+  pthread_cond_t work;   /* signals workers that a job was posted */
+  pthread_cond_t done;   /* signals the caller that workers left the job */
+  pthread_mutex_t owner; /* held by the caller whose job is running */
+  uint workers;          /* number of worker threads */
+  thread_task task;      /* task of current job */
+  void* context;         /* context of current job */
+  size_t items;          /* number of items in current job */
+  size_t next;           /* next item to hand out */
+  uint limit;            /* number of workers wanted for current job */
+  uint active;           /* number of workers on current job */
+  size_t job;            /* sequence number of current job */
+  thread_post* head;     /* first queued background task */
+  thread_post* tail;     /* last queued background task */
+  zfp_bool spare;        /* true if a worker was started for tasks only */
+} thread_pool;
+
+static thread_pool pool = {
+  PTHREAD_MUTEX_INITIALIZER,
+  PTHREAD_COND_INITIALIZER,
+  PTHREAD_COND_INITIALIZER,
+  PTHREAD_MUTEX_INITIALIZER,
+  0, NULL, NULL, 0, 0, 0, 0, 0, NULL, NULL, zfp_false
+};
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+
+/* run items of the current job until the queue is empty; mutex is held */
+static void
+thread_pool_drain(void)
+{
+  while (pool.next < pool.items) {
+    size_t item = pool.next++;
+    thread_task task = pool.task;
+    void* context = pool.context;
+    pthread_mutex_unlock(&pool.mutex);
+    task(context, item);
+    pthread_mutex_lock(&pool.mutex);
+  }
+}
+
+/* worker thread: run queued tasks and join each posted job while it wants more workers */
+static void*
+thread_pool_worker(void* arg)
+{
+  size_t job = 0;
+  (void)arg;
+  pthread_mutex_lock(&pool.mutex);
+  for (;;) {
+    while (pool.job == job && !pool.head)
+      pthread_cond_wait(&pool.work, &pool.mutex);
+    if (pool.head) {
+      thread_post* post = pool.head;
+      pool.head = post->next;
+      if (!pool.head)
+        pool.tail = NULL;
+      pthread_mutex_unlock(&pool.mutex);
+      post->task(post->context, 0);
+      pthread_mutex_lock(&pool.mutex);
+      continue;
+    }
+    job = pool.job;
+    if (pool.active < pool.limit) {
+      pool.active++;
+      thread_pool_drain();
+      if (!--pool.active)
+        pthread_cond_signal(&pool.done);
+    }
+  }
+  return NULL;
+}
+
+/* start one worker per online processor beyond the calling thread */
+static void
+thread_pool_start(void)
+{
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint count = cpus > 1 ? (uint)(cpus - 1) : 0;
+  pthread_attr_t attr;
+  uint i;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  for (i = 0; i < count; i++) {
+    pthread_t thread;
+    if (pthread_create(&thread, &attr, thread_pool_worker, NULL))
+      break;
+  }
+  pthread_attr_destroy(&attr);
+  pool.workers = i;
+}
+
+/*
+** Run task on items 0, ..., items - 1 using the calling thread and up to
+** threads - 1 pool workers.  Jobs do not nest or overlap: a call made while
+** another job is running executes its items on the calling thread alone.
+*/
+static void
+thread_pool_run(uint threads, size_t items, thread_task task, void* context)
+{
+  size_t item;
+  pthread_once(&pool_once, thread_pool_start);
+  if (threads > 1 && items > 1 && pool.workers && !pthread_mutex_trylock(&pool.owner)) {
+    pthread_mutex_lock(&pool.mutex);
+    pool.task = task;
+    pool.context = context;
+    pool.items = items;
+    pool.next = 0;
+    pool.limit = MIN(threads - 1, pool.workers);
+    pool.job++;
+    pthread_cond_broadcast(&pool.work);
+    thread_pool_drain();
+    /* stop latecomers from joining, then wait for workers still busy */
+    pool.limit = 0;
+    while (pool.active)
+      pthread_cond_wait(&pool.done, &pool.mutex);
+    pthread_mutex_unlock(&pool.mutex);
+    pthread_mutex_unlock(&pool.owner);
+    return;
+  }
+  for (item = 0; item < items; item++)
+    task(context, item);
+}
+
+/*
+** Queue post to run on the next idle pool worker and return right away.
+** On a single processor, a spare worker that joins no jobs is started for
+** queued tasks.  Return false if no worker can be started, in which case
+** nothing is queued.  The caller owns post until its task has begun.
+*/
+static zfp_bool
+thread_pool_post(thread_post* post)
+{
+  pthread_once(&pool_once, thread_pool_start);
+  post->next = NULL;
+  pthread_mutex_lock(&pool.mutex);
+  if (!pool.workers && !pool.spare) {
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pool.spare = !pthread_create(&thread, &attr, thread_pool_worker, NULL);
+    pthread_attr_destroy(&attr);
+    if (!pool.spare) {
+      pthread_mutex_unlock(&pool.mutex);
+      return zfp_false;
+    }
+  }
+  if (pool.tail)
+    pool.tail->next = post;
+  else
+    pool.head = post;
+  pool.tail = post;
+  pthread_cond_signal(&pool.work);
+  pthread_mutex_unlock(&pool.mutex);
+  return zfp_true;
+}
+
+/* number of threads to use */
+static uint
+thread_count_threads(const zfp_stream* stream)
+{
+  uint count = zfp_stream_threads(stream);
+  /* if no thread count is specified, use the whole pool */
+  if (!count) {
+    pthread_once(&pool_once, thread_pool_start);
+    count = pool.workers + 1;
+  }
+  return count;
+}
+
+/* number of chunks to partition array into */
+static size_t
+chunk_count_threads(const zfp_stream* stream, size_t blocks, uint threads)
+{
+  size_t index_size = zfp_stream_threads_index_size(stream);
+  /* an offset table, when given, dictates the number of chunks */
+  if (index_size)
+    return index_size - 1;
+  /* queue a few chunks per thread so that early finishers take more */
+  return MIN(4 * (size_t)threads, blocks);
+}
+
+/* number of blocks in field */
+static size_t
+field_blocks(const zfp_field* field)
+{
+  size_t bx = (field->nx + 3) / 4;
+  size_t by = field->ny ? (field->ny + 3) / 4 : 1;
+  size_t bz = field->nz ? (field->nz + 3) / 4 : 1;
+  size_t bw = field->nw ? (field->nw + 3) / 4 : 1;
+  return bx * by * bz * bw;
+}
+
+/* chunks of blocks (de)compressed by pool threads */
+typedef struct {
+  const zfp_stream* stream; /* compression parameters */
+  const zfp_field* field;   /* field being (de)compressed */
+  bitstream** bs;           /* bit stream of each chunk */
+  size_t blocks;            /* number of blocks in field */
+  size_t chunks;            /* number of chunks */
+} thread_job;
+
+/* compress field one chunk of blocks per task */
+static void
+compress_threads(zfp_stream* stream, const zfp_field* field, thread_task task)
+{
+  uint threads = thread_count_threads(stream);
+  size_t blocks = field_blocks(field);
+  size_t chunks = chunk_count_threads(stream, blocks, threads);
+  thread_job job;
+
+  /* allocate per-chunk streams */
+  job.bs = compress_init_par(stream, field, chunks, blocks);
+  if (!job.bs)
+    return;
+  job.stream = stream;
+  job.field = field;
+  job.blocks = blocks;
+  job.chunks = chunks;
+
+  /* compress chunks in parallel and concatenate their streams */
+  thread_pool_run(threads, chunks, task, &job);
+  compress_finish_par(stream, job.bs, chunks);
+}
+
+/* decompress field one chunk of blocks per task (false if chunks cannot be located) */
+static zfp_bool
+decompress_threads(zfp_stream* stream, zfp_field* field, thread_task task)
+{
+  uint threads = thread_count_threads(stream);
+  size_t blocks = field_blocks(field);
+  size_t chunks = chunk_count_threads(stream, blocks, threads);
+  thread_job job;
+
+  /* set up per-chunk streams */
+  job.bs = decompress_init_par(stream, chunks, blocks);
+  if (!job.bs)
+    return zfp_false;
+  job.stream = stream;
+  job.field = field;
+  job.blocks = blocks;
+  job.chunks = chunks;
+
+  /* decompress chunks in parallel and advance past the last one */
+  thread_pool_run(threads, chunks, task, &job);
+  decompress_finish_par(stream, job.bs, chunks, blocks);
+  return zfp_true;
+}
+
+#endif
@@ -1,4 +1,5 @@
 #define PERM _t1(perm, DIMS)           /* coefficient order */
 #define BLOCK_SIZE (1 << (2 * DIMS))   /* values per block */
+#define BATCH_SIZE ZFP_BATCH_SIZE      /* blocks per batch */
 #define EBIAS ((1 << (EBITS - 1)) - 1) /* exponent bias */
 #define REVERSIBLE(zfp) ((zfp)->minexp < ZFP_MIN_EXP) /* reversible mode? */
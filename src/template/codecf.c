@@ -1,5 +1,5 @@
 #include <limits.h>
-#include <math.h>
+#include <string.h>
 
 /* maximum number of bit planes to encode */
 static uint
@@ -12,11 +12,30 @@ precision(int maxexp, uint maxprec, int minexp, int dims)
 #endif
 }
 
-/* map integer x relative to exponent e to floating-point number */
+/* return 2^e for normal exponent 1 - EBIAS <= e <= EBIAS */
 static Scalar
-_t1(dequantize, Scalar)(Int x, int e)
+_t1(pow2, Scalar)(int e)
 {
-  return LDEXP((Scalar)x, e - ((int)(CHAR_BIT * sizeof(Scalar)) - 2));
+  /* assemble IEEE representation with zero sign and mantissa */
+  UInt u = (UInt)(e + EBIAS) << (CHAR_BIT * sizeof(Scalar) - 1 - EBITS);
+  Scalar x;
+  memcpy(&x, &u, sizeof(x));
+  return x;
+}
+
+/* return 2^e for 2 - 2 EBIAS <= e <= 2 EBIAS, rounded like ldexp(1, e) */
+static Scalar
+_t1(scale, Scalar)(int e)
+{
+  /* both factors are normal; their product is rounded only once */
+  return _t1(pow2, Scalar)(e / 2) * _t1(pow2, Scalar)(e - e / 2);
+}
+
+/* map integer 1 relative to exponent e to floating-point number */
+static Scalar
+_t1(dequantize, Scalar)(int e)
+{
+  return _t1(scale, Scalar)(e - ((int)(CHAR_BIT * sizeof(Scalar)) - 2));
 }
 
 /* inverse block-floating-point transform from signed integers */
@@ -24,7 +43,7 @@ static void
 _t1(inv_cast, Scalar)(const Int* iblock, Scalar* fblock, uint n, int emax)
 {
   /* compute power-of-two scale factor s */
-  Scalar s = _t1(dequantize, Scalar)(1, emax);
+  Scalar s = _t1(dequantize, Scalar)(emax);
   /* compute p-bit float x = s*y where |y| <= 2^(p-2) - 1 */
   do
     *fblock++ = (Scalar)(s * *iblock++);
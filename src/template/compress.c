@@ -2,14 +2,22 @@
 static void
 _t2(compress, Scalar, 1)(zfp_stream* stream, const zfp_chunk *chunk, const zfp_field* field)
 {
-  const Scalar* data = (const Scalar*)field->data;
-  size_t nx = field->nx;
-  size_t mx = nx & ~3u;
+  const Scalar* data = (const Scalar*)field->data + chunk->fx;
+  size_t nx = chunk->ex;
+  size_t mx = chunk->fx + ((nx - chunk->fx) & ~(size_t)3);
   size_t x;
-
-  /* compress array one block of 4 values at a time */
-  for (x = 0; x < mx; x += 4, data += 4)
-    _t2(zfp_encode_block, Scalar, 1)(stream, data);
+  const Scalar* batch[ZFP_BATCH_SIZE];
+  size_t n = 0;
+
+  /* compress chunk in batches of blocks of 4 values */
+  for (x = chunk->fx; x < mx; x += 4, data += 4) {
+    batch[n++] = data;
+    if (n == ZFP_BATCH_SIZE) {
+      _t2(zfp_encode_blocks_strided, Scalar, 1)(stream, batch, n, 1);
+      n = 0;
+    }
+  }
+  _t2(zfp_encode_blocks_strided, Scalar, 1)(stream, batch, n, 1);
   if (x < nx)
     _t2(zfp_encode_partial_block_strided, Scalar, 1)(stream, data, nx - x, 1);
 }
@@ -24,15 +32,29 @@ _t2(compress_strided, Scalar, 1)(zfp_stream* stream, const zfp_chunk *chunk, con
   size_t fx = chunk->fx;
   ptrdiff_t sx = field->sx ? field->sx : 1;
   size_t x;
+  const Scalar* batch[ZFP_BATCH_SIZE];
+  size_t n = 0;
 
-  /* compress array one block of 4 values at a time */
+  /* compress array in batches of blocks of 4 values */
   for (x = fx; x < ex; x += 4) {
     const Scalar* p = data + sx * (ptrdiff_t)x;
-    if (nx - x < 4)
+    if (nx - x < 4) {
+      /* compress pending complete blocks first to preserve block order */
+      _t2(zfp_encode_blocks_strided, Scalar, 1)(stream, batch, n, sx);
+      n = 0;
       _t2(zfp_encode_partial_block_strided, Scalar, 1)(stream, p, nx - x, sx);
-    else
-      _t2(zfp_encode_block_strided, Scalar, 1)(stream, p, sx);
+    }
+    else {
+      /* defer complete block to next batch */
+      batch[n++] = p;
+      if (n == ZFP_BATCH_SIZE) {
+        _t2(zfp_encode_blocks_strided, Scalar, 1)(stream, batch, n, sx);
+        n = 0;
+      }
+    }
   }
+  /* compress remaining batch */
+  _t2(zfp_encode_blocks_strided, Scalar, 1)(stream, batch, n, sx);
 }
 
 /* compress 2d strided array */
@@ -49,17 +71,31 @@ _t2(compress_strided, Scalar, 2)(zfp_stream* stream, const zfp_chunk *chunk,  co
   ptrdiff_t sx = field->sx ? field->sx : 1;
   ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
   size_t x, y;
+  const Scalar* batch[ZFP_BATCH_SIZE];
+  size_t n = 0;
 
 
-  /* compress array one block of 4x4 values at a time */
+  /* compress array in batches of blocks of 4x4 values */
   for (y = fy; y < ey; y += 4)
     for (x = fx; x < ex; x += 4) {
       const Scalar* p = data + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y;
-      if (nx - x < 4 || ny - y < 4)
+      if (nx - x < 4 || ny - y < 4) {
+        /* compress pending complete blocks first to preserve block order */
+        _t2(zfp_encode_blocks_strided, Scalar, 2)(stream, batch, n, sx, sy);
+        n = 0;
         _t2(zfp_encode_partial_block_strided, Scalar, 2)(stream, p, MIN(nx - x, 4u), MIN(ny - y, 4u), sx, sy);
-      else
-        _t2(zfp_encode_block_strided, Scalar, 2)(stream, p, sx, sy);
+      }
+      else {
+        /* defer complete block to next batch */
+        batch[n++] = p;
+        if (n == ZFP_BATCH_SIZE) {
+          _t2(zfp_encode_blocks_strided, Scalar, 2)(stream, batch, n, sx, sy);
+          n = 0;
+        }
+      }
     }
+  /* compress remaining batch */
+  _t2(zfp_encode_blocks_strided, Scalar, 2)(stream, batch, n, sx, sy);
 }
 
 /* compress 3d strided array */
@@ -80,28 +116,39 @@ _t2(compress_strided, Scalar, 3)(zfp_stream* stream, const zfp_chunk *chunk, con
   ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
   ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
   size_t x, y, z;
+  const Scalar* batch[ZFP_BATCH_SIZE];
+  size_t n = 0;
 
 
-  /* compress array one block of 4x4x4 values at a time */
+  /* compress array in batches of blocks of 4x4x4 values */
   for (z = fz; z < ez; z += 4)
     for (y = fy; y < ey; y += 4)
       for (x = fx; x < ex; x += 4) {
         const Scalar* p = data + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
-        if (nx - x < 4 || ny - y < 4 || nz - z < 4)
+        if (nx - x < 4 || ny - y < 4 || nz - z < 4) {
+          /* compress pending complete blocks first to preserve block order */
+          _t2(zfp_encode_blocks_strided, Scalar, 3)(stream, batch, n, sx, sy, sz);
+          n = 0;
           _t2(zfp_encode_partial_block_strided, Scalar, 3)(stream, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), sx, sy, sz);
-        else
-          _t2(zfp_encode_block_strided, Scalar, 3)(stream, p, sx, sy, sz);
+        }
+        else {
+          /* defer complete block to next batch */
+          batch[n++] = p;
+          if (n == ZFP_BATCH_SIZE) {
+            _t2(zfp_encode_blocks_strided, Scalar, 3)(stream, batch, n, sx, sy, sz);
+            n = 0;
+          }
+        }
       }
+  /* compress remaining batch */
+  _t2(zfp_encode_blocks_strided, Scalar, 3)(stream, batch, n, sx, sy, sz);
 }
 
 /* compress 4d strided array */
 static void
 _t2(compress_strided, Scalar, 4)(zfp_stream* stream, const zfp_chunk *chunk, const zfp_field* field)
 {
-
-
-
-  const Scalar *data = field->data;
+  const Scalar* data = field->data;
   size_t nx = field->nx;
   size_t ny = field->ny;
   size_t nz = field->nz;
@@ -119,35 +166,30 @@ _t2(compress_strided, Scalar, 4)(zfp_stream* stream, const zfp_chunk *chunk, con
   ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
   ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
   size_t x, y, z, w;
-  /* compress array one block of 4x4x4x4 values at a time */
-
-
-  int ic = 0, ic1 = 0, ic2 = 0;
+  const Scalar* batch[ZFP_BATCH_SIZE];
+  size_t n = 0;
 
+  /* compress array in batches of blocks of 4x4x4x4 values */
   for (w = fw; w < ew; w += 4)
-  {
     for (z = fz; z < ez; z += 4)
-    {
       for (y = fy; y < ey; y += 4)
-      {
-
-        for (x = fx; x < ex; x += 4, ic++)
-        {
-          const Scalar *p = data + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
-          if (nx - x < 4 || ny - y < 4 || nz - z < 4 || nw - w < 4)
-          {
-            ic1 += 1;
+        for (x = fx; x < ex; x += 4) {
+          const Scalar* p = data + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+          if (nx - x < 4 || ny - y < 4 || nz - z < 4 || nw - w < 4) {
+            /* compress pending complete blocks first to preserve block order */
+            _t2(zfp_encode_blocks_strided, Scalar, 4)(stream, batch, n, sx, sy, sz, sw);
+            n = 0;
             _t2(zfp_encode_partial_block_strided, Scalar, 4)(stream, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), MIN(nw - w, 4u), sx, sy, sz, sw);
           }
-          else
-          {
-            ic2 += 1;
-            _t2(zfp_encode_block_strided, Scalar, 4)(stream, p, sx, sy, sz, sw);
+          else {
+            /* defer complete block to next batch */
+            batch[n++] = p;
+            if (n == ZFP_BATCH_SIZE) {
+              _t2(zfp_encode_blocks_strided, Scalar, 4)(stream, batch, n, sx, sy, sz, sw);
+              n = 0;
+            }
           }
-
         }
-      }
-    }
-  }
-
+  /* compress remaining batch */
+  _t2(zfp_encode_blocks_strided, Scalar, 4)(stream, batch, n, sx, sy, sz, sw);
 }
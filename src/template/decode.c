@@ -1,6 +1,8 @@
 #include <limits.h>
+#include "simd.c"
 
 static void _t2(inv_xform, Int, DIMS)(Int* p);
+static void _t2(inv_xform_batch, Int, DIMS)(Int* p);
 
 /* private functions ------------------------------------------------------- */
 
@@ -33,6 +35,38 @@ _t1(inv_lift, Int)(Int* p, ptrdiff_t s)
   p -= s; *p = x;
 }
 
+/* inverse lifting transform of 4-vectors of all blocks in batch */
+static void
+_t1(inv_lift_batch, Int)(Int* p, ptrdiff_t s)
+{
+  uint i;
+  for (i = 0; i < BATCH_SIZE; i++, p++) {
+    Int x = p[0 * s];
+    Int y = p[1 * s];
+    Int z = p[2 * s];
+    Int w = p[3 * s];
+    /* same lifting steps as in inv_lift */
+    y += w >> 1; w -= y >> 1;
+    y += w; w <<= 1; w -= y;
+    z += x; x <<= 1; x -= z;
+    y += z; z <<= 1; z -= y;
+    w += x; x <<= 1; x -= w;
+    p[0 * s] = x;
+    p[1 * s] = y;
+    p[2 * s] = z;
+    p[3 * s] = w;
+  }
+}
+
+/* set unsigned coefficients of block j of batch to zero */
+static void
+_t2(clear_batch_block, Int, DIMS)(UInt* ublock, uint j)
+{
+  uint i;
+  for (i = 0; i < BLOCK_SIZE; i++)
+    ublock[BATCH_SIZE * i + j] = 0;
+}
+
 #if ZFP_ROUNDING_MODE == ZFP_ROUND_LAST
 /* bias values such that truncation is equivalent to round to nearest */
 static void
@@ -64,6 +98,18 @@ _t1(inv_order, Int)(const UInt* ublock, Int* iblock, const uchar* perm, uint n)
   while (--n);
 }
 
+/* reorder unsigned coefficients of all blocks in batch and convert to signed integers */
+static void
+_t1(inv_order_batch, Int)(const UInt* ublock, Int* iblock, const uchar* perm, uint n)
+{
+  uint j;
+  do {
+    Int* q = iblock + BATCH_SIZE * *perm++;
+    for (j = 0; j < BATCH_SIZE; j++)
+      q[j] = _t1(uint2int, UInt)(*ublock++);
+  } while (--n);
+}
+
 /* decompress sequence of size <= 64 unsigned integers */
 static uint
 _t1(decode_few_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec, UInt* restrict_ data, uint size)
@@ -75,6 +121,11 @@ _t1(decode_few_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxpr
   uint bits = maxbits;
   uint i, k, m, n;
   uint64 x;
+#if ZFP_SIMD_X86
+  /* defer deposit of bit planes to one transpose when supported by the CPU */
+  uint64 plane[CHAR_BIT * sizeof(UInt)];
+  zfp_bool planes = simd_planes(size);
+#endif
 
   /* initialize data array to all zeros */
   for (i = 0; i < size; i++)
@@ -90,12 +141,11 @@ _t1(decode_few_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxpr
     for (; bits && n < size; n++, m = n) {
       bits--;
       if (stream_read_bit(&s)) {
-        /* positive group test; scan for next one-bit */
-        for (; bits && n < size - 1; n++) {
-          bits--;
-          if (stream_read_bit(&s))
-            break;
-        }
+        /* positive group test; scan next c bits for one-bit */
+        uint c = MIN(bits, size - 1 - n);
+        uint z = stream_read_zeros(&s, c);
+        bits -= z < c ? z + 1 : z;
+        n += z;
         /* set bit and continue decoding bit plane */
         x += (uint64)1 << n;
       }
@@ -106,10 +156,21 @@ _t1(decode_few_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxpr
       }
     }
     /* step 3: deposit bit plane from x */
-    for (i = 0; x; i++, x >>= 1)
-      data[i] += (UInt)(x & 1u) << k;
+#if ZFP_SIMD_X86
+    if (planes)
+      plane[k] = x;
+    else
+#endif
+      for (i = 0; x; i++, x >>= 1)
+        data[i] += (UInt)(x & 1u) << k;
   }
 
+#if ZFP_SIMD_X86
+  /* deposit bit planes #k through #intprec-1 */
+  if (planes)
+    _t1(simd_inv_planes, UInt)(data, plane, size, bits ? kmin : k);
+#endif
+
 #if ZFP_ROUNDING_MODE == ZFP_ROUND_LAST
   /* bias values to achieve proper rounding */
   _t1(inv_round, UInt)(data, size, m, intprec - k);
@@ -146,12 +207,11 @@ _t1(decode_many_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxp
     for (; bits && n < size; n++, m = n) {
       bits--;
       if (stream_read_bit(&s)) {
-        /* positive group test; scan for next one-bit */
-        for (; bits && n < size - 1; n++) {
-          bits--;
-          if (stream_read_bit(&s))
-            break;
-        }
+        /* positive group test; scan next c bits for one-bit */
+        uint c = MIN(bits, size - 1 - n);
+        uint z = stream_read_zeros(&s, c);
+        bits -= z < c ? z + 1 : z;
+        n += z;
         /* set bit and continue decoding bit plane */
         data[n] += (UInt)1 << k;
       }
@@ -182,6 +242,12 @@ _t1(decode_few_ints_prec, UInt)(bitstream* restrict_ stream, uint maxprec, UInt*
   uint intprec = (uint)(CHAR_BIT * sizeof(UInt));
   uint kmin = intprec > maxprec ? intprec - maxprec : 0;
   uint i, k, n;
+  uint64 x;
+#if ZFP_SIMD_X86
+  /* defer deposit of bit planes to one transpose when supported by the CPU */
+  uint64 plane[CHAR_BIT * sizeof(UInt)];
+  zfp_bool planes = simd_planes(size);
+#endif
 
   /* initialize data array to all zeros */
   for (i = 0; i < size; i++)
@@ -190,16 +256,26 @@ _t1(decode_few_ints_prec, UInt)(bitstream* restrict_ stream, uint maxprec, UInt*
   /* decode one bit plane at a time from MSB to LSB */
   for (k = intprec, n = 0; k-- > kmin;) {
     /* step 1: decode first n bits of bit plane #k */
-    uint64 x = stream_read_bits(&s, n);
+    x = stream_read_bits(&s, n);
     /* step 2: unary run-length decode remainder of bit plane */
     for (; n < size && stream_read_bit(&s); x += (uint64)1 << n, n++)
-      for (; n < size - 1 && !stream_read_bit(&s); n++)
-        ;
+      n += stream_read_zeros(&s, size - 1 - n);
     /* step 3: deposit bit plane from x */
-    for (i = 0; x; i++, x >>= 1)
-      data[i] += (UInt)(x & 1u) << k;
+#if ZFP_SIMD_X86
+    if (planes)
+      plane[k] = x;
+    else
+#endif
+      for (i = 0; x; i++, x >>= 1)
+        data[i] += (UInt)(x & 1u) << k;
   }
 
+#if ZFP_SIMD_X86
+  /* deposit bit planes #kmin through #intprec-1 */
+  if (planes)
+    _t1(simd_inv_planes, UInt)(data, plane, size, kmin);
+#endif
+
 #if ZFP_ROUNDING_MODE == ZFP_ROUND_LAST
   /* bias values to achieve proper rounding */
   _t1(inv_round, UInt)(data, size, 0, intprec - k);
@@ -232,8 +308,7 @@ _t1(decode_many_ints_prec, UInt)(bitstream* restrict_ stream, uint maxprec, UInt
         data[i] += (UInt)1 << k;
     /* step 2: unary run-length decode remainder of bit plane */
     for (; n < size && stream_read_bit(&s); data[n] += (UInt)1 << k, n++)
-      for (; n < size - 1 && !stream_read_bit(&s); n++)
-        ;
+      n += stream_read_zeros(&s, size - 1 - n);
   }
 
 #if ZFP_ROUNDING_MODE == ZFP_ROUND_LAST
@@ -266,22 +341,52 @@ _t1(decode_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec,
   }
 }
 
-/* decode block of integers */
+/* decode unsigned transform coefficients in coefficient order */
 static uint
-_t2(decode_block, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, Int* iblock)
+_t2(decode_ucoeffs, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, UInt* ublock)
 {
-  uint bits;
-  cache_align_(UInt ublock[BLOCK_SIZE]);
   /* decode integer coefficients */
-  bits = _t1(decode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  uint bits = _t1(decode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
   /* read at least minbits bits */
   if (bits < minbits) {
     stream_skip(stream, minbits - bits);
     bits = minbits;
   }
+  return bits;
+}
+
+/* decode block of transform coefficients */
+static uint
+_t2(decode_coeffs, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, Int* iblock)
+{
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* decode integer coefficients */
+  uint bits = _t2(decode_ucoeffs, Int, DIMS)(stream, minbits, maxbits, maxprec, ublock);
   /* reorder unsigned coefficients and convert to signed integer */
   _t1(inv_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+  return bits;
+}
+
+/* decode block of integers */
+static uint
+_t2(decode_block, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, Int* iblock)
+{
+  /* decode transform coefficients */
+  uint bits = _t2(decode_coeffs, Int, DIMS)(stream, minbits, maxbits, maxprec, iblock);
   /* perform decorrelating transform */
   _t2(inv_xform, Int, DIMS)(iblock);
   return bits;
 }
+
+/* decode unsigned transform coefficients into block j of batch */
+static uint
+_t2(decode_batch_block, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, UInt* ublock, uint j)
+{
+  cache_align_(UInt block[BLOCK_SIZE]);
+  uint bits = _t2(decode_ucoeffs, Int, DIMS)(stream, minbits, maxbits, maxprec, block);
+  uint i;
+  /* copy block into batch */
+  for (i = 0; i < BLOCK_SIZE; i++)
+    ublock[BATCH_SIZE * i + j] = block[i];
+  return bits;
+}
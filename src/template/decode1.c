@@ -18,6 +18,15 @@ _t2(scatter_partial, Scalar, 1)(const Scalar* q, Scalar* p, size_t nx, ptrdiff_t
     *p = *q++;
 }
 
+/* scatter 4-value block from batch with stride BATCH_SIZE to strided array */
+static void
+_t2(scatter_batch, Scalar, 1)(const Scalar* q, Scalar* p, ptrdiff_t sx)
+{
+  uint x;
+  for (x = 0; x < 4; x++, p += sx, q += BATCH_SIZE)
+    *p = *q;
+}
+
 /* inverse decorrelating 1D transform */
 static void
 _t2(inv_xform, Int, 1)(Int* p)
@@ -26,6 +35,19 @@ _t2(inv_xform, Int, 1)(Int* p)
   _t1(inv_lift, Int)(p, 1);
 }
 
+/* inverse decorrelating 1D transform of all blocks in batch */
+static void
+_t2(inv_xform_batch, Int, 1)(Int* p)
+{
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_inv_xform_batch, Int)(p, 1))
+    return;
+#endif
+  /* transform along x */
+  _t1(inv_lift_batch, Int)(p, BATCH_SIZE * 1);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode 4-value block and store at p using stride sx */
@@ -51,3 +73,28 @@ _t2(zfp_decode_partial_block_strided, Scalar, 1)(zfp_stream* stream, Scalar* p,
   _t2(scatter_partial, Scalar, 1)(block, p, nx, sx);
   return bits;
 }
+
+/* decode n 4-value blocks and store at p[0], ..., p[n - 1] using stride sx */
+size_t
+_t2(zfp_decode_blocks_strided, Scalar, 1)(zfp_stream* stream, Scalar* const* p, size_t n, ptrdiff_t sx)
+{
+  cache_align_(Scalar block[BATCH_SIZE * 4]);
+  size_t bits = 0;
+  uint i, m;
+  /* reversible mode does not support batching */
+  if (REVERSIBLE(stream)) {
+    for (; n; n--)
+      bits += _t2(zfp_decode_block_strided, Scalar, 1)(stream, *p++, sx);
+    return bits;
+  }
+  /* decode blocks in batches of up to BATCH_SIZE blocks */
+  for (; n; n -= m, p += m) {
+    m = (uint)MIN(n, BATCH_SIZE);
+    /* decode batch */
+    bits += _t2(decode_batch, Scalar, 1)(stream, block, m);
+    /* scatter blocks to strided array */
+    for (i = 0; i < m; i++)
+      _t2(scatter_batch, Scalar, 1)(block + i, p[i], sx);
+  }
+  return bits;
+}
@@ -20,6 +20,16 @@ _t2(scatter_partial, Scalar, 2)(const Scalar* q, Scalar* p, size_t nx, size_t ny
       *p = *q;
 }
 
+/* scatter 4*4 block from batch with stride BATCH_SIZE to strided array */
+static void
+_t2(scatter_batch, Scalar, 2)(const Scalar* q, Scalar* p, ptrdiff_t sx, ptrdiff_t sy)
+{
+  uint x, y;
+  for (y = 0; y < 4; y++, p += sy - 4 * sx)
+    for (x = 0; x < 4; x++, p += sx, q += BATCH_SIZE)
+      *p = *q;
+}
+
 /* inverse decorrelating 2D transform */
 static void
 _t2(inv_xform, Int, 2)(Int* p)
@@ -33,6 +43,24 @@ _t2(inv_xform, Int, 2)(Int* p)
     _t1(inv_lift, Int)(p + 4 * y, 1);
 }
 
+/* inverse decorrelating 2D transform of all blocks in batch */
+static void
+_t2(inv_xform_batch, Int, 2)(Int* p)
+{
+  uint x, y;
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_inv_xform_batch, Int)(p, 2))
+    return;
+#endif
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    _t1(inv_lift_batch, Int)(p + BATCH_SIZE * (1 * x), BATCH_SIZE * 4);
+  /* transform along x */
+  for (y = 0; y < 4; y++)
+    _t1(inv_lift_batch, Int)(p + BATCH_SIZE * (4 * y), BATCH_SIZE * 1);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode 4*4 block and store at p using strides (sx, sy) */
@@ -58,3 +86,28 @@ _t2(zfp_decode_partial_block_strided, Scalar, 2)(zfp_stream* stream, Scalar* p,
   _t2(scatter_partial, Scalar, 2)(block, p, nx, ny, sx, sy);
   return bits;
 }
+
+/* decode n 4*4 blocks and store at p[0], ..., p[n - 1] using strides (sx, sy) */
+size_t
+_t2(zfp_decode_blocks_strided, Scalar, 2)(zfp_stream* stream, Scalar* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy)
+{
+  cache_align_(Scalar block[BATCH_SIZE * 16]);
+  size_t bits = 0;
+  uint i, m;
+  /* reversible mode does not support batching */
+  if (REVERSIBLE(stream)) {
+    for (; n; n--)
+      bits += _t2(zfp_decode_block_strided, Scalar, 2)(stream, *p++, sx, sy);
+    return bits;
+  }
+  /* decode blocks in batches of up to BATCH_SIZE blocks */
+  for (; n; n -= m, p += m) {
+    m = (uint)MIN(n, BATCH_SIZE);
+    /* decode batch */
+    bits += _t2(decode_batch, Scalar, 2)(stream, block, m);
+    /* scatter blocks to strided array */
+    for (i = 0; i < m; i++)
+      _t2(scatter_batch, Scalar, 2)(block + i, p[i], sx, sy);
+  }
+  return bits;
+}
@@ -22,11 +22,27 @@ _t2(scatter_partial, Scalar, 3)(const Scalar* q, Scalar* p, size_t nx, size_t ny
         *p = *q;
 }
 
+/* scatter 4*4*4 block from batch with stride BATCH_SIZE to strided array */
+static void
+_t2(scatter_batch, Scalar, 3)(const Scalar* q, Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+{
+  uint x, y, z;
+  for (z = 0; z < 4; z++, p += sz - 4 * sy)
+    for (y = 0; y < 4; y++, p += sy - 4 * sx)
+      for (x = 0; x < 4; x++, p += sx, q += BATCH_SIZE)
+        *p = *q;
+}
+
 /* inverse decorrelating 3D transform */
 static void
 _t2(inv_xform, Int, 3)(Int* p)
 {
   uint x, y, z;
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_inv_xform, Int)(p, 3))
+    return;
+#endif
   /* transform along z */
   for (y = 0; y < 4; y++)
     for (x = 0; x < 4; x++)
@@ -41,6 +57,30 @@ _t2(inv_xform, Int, 3)(Int* p)
       _t1(inv_lift, Int)(p + 4 * y + 16 * z, 1);
 }
 
+/* inverse decorrelating 3D transform of all blocks in batch */
+static void
+_t2(inv_xform_batch, Int, 3)(Int* p)
+{
+  uint x, y, z;
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_inv_xform_batch, Int)(p, 3))
+    return;
+#endif
+  /* transform along z */
+  for (y = 0; y < 4; y++)
+    for (x = 0; x < 4; x++)
+      _t1(inv_lift_batch, Int)(p + BATCH_SIZE * (1 * x + 4 * y), BATCH_SIZE * 16);
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    for (z = 0; z < 4; z++)
+      _t1(inv_lift_batch, Int)(p + BATCH_SIZE * (16 * z + 1 * x), BATCH_SIZE * 4);
+  /* transform along x */
+  for (z = 0; z < 4; z++)
+    for (y = 0; y < 4; y++)
+      _t1(inv_lift_batch, Int)(p + BATCH_SIZE * (4 * y + 16 * z), BATCH_SIZE * 1);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode 4*4*4 block and store at p using strides (sx, sy, sz) */
@@ -66,3 +106,28 @@ _t2(zfp_decode_partial_block_strided, Scalar, 3)(zfp_stream* stream, Scalar* p,
   _t2(scatter_partial, Scalar, 3)(block, p, nx, ny, nz, sx, sy, sz);
   return bits;
 }
+
+/* decode n 4*4*4 blocks and store at p[0], ..., p[n - 1] using strides (sx, sy, sz) */
+size_t
+_t2(zfp_decode_blocks_strided, Scalar, 3)(zfp_stream* stream, Scalar* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+{
+  cache_align_(Scalar block[BATCH_SIZE * 64]);
+  size_t bits = 0;
+  uint i, m;
+  /* reversible mode does not support batching */
+  if (REVERSIBLE(stream)) {
+    for (; n; n--)
+      bits += _t2(zfp_decode_block_strided, Scalar, 3)(stream, *p++, sx, sy, sz);
+    return bits;
+  }
+  /* decode blocks in batches of up to BATCH_SIZE blocks */
+  for (; n; n -= m, p += m) {
+    m = (uint)MIN(n, BATCH_SIZE);
+    /* decode batch */
+    bits += _t2(decode_batch, Scalar, 3)(stream, block, m);
+    /* scatter blocks to strided array */
+    for (i = 0; i < m; i++)
+      _t2(scatter_batch, Scalar, 3)(block + i, p[i], sx, sy, sz);
+  }
+  return bits;
+}
@@ -24,11 +24,28 @@ _t2(scatter_partial, Scalar, 4)(const Scalar* q, Scalar* p, size_t nx, size_t ny
           *p = *q;
 }
 
+/* scatter 4*4*4*4 block from batch with stride BATCH_SIZE to strided array */
+static void
+_t2(scatter_batch, Scalar, 4)(const Scalar* q, Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+{
+  uint x, y, z, w;
+  for (w = 0; w < 4; w++, p += sw - 4 * sz)
+    for (z = 0; z < 4; z++, p += sz - 4 * sy)
+      for (y = 0; y < 4; y++, p += sy - 4 * sx)
+        for (x = 0; x < 4; x++, p += sx, q += BATCH_SIZE)
+          *p = *q;
+}
+
 /* inverse decorrelating 4D transform */
 static void
 _t2(inv_xform, Int, 4)(Int* p)
 {
   uint x, y, z, w;
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_inv_xform, Int)(p, 4))
+    return;
+#endif
   /* transform along w */
   for (z = 0; z < 4; z++)
     for (y = 0; y < 4; y++)
@@ -51,6 +68,38 @@ _t2(inv_xform, Int, 4)(Int* p)
         _t1(inv_lift, Int)(p + 4 * y + 16 * z + 64 * w, 1);
 }
 
+/* inverse decorrelating 4D transform of all blocks in batch */
+static void
+_t2(inv_xform_batch, Int, 4)(Int* p)
+{
+  uint x, y, z, w;
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_inv_xform_batch, Int)(p, 4))
+    return;
+#endif
+  /* transform along w */
+  for (z = 0; z < 4; z++)
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        _t1(inv_lift_batch, Int)(p + BATCH_SIZE * (1 * x + 4 * y + 16 * z), BATCH_SIZE * 64);
+  /* transform along z */
+  for (y = 0; y < 4; y++)
+    for (x = 0; x < 4; x++)
+      for (w = 0; w < 4; w++)
+        _t1(inv_lift_batch, Int)(p + BATCH_SIZE * (64 * w + 1 * x + 4 * y), BATCH_SIZE * 16);
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    for (w = 0; w < 4; w++)
+      for (z = 0; z < 4; z++)
+        _t1(inv_lift_batch, Int)(p + BATCH_SIZE * (16 * z + 64 * w + 1 * x), BATCH_SIZE * 4);
+  /* transform along x */
+  for (w = 0; w < 4; w++)
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        _t1(inv_lift_batch, Int)(p + BATCH_SIZE * (4 * y + 16 * z + 64 * w), BATCH_SIZE * 1);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode 4*4*4*4 block and store at p using strides (sx, sy, sz, sw) */
@@ -76,3 +125,28 @@ _t2(zfp_decode_partial_block_strided, Scalar, 4)(zfp_stream* stream, Scalar* p,
   _t2(scatter_partial, Scalar, 4)(block, p, nx, ny, nz, nw, sx, sy, sz, sw);
   return bits;
 }
+
+/* decode n 4*4*4*4 blocks and store at p[0], ..., p[n - 1] using strides (sx, sy, sz, sw) */
+size_t
+_t2(zfp_decode_blocks_strided, Scalar, 4)(zfp_stream* stream, Scalar* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+{
+  cache_align_(Scalar block[BATCH_SIZE * 256]);
+  size_t bits = 0;
+  uint i, m;
+  /* reversible mode does not support batching */
+  if (REVERSIBLE(stream)) {
+    for (; n; n--)
+      bits += _t2(zfp_decode_block_strided, Scalar, 4)(stream, *p++, sx, sy, sz, sw);
+    return bits;
+  }
+  /* decode blocks in batches of up to BATCH_SIZE blocks */
+  for (; n; n -= m, p += m) {
+    m = (uint)MIN(n, BATCH_SIZE);
+    /* decode batch */
+    bits += _t2(decode_batch, Scalar, 4)(stream, block, m);
+    /* scatter blocks to strided array */
+    for (i = 0; i < m; i++)
+      _t2(scatter_batch, Scalar, 4)(block + i, p[i], sx, sy, sz, sw);
+  }
+  return bits;
+}
@@ -34,6 +34,64 @@ _t2(decode_block, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
   return bits;
 }
 
+/* inverse block-floating-point transform of batch with scale factors s */
+static void
+_t1(inv_cast_batch, Scalar)(const Int* iblock, Scalar* fblock, uint n, const Scalar* s)
+{
+  uint j;
+  do
+    for (j = 0; j < BATCH_SIZE; j++)
+      *fblock++ = (Scalar)(s[j] * *iblock++);
+  while (--n);
+}
+
+/* decode n blocks into batch using lossy algorithm */
+static size_t
+_t2(decode_batch, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock, uint n)
+{
+  cache_align_(Int iblock[BATCH_SIZE * BLOCK_SIZE]);
+  cache_align_(UInt ublock[BATCH_SIZE * BLOCK_SIZE]);
+  Scalar s[BATCH_SIZE];
+  size_t total = 0;
+  uint j;
+  /* decode blocks one at a time */
+  for (j = 0; j < n; j++) {
+    uint bits = 1;
+    /* test if block has nonzero values */
+    if (stream_read_bit(zfp->stream)) {
+      uint maxprec;
+      int emax;
+      /* decode common exponent and integer block */
+      bits += EBITS;
+      emax = (int)stream_read_bits(zfp->stream, EBITS) - EBIAS;
+      maxprec = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
+      bits += _t2(decode_batch_block, Int, DIMS)(zfp->stream, zfp->minbits - MIN(bits, zfp->minbits), zfp->maxbits - bits, maxprec, ublock, j);
+      s[j] = _t1(dequantize, Scalar)(emax);
+    }
+    else {
+      /* set all values to zero */
+      _t2(clear_batch_block, Int, DIMS)(ublock, j);
+      s[j] = 0;
+      if (zfp->minbits > bits) {
+        stream_skip(zfp->stream, zfp->minbits - bits);
+        bits = zfp->minbits;
+      }
+    }
+    total += bits;
+  }
+  /* set unused blocks to zero */
+  for (; j < BATCH_SIZE; j++) {
+    _t2(clear_batch_block, Int, DIMS)(ublock, j);
+    s[j] = 0;
+  }
+  /* reorder coefficients of all blocks and convert to signed integers */
+  _t1(inv_order_batch, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+  /* perform inverse decorrelating and block-floating-point transforms */
+  _t2(inv_xform_batch, Int, DIMS)(iblock);
+  _t1(inv_cast_batch, Scalar)(iblock, fblock, BLOCK_SIZE, s);
+  return total;
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode contiguous floating-point block */
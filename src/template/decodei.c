@@ -1,5 +1,27 @@
 static uint _t2(rev_decode_block, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, Int* iblock);
 
+/* private functions ------------------------------------------------------- */
+
+/* decode n blocks into batch */
+static size_t
+_t2(decode_batch, Int, DIMS)(zfp_stream* zfp, Int* iblock, uint n)
+{
+  cache_align_(UInt ublock[BATCH_SIZE * BLOCK_SIZE]);
+  size_t bits = 0;
+  uint j;
+  /* decode blocks one at a time */
+  for (j = 0; j < n; j++)
+    bits += _t2(decode_batch_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, ublock, j);
+  /* set unused blocks to zero */
+  for (; j < BATCH_SIZE; j++)
+    _t2(clear_batch_block, Int, DIMS)(ublock, j);
+  /* reorder coefficients of all blocks and convert to signed integers */
+  _t1(inv_order_batch, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+  /* perform inverse decorrelating transform */
+  _t2(inv_xform_batch, Int, DIMS)(iblock);
+  return bits;
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode contiguous integer block */
@@ -1,6 +1,8 @@
 #include <limits.h>
 #include <stdio.h>
+#include "simd.c"
 static void _t2(fwd_xform, Int, DIMS)(Int* p);
+static void _t2(fwd_xform_batch, Int, DIMS)(Int* p);
 
 /* private functions ------------------------------------------------------- */
 
@@ -55,6 +57,40 @@ _t1(fwd_lift, Int)(Int* p, ptrdiff_t s)
   p -= s; *p = x;
 }
 
+/* forward lifting transform of 4-vectors of all blocks in batch */
+static void
+_t1(fwd_lift_batch, Int)(Int* p, ptrdiff_t s)
+{
+  uint i;
+  for (i = 0; i < BATCH_SIZE; i++, p++) {
+    Int x = p[0 * s];
+    Int y = p[1 * s];
+    Int z = p[2 * s];
+    Int w = p[3 * s];
+    /* same lifting steps as in fwd_lift */
+    x += w; x >>= 1; w -= x;
+    z += y; z >>= 1; y -= z;
+    x += z; x >>= 1; z -= x;
+    w += y; w >>= 1; y -= w;
+    w += y >> 1; y -= w >> 1;
+    p[0 * s] = x;
+    p[1 * s] = y;
+    p[2 * s] = z;
+    p[3 * s] = w;
+  }
+}
+
+/* set blocks n through BATCH_SIZE - 1 of batch to zero */
+static void
+_t2(pad_batch, Scalar, DIMS)(Scalar* p, uint n)
+{
+  uint i, j;
+  if (n < BATCH_SIZE)
+    for (i = 0; i < BLOCK_SIZE; i++)
+      for (j = n; j < BATCH_SIZE; j++)
+        p[BATCH_SIZE * i + j] = 0;
+}
+
 #if ZFP_ROUNDING_MODE == ZFP_ROUND_FIRST
 /* bias values such that truncation is equivalent to round to nearest */
 static void
@@ -69,6 +105,22 @@ _t1(fwd_round, Int)(Int* iblock, uint n, uint maxprec)
       do *iblock++ -= bias; while (--n);
   }
 }
+
+/* bias values of block j of batch as in fwd_round */
+static void
+_t2(fwd_round_batch, Int, DIMS)(Int* iblock, uint j, uint maxprec)
+{
+  uint i;
+  if (maxprec < (uint)(CHAR_BIT * sizeof(Int))) {
+    Int bias = (NBMASK >> 2) >> maxprec;
+    if (maxprec & 1u)
+      for (i = 0; i < BLOCK_SIZE; i++)
+        iblock[BATCH_SIZE * i + j] += bias;
+    else
+      for (i = 0; i < BLOCK_SIZE; i++)
+        iblock[BATCH_SIZE * i + j] -= bias;
+  }
+}
 #endif
 
 /* map two's complement signed integer to negabinary unsigned integer */
@@ -87,6 +139,18 @@ _t1(fwd_order, Int)(UInt* ublock, const Int* iblock, const uchar* perm, uint n)
   while (--n);
 }
 
+/* reorder signed coefficients of all blocks in batch and convert to unsigned integers */
+static void
+_t1(fwd_order_batch, Int)(UInt* ublock, const Int* iblock, const uchar* perm, uint n)
+{
+  uint j;
+  do {
+    const Int* q = iblock + BATCH_SIZE * *perm++;
+    for (j = 0; j < BATCH_SIZE; j++)
+      *ublock++ = _t1(int2uint, Int)(q[j]);
+  } while (--n);
+}
+
 /* compress sequence of size <= 64 unsigned integers */
 static uint
 _t1(encode_few_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec, const UInt* restrict_ data, uint size)
@@ -97,14 +161,24 @@ _t1(encode_few_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxpr
   uint kmin = intprec > maxprec ? intprec - maxprec : 0;
   uint bits = maxbits;
   uint i, k, m, n;
-  uint64 x;
+  uint64 x, plane[CHAR_BIT * sizeof(UInt)];
+#if ZFP_SIMD_X86
+  /* transpose all bit planes up front when supported by the CPU */
+  zfp_bool planes = simd_planes(size);
+  if (planes)
+    _t1(simd_fwd_planes, UInt)(plane, data, size, kmin);
+#else
+  const zfp_bool planes = zfp_false;
+#endif
 
   /* encode one bit plane at a time from MSB to LSB */
   for (k = intprec, n = 0; bits && k-- > kmin;) {
     /* step 1: extract bit plane #k to x */
-    x = 0;
-    for (i = 0; i < size; i++)
-      x += (uint64)((data[i] >> k) & 1u) << i;
+    if (planes)
+      x = plane[k];
+    else
+      for (x = 0, i = 0; i < size; i++)
+        x += (uint64)((data[i] >> k) & 1u) << i;
     /* step 2: encode first n bits of bit plane */
     m = MIN(n, bits);
     bits -= m;
@@ -184,13 +258,24 @@ _t1(encode_few_ints_prec, UInt)(bitstream* restrict_ stream, uint maxprec, const
   uint intprec = (uint)(CHAR_BIT * sizeof(UInt));
   uint kmin = intprec > maxprec ? intprec - maxprec : 0;
   uint i, k, n;
+  uint64 x, plane[CHAR_BIT * sizeof(UInt)];
+#if ZFP_SIMD_X86
+  /* transpose all bit planes up front when supported by the CPU */
+  zfp_bool planes = simd_planes(size);
+  if (planes)
+    _t1(simd_fwd_planes, UInt)(plane, data, size, kmin);
+#else
+  const zfp_bool planes = zfp_false;
+#endif
 
   /* encode one bit plane at a time from MSB to LSB */
   for (k = intprec, n = 0; k-- > kmin;) {
     /* step 1: extract bit plane #k to x */
-    uint64 x = 0;
-    for (i = 0; i < size; i++)
-      x += (uint64)((data[i] >> k) & 1u) << i;
+    if (planes)
+      x = plane[k];
+    else
+      for (x = 0, i = 0; i < size; i++)
+        x += (uint64)((data[i] >> k) & 1u) << i;
     /* step 2: encode first n bits of bit plane */
     x = stream_write_bits(&s, x, n);
     /* step 3: unary run-length encode remainder of bit plane */
@@ -255,14 +340,25 @@ _t1(encode_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec,
   }
 }
 
-/* encode block of integers */
+/* encode reordered unsigned transform coefficients */
 static uint
-_t2(encode_block, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, Int* iblock)
+_t2(encode_ucoeffs, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, const UInt* ublock)
+{
+  /* encode integer coefficients */
+  uint bits = _t1(encode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  /* write at least minbits bits by padding with zeros */
+  if (bits < minbits) {
+    stream_pad(stream, minbits - bits);
+    bits = minbits;
+  }
+  return bits;
+}
+
+/* encode block of transform coefficients */
+static uint
+_t2(encode_coeffs, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, Int* iblock)
 {
-  uint bits;
   cache_align_(UInt ublock[BLOCK_SIZE]);
-  /* perform decorrelating transform */
-  _t2(fwd_xform, Int, DIMS)(iblock);
 #if ZFP_ROUNDING_MODE == ZFP_ROUND_FIRST
   /* bias values to achieve proper rounding */
   _t1(fwd_round, Int)(iblock, BLOCK_SIZE, maxprec);
@@ -270,11 +366,27 @@ _t2(encode_block, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint
   /* reorder signed coefficients and convert to unsigned integer */
   _t1(fwd_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
   /* encode integer coefficients */
-  bits = _t1(encode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
-  /* write at least minbits bits by padding with zeros */
-  if (bits < minbits) {
-    stream_pad(stream, minbits - bits);
-    bits = minbits;
-  }
-  return bits;
+  return _t2(encode_ucoeffs, Int, DIMS)(stream, minbits, maxbits, maxprec, ublock);
+}
+
+/* encode block of integers */
+static uint
+_t2(encode_block, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, Int* iblock)
+{
+  /* perform decorrelating transform */
+  _t2(fwd_xform, Int, DIMS)(iblock);
+  /* encode transform coefficients */
+  return _t2(encode_coeffs, Int, DIMS)(stream, minbits, maxbits, maxprec, iblock);
+}
+
+/* encode block j of batch of reordered unsigned transform coefficients */
+static uint
+_t2(encode_batch_block, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, const UInt* ublock, uint j)
+{
+  cache_align_(UInt block[BLOCK_SIZE]);
+  uint i;
+  /* copy block out of batch */
+  for (i = 0; i < BLOCK_SIZE; i++)
+    block[i] = ublock[BATCH_SIZE * i + j];
+  return _t2(encode_ucoeffs, Int, DIMS)(stream, minbits, maxbits, maxprec, block);
 }
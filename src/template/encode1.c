@@ -19,6 +19,15 @@ _t2(gather_partial, Scalar, 1)(Scalar* q, const Scalar* p, size_t nx, ptrdiff_t
   _t1(pad_block, Scalar)(q, nx, 1);
 }
 
+/* gather 4-value block from strided array into batch with stride BATCH_SIZE */
+static void
+_t2(gather_batch, Scalar, 1)(Scalar* q, const Scalar* p, ptrdiff_t sx)
+{
+  uint x;
+  for (x = 0; x < 4; x++, p += sx, q += BATCH_SIZE)
+    *q = *p;
+}
+
 /* forward decorrelating 1D transform */
 static void
 _t2(fwd_xform, Int, 1)(Int* p)
@@ -27,6 +36,19 @@ _t2(fwd_xform, Int, 1)(Int* p)
   _t1(fwd_lift, Int)(p, 1);
 }
 
+/* forward decorrelating 1D transform of all blocks in batch */
+static void
+_t2(fwd_xform_batch, Int, 1)(Int* p)
+{
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_fwd_xform_batch, Int)(p, 1))
+    return;
+#endif
+  /* transform along x */
+  _t1(fwd_lift_batch, Int)(p, BATCH_SIZE * 1);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode 4-value block stored at p using stride sx */
@@ -50,3 +72,29 @@ _t2(zfp_encode_partial_block_strided, Scalar, 1)(zfp_stream* stream, const Scala
   /* encode block */
   return _t2(zfp_encode_block, Scalar, 1)(stream, block);
 }
+
+/* encode n 4-value blocks stored at p[0], ..., p[n - 1] using stride sx */
+size_t
+_t2(zfp_encode_blocks_strided, Scalar, 1)(zfp_stream* stream, const Scalar* const* p, size_t n, ptrdiff_t sx)
+{
+  cache_align_(Scalar block[BATCH_SIZE * 4]);
+  size_t bits = 0;
+  uint i, m;
+  /* reversible mode does not support batching */
+  if (REVERSIBLE(stream)) {
+    for (; n; n--)
+      bits += _t2(zfp_encode_block_strided, Scalar, 1)(stream, *p++, sx);
+    return bits;
+  }
+  /* encode blocks in batches of up to BATCH_SIZE blocks */
+  for (; n; n -= m, p += m) {
+    m = (uint)MIN(n, BATCH_SIZE);
+    /* gather blocks from strided array */
+    for (i = 0; i < m; i++)
+      _t2(gather_batch, Scalar, 1)(block + i, p[i], sx);
+    _t2(pad_batch, Scalar, 1)(block, m);
+    /* encode batch */
+    bits += _t2(encode_batch, Scalar, 1)(stream, block, m);
+  }
+  return bits;
+}
@@ -24,6 +24,16 @@ _t2(gather_partial, Scalar, 2)(Scalar* q, const Scalar* p, size_t nx, size_t ny,
     _t1(pad_block, Scalar)(q + x, ny, 4);
 }
 
+/* gather 4*4 block from strided array into batch with stride BATCH_SIZE */
+static void
+_t2(gather_batch, Scalar, 2)(Scalar* q, const Scalar* p, ptrdiff_t sx, ptrdiff_t sy)
+{
+  uint x, y;
+  for (y = 0; y < 4; y++, p += sy - 4 * sx)
+    for (x = 0; x < 4; x++, p += sx, q += BATCH_SIZE)
+      *q = *p;
+}
+
 /* forward decorrelating 2D transform */
 static void
 _t2(fwd_xform, Int, 2)(Int* p)
@@ -37,6 +47,24 @@ _t2(fwd_xform, Int, 2)(Int* p)
     _t1(fwd_lift, Int)(p + 1 * x, 4);
 }
 
+/* forward decorrelating 2D transform of all blocks in batch */
+static void
+_t2(fwd_xform_batch, Int, 2)(Int* p)
+{
+  uint x, y;
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_fwd_xform_batch, Int)(p, 2))
+    return;
+#endif
+  /* transform along x */
+  for (y = 0; y < 4; y++)
+    _t1(fwd_lift_batch, Int)(p + BATCH_SIZE * (4 * y), BATCH_SIZE * 1);
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    _t1(fwd_lift_batch, Int)(p + BATCH_SIZE * (1 * x), BATCH_SIZE * 4);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode 4*4 block stored at p using strides (sx, sy) */
@@ -60,3 +88,29 @@ _t2(zfp_encode_partial_block_strided, Scalar, 2)(zfp_stream* stream, const Scala
   /* encode block */
   return _t2(zfp_encode_block, Scalar, 2)(stream, block);
 }
+
+/* encode n 4*4 blocks stored at p[0], ..., p[n - 1] using strides (sx, sy) */
+size_t
+_t2(zfp_encode_blocks_strided, Scalar, 2)(zfp_stream* stream, const Scalar* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy)
+{
+  cache_align_(Scalar block[BATCH_SIZE * 16]);
+  size_t bits = 0;
+  uint i, m;
+  /* reversible mode does not support batching */
+  if (REVERSIBLE(stream)) {
+    for (; n; n--)
+      bits += _t2(zfp_encode_block_strided, Scalar, 2)(stream, *p++, sx, sy);
+    return bits;
+  }
+  /* encode blocks in batches of up to BATCH_SIZE blocks */
+  for (; n; n -= m, p += m) {
+    m = (uint)MIN(n, BATCH_SIZE);
+    /* gather blocks from strided array */
+    for (i = 0; i < m; i++)
+      _t2(gather_batch, Scalar, 2)(block + i, p[i], sx, sy);
+    _t2(pad_batch, Scalar, 2)(block, m);
+    /* encode batch */
+    bits += _t2(encode_batch, Scalar, 2)(stream, block, m);
+  }
+  return bits;
+}
@@ -37,11 +37,28 @@ _t2(gather_partial, Scalar, 4)(Scalar* q, const Scalar* p, size_t nx, size_t ny,
         _t1(pad_block, Scalar)(q + 16 * z + 4 * y + x, nw, 64);
 }
 
+/* gather 4*4*4*4 block from strided array into batch with stride BATCH_SIZE */
+static void
+_t2(gather_batch, Scalar, 4)(Scalar* q, const Scalar* p, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+{
+  uint x, y, z, w;
+  for (w = 0; w < 4; w++, p += sw - 4 * sz)
+    for (z = 0; z < 4; z++, p += sz - 4 * sy)
+      for (y = 0; y < 4; y++, p += sy - 4 * sx)
+        for (x = 0; x < 4; x++, p += sx, q += BATCH_SIZE)
+          *q = *p;
+}
+
 /* forward decorrelating 4D transform */
 static void
 _t2(fwd_xform, Int, 4)(Int* p)
 {
   uint x, y, z, w;
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_fwd_xform, Int)(p, 4))
+    return;
+#endif
   /* transform along x */
   for (w = 0; w < 4; w++)
     for (z = 0; z < 4; z++)
@@ -64,6 +81,38 @@ _t2(fwd_xform, Int, 4)(Int* p)
         _t1(fwd_lift, Int)(p + 1 * x + 4 * y + 16 * z, 64);
 }
 
+/* forward decorrelating 4D transform of all blocks in batch */
+static void
+_t2(fwd_xform_batch, Int, 4)(Int* p)
+{
+  uint x, y, z, w;
+#if ZFP_SIMD_X86
+  /* use vectorized transform when supported by the CPU */
+  if (_t1(simd_fwd_xform_batch, Int)(p, 4))
+    return;
+#endif
+  /* transform along x */
+  for (w = 0; w < 4; w++)
+    for (z = 0; z < 4; z++)
+      for (y = 0; y < 4; y++)
+        _t1(fwd_lift_batch, Int)(p + BATCH_SIZE * (4 * y + 16 * z + 64 * w), BATCH_SIZE * 1);
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    for (w = 0; w < 4; w++)
+      for (z = 0; z < 4; z++)
+        _t1(fwd_lift_batch, Int)(p + BATCH_SIZE * (16 * z + 64 * w + 1 * x), BATCH_SIZE * 4);
+  /* transform along z */
+  for (y = 0; y < 4; y++)
+    for (x = 0; x < 4; x++)
+      for (w = 0; w < 4; w++)
+        _t1(fwd_lift_batch, Int)(p + BATCH_SIZE * (64 * w + 1 * x + 4 * y), BATCH_SIZE * 16);
+  /* transform along w */
+  for (z = 0; z < 4; z++)
+    for (y = 0; y < 4; y++)
+      for (x = 0; x < 4; x++)
+        _t1(fwd_lift_batch, Int)(p + BATCH_SIZE * (1 * x + 4 * y + 16 * z), BATCH_SIZE * 64);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode 4*4*4*4 block stored at p using strides (sx, sy, sz, sw) */
@@ -87,3 +136,29 @@ _t2(zfp_encode_partial_block_strided, Scalar, 4)(zfp_stream* stream, const Scala
   /* encode block */
   return _t2(zfp_encode_block, Scalar, 4)(stream, block);
 }
+
+/* encode n 4*4*4*4 blocks stored at p[0], ..., p[n - 1] using strides (sx, sy, sz, sw) */
+size_t
+_t2(zfp_encode_blocks_strided, Scalar, 4)(zfp_stream* stream, const Scalar* const* p, size_t n, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+{
+  cache_align_(Scalar block[BATCH_SIZE * 256]);
+  size_t bits = 0;
+  uint i, m;
+  /* reversible mode does not support batching */
+  if (REVERSIBLE(stream)) {
+    for (; n; n--)
+      bits += _t2(zfp_encode_block_strided, Scalar, 4)(stream, *p++, sx, sy, sz, sw);
+    return bits;
+  }
+  /* encode blocks in batches of up to BATCH_SIZE blocks */
+  for (; n; n -= m, p += m) {
+    m = (uint)MIN(n, BATCH_SIZE);
+    /* gather blocks from strided array */
+    for (i = 0; i < m; i++)
+      _t2(gather_batch, Scalar, 4)(block + i, p[i], sx, sy, sz, sw);
+    _t2(pad_batch, Scalar, 4)(block, m);
+    /* encode batch */
+    bits += _t2(encode_batch, Scalar, 4)(stream, block, m);
+  }
+  return bits;
+}
@@ -1,49 +1,59 @@
-#include <float.h>
 #include <limits.h>
-#include <math.h>
+#include <string.h>
 
 static uint _t2(rev_encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock);
 
 /* private functions ------------------------------------------------------- */
 
-/* return normalized floating-point exponent for x >= 0 */
+/* return IEEE representation of |x|, which is ordered like |x|, or zero if NaN */
+static UInt
+_t1(magnitude, Scalar)(Scalar x)
+{
+  /* IEEE representation of +infinity */
+  const UInt inf = (UInt)((1u << EBITS) - 1) << (CHAR_BIT * sizeof(Scalar) - 1 - EBITS);
+  UInt u;
+  memcpy(&u, &x, sizeof(u));
+  u &= TCMASK;
+  /* NaNs do not contribute to the block maximum */
+  return u > inf ? 0 : u;
+}
+
+/* return normalized floating-point exponent for x >= 0 represented by u */
 static int
-_t1(exponent, Scalar)(Scalar x)
+_t1(exponent, Scalar)(UInt u)
 {
+  /* biased exponent is zero when x is zero or subnormal */
+  int e = (int)(u >> (CHAR_BIT * sizeof(Scalar) - 1 - EBITS));
+  /* infinity has no exponent; use zero like frexp */
+  if (e == (1 << EBITS) - 1)
+    return 0;
   /* use e = -EBIAS when x = 0 */
-  int e = -EBIAS;
 #ifdef ZFP_WITH_DAZ
   /* treat subnormals as zero; resolves issue #119 by avoiding overflow */
-  if (x >= SCALAR_MIN)
-    FREXP(x, &e);
+  return e ? e + 1 - EBIAS : -EBIAS;
 #else
-  if (x > 0) {
-    FREXP(x, &e);
-    /* clamp exponent in case x is subnormal; may still result in overflow */
-    e = MAX(e, 1 - EBIAS);
-  }
+  /* subnormal x yields clamped exponent 1 - EBIAS; may still result in overflow */
+  return u ? e + 1 - EBIAS : -EBIAS;
 #endif
-  return e;
 }
 
 /* compute maximum floating-point exponent in block of n values */
 static int
 _t1(exponent_block, Scalar)(const Scalar* p, uint n)
 {
-  Scalar max = 0;
+  UInt max = 0;
   do {
-    Scalar f = FABS(*p++);
-    if (max < f)
-      max = f;
+    UInt u = _t1(magnitude, Scalar)(*p++);
+    max = MAX(max, u);
   } while (--n);
   return _t1(exponent, Scalar)(max);
 }
 
-/* map floating-point number x to integer relative to exponent e */
+/* map floating-point number 1 to integer relative to exponent e */
 static Scalar
-_t1(quantize, Scalar)(Scalar x, int e)
+_t1(quantize, Scalar)(int e)
 {
-  return LDEXP(x, ((int)(CHAR_BIT * sizeof(Scalar)) - 2) - e);
+  return _t1(scale, Scalar)(((int)(CHAR_BIT * sizeof(Scalar)) - 2) - e);
 }
 
 /* forward block-floating-point transform to signed integers */
@@ -51,13 +61,40 @@ static void
 _t1(fwd_cast, Scalar)(Int* iblock, const Scalar* fblock, uint n, int emax)
 {
   /* compute power-of-two scale factor s */
-  Scalar s = _t1(quantize, Scalar)(1, emax);
+  Scalar s = _t1(quantize, Scalar)(emax);
   /* compute p-bit int y = s*x where x is floating and |y| <= 2^(p-2) - 1 */
   do
     *iblock++ = (Int)(s * *fblock++);
   while (--n);
 }
 
+/* compute maximum floating-point exponent of each block in batch */
+static void
+_t1(exponent_batch, Scalar)(int* emax, const Scalar* p, uint n)
+{
+  UInt max[BATCH_SIZE] = { 0 };
+  uint j;
+  do {
+    for (j = 0; j < BATCH_SIZE; j++) {
+      UInt u = _t1(magnitude, Scalar)(*p++);
+      max[j] = MAX(max[j], u);
+    }
+  } while (--n);
+  for (j = 0; j < BATCH_SIZE; j++)
+    emax[j] = _t1(exponent, Scalar)(max[j]);
+}
+
+/* forward block-floating-point transform of batch with scale factors s */
+static void
+_t1(fwd_cast_batch, Scalar)(Int* iblock, const Scalar* fblock, uint n, const Scalar* s)
+{
+  uint j;
+  do
+    for (j = 0; j < BATCH_SIZE; j++)
+      *iblock++ = (Int)(s[j] * *fblock++);
+  while (--n);
+}
+
 /* encode contiguous floating-point block using lossy algorithm */
 static uint
 _t2(encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
@@ -89,6 +126,58 @@ _t2(encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
   return bits;
 }
 
+/* encode first n blocks of batch using lossy algorithm */
+static size_t
+_t2(encode_batch, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock, uint n)
+{
+  cache_align_(Int iblock[BATCH_SIZE * BLOCK_SIZE]);
+  cache_align_(UInt ublock[BATCH_SIZE * BLOCK_SIZE]);
+  int emax[BATCH_SIZE];
+  uint maxprec[BATCH_SIZE];
+  uint e[BATCH_SIZE];
+  Scalar s[BATCH_SIZE];
+  size_t total = 0;
+  uint j;
+  /* compute maximum exponent and scale factor of each block */
+  _t1(exponent_batch, Scalar)(emax, fblock, BLOCK_SIZE);
+  for (j = 0; j < BATCH_SIZE; j++) {
+    maxprec[j] = precision(emax[j], zfp->maxprec, zfp->minexp, DIMS);
+    e[j] = maxprec[j] ? (uint)(emax[j] + EBIAS) : 0;
+    /* blocks that are not encoded are scaled by zero to avoid overflow */
+    s[j] = e[j] ? _t1(quantize, Scalar)(emax[j]) : 0;
+  }
+  /* perform forward block-floating-point and decorrelating transforms */
+  _t1(fwd_cast_batch, Scalar)(iblock, fblock, BLOCK_SIZE, s);
+  _t2(fwd_xform_batch, Int, DIMS)(iblock);
+#if ZFP_ROUNDING_MODE == ZFP_ROUND_FIRST
+  /* bias values to achieve proper rounding */
+  for (j = 0; j < n; j++)
+    _t2(fwd_round_batch, Int, DIMS)(iblock, j, maxprec[j]);
+#endif
+  /* reorder coefficients of all blocks and convert to unsigned integers */
+  _t1(fwd_order_batch, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+  /* encode blocks one at a time */
+  for (j = 0; j < n; j++) {
+    uint bits = 1;
+    if (e[j]) {
+      /* encode common exponent and integer block */
+      bits += EBITS;
+      stream_write_bits(zfp->stream, 2 * e[j] + 1, bits);
+      bits += _t2(encode_batch_block, Int, DIMS)(zfp->stream, zfp->minbits - MIN(bits, zfp->minbits), zfp->maxbits - bits, maxprec[j], ublock, j);
+    }
+    else {
+      /* write single zero-bit to indicate that all values are zero */
+      stream_write_bit(zfp->stream, 0);
+      if (zfp->minbits > bits) {
+        stream_pad(zfp->stream, zfp->minbits - bits);
+        bits = zfp->minbits;
+      }
+    }
+    total += bits;
+  }
+  return total;
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode contiguous floating-point block */
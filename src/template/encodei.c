@@ -1,5 +1,29 @@
 static uint _t2(rev_encode_block, Int, DIMS)(bitstream* stream, uint minbits, uint maxbits, uint maxprec, Int* iblock);
 
+/* private functions ------------------------------------------------------- */
+
+/* encode first n blocks of batch */
+static size_t
+_t2(encode_batch, Int, DIMS)(zfp_stream* zfp, Int* iblock, uint n)
+{
+  cache_align_(UInt ublock[BATCH_SIZE * BLOCK_SIZE]);
+  size_t bits = 0;
+  uint j;
+  /* perform decorrelating transform */
+  _t2(fwd_xform_batch, Int, DIMS)(iblock);
+#if ZFP_ROUNDING_MODE == ZFP_ROUND_FIRST
+  /* bias values to achieve proper rounding */
+  for (j = 0; j < n; j++)
+    _t2(fwd_round_batch, Int, DIMS)(iblock, j, zfp->maxprec);
+#endif
+  /* reorder coefficients of all blocks and convert to unsigned integers */
+  _t1(fwd_order_batch, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+  /* encode blocks one at a time */
+  for (j = 0; j < n; j++)
+    bits += _t2(encode_batch_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, ublock, j);
+  return bits;
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode contiguous integer block */
@@ -26,6 +26,8 @@ _t2(compress_omp, Scalar, 1)(zfp_stream* stream, const zfp_chunk *chunk_des, con
     size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
     size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
     size_t block;
+    const Scalar* batch[ZFP_BATCH_SIZE];
+    size_t n = 0;
     /* set up thread-local bit stream */
     zfp_stream s = *stream;
     zfp_stream_set_bit_stream(&s, bs[chunk]);
@@ -36,11 +38,23 @@ _t2(compress_omp, Scalar, 1)(zfp_stream* stream, const zfp_chunk *chunk_des, con
       size_t x = 4 * block;
       p += x;
       /* compress partial or full block */
-      if (nx - x < 4u)
+      if (nx - x < 4u) {
+        /* compress pending complete blocks first to preserve block order */
+        _t2(zfp_encode_blocks_strided, Scalar, 1)(&s, batch, n, 1);
+        n = 0;
         _t2(zfp_encode_partial_block_strided, Scalar, 1)(&s, p, nx - x, 1);
-      else
-        _t2(zfp_encode_block, Scalar, 1)(&s, p);
+      }
+      else {
+        /* defer complete block to next batch */
+        batch[n++] = p;
+        if (n == ZFP_BATCH_SIZE) {
+          _t2(zfp_encode_blocks_strided, Scalar, 1)(&s, batch, n, 1);
+          n = 0;
+        }
+      }
     }
+    /* compress remaining batch */
+    _t2(zfp_encode_blocks_strided, Scalar, 1)(&s, batch, n, 1);
   }
 
   /* concatenate per-thread streams */
@@ -74,6 +88,8 @@ _t2(compress_strided_omp, Scalar, 1)(zfp_stream* stream,  const zfp_chunk *chunk
     size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
     size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
     size_t block;
+    const Scalar* batch[ZFP_BATCH_SIZE];
+    size_t n = 0;
     /* set up thread-local bit stream */
     zfp_stream s = *stream;
     zfp_stream_set_bit_stream(&s, bs[chunk]);
@@ -84,11 +100,23 @@ _t2(compress_strided_omp, Scalar, 1)(zfp_stream* stream,  const zfp_chunk *chunk
       size_t x = 4 * block;
       p += sx * (ptrdiff_t)x;
       /* compress partial or full block */
-      if (nx - x < 4u)
+      if (nx - x < 4u) {
+        /* compress pending complete blocks first to preserve block order */
+        _t2(zfp_encode_blocks_strided, Scalar, 1)(&s, batch, n, sx);
+        n = 0;
         _t2(zfp_encode_partial_block_strided, Scalar, 1)(&s, p, nx - x, sx);
-      else
-        _t2(zfp_encode_block_strided, Scalar, 1)(&s, p, sx);
+      }
+      else {
+        /* defer complete block to next batch */
+        batch[n++] = p;
+        if (n == ZFP_BATCH_SIZE) {
+          _t2(zfp_encode_blocks_strided, Scalar, 1)(&s, batch, n, sx);
+          n = 0;
+        }
+      }
     }
+    /* compress remaining batch */
+    _t2(zfp_encode_blocks_strided, Scalar, 1)(&s, batch, n, sx);
   }
 
   /* concatenate per-thread streams */
@@ -126,6 +154,8 @@ _t2(compress_strided_omp, Scalar, 2)(zfp_stream* stream,  const zfp_chunk *chunk
     size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
     size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
     size_t block;
+    const Scalar* batch[ZFP_BATCH_SIZE];
+    size_t n = 0;
     /* set up thread-local bit stream */
     zfp_stream s = *stream;
     zfp_stream_set_bit_stream(&s, bs[chunk]);
@@ -139,11 +169,23 @@ _t2(compress_strided_omp, Scalar, 2)(zfp_stream* stream,  const zfp_chunk *chunk
       y = 4 * b;
       p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y;
       /* compress partial or full block */
-      if (nx - x < 4u || ny - y < 4u)
+      if (nx - x < 4u || ny - y < 4u) {
+        /* compress pending complete blocks first to preserve block order */
+        _t2(zfp_encode_blocks_strided, Scalar, 2)(&s, batch, n, sx, sy);
+        n = 0;
         _t2(zfp_encode_partial_block_strided, Scalar, 2)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), sx, sy);
-      else
-        _t2(zfp_encode_block_strided, Scalar, 2)(&s, p, sx, sy);
+      }
+      else {
+        /* defer complete block to next batch */
+        batch[n++] = p;
+        if (n == ZFP_BATCH_SIZE) {
+          _t2(zfp_encode_blocks_strided, Scalar, 2)(&s, batch, n, sx, sy);
+          n = 0;
+        }
+      }
     }
+    /* compress remaining batch */
+    _t2(zfp_encode_blocks_strided, Scalar, 2)(&s, batch, n, sx, sy);
   }
 
   /* concatenate per-thread streams */
@@ -184,6 +226,8 @@ _t2(compress_strided_omp, Scalar, 3)(zfp_stream* stream,  const zfp_chunk *chunk
     size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
     size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
     size_t block;
+    const Scalar* batch[ZFP_BATCH_SIZE];
+    size_t n = 0;
     /* set up thread-local bit stream */
     zfp_stream s = *stream;
     zfp_stream_set_bit_stream(&s, bs[chunk]);
@@ -198,11 +242,23 @@ _t2(compress_strided_omp, Scalar, 3)(zfp_stream* stream,  const zfp_chunk *chunk
       z = 4 * b;
       p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
       /* compress partial or full block */
-      if (nx - x < 4u || ny - y < 4u || nz - z < 4u)
+      if (nx - x < 4u || ny - y < 4u || nz - z < 4u) {
+        /* compress pending complete blocks first to preserve block order */
+        _t2(zfp_encode_blocks_strided, Scalar, 3)(&s, batch, n, sx, sy, sz);
+        n = 0;
         _t2(zfp_encode_partial_block_strided, Scalar, 3)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), sx, sy, sz);
-      else
-        _t2(zfp_encode_block_strided, Scalar, 3)(&s, p, sx, sy, sz);
+      }
+      else {
+        /* defer complete block to next batch */
+        batch[n++] = p;
+        if (n == ZFP_BATCH_SIZE) {
+          _t2(zfp_encode_blocks_strided, Scalar, 3)(&s, batch, n, sx, sy, sz);
+          n = 0;
+        }
+      }
     }
+    /* compress remaining batch */
+    _t2(zfp_encode_blocks_strided, Scalar, 3)(&s, batch, n, sx, sy, sz);
   }
 
   /* concatenate per-thread streams */
@@ -246,6 +302,8 @@ _t2(compress_strided_omp, Scalar, 4)(zfp_stream* stream,  const zfp_chunk *chunk
     size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
     size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
     size_t block;
+    const Scalar* batch[ZFP_BATCH_SIZE];
+    size_t n = 0;
     /* set up thread-local bit stream */
     zfp_stream s = *stream;
     zfp_stream_set_bit_stream(&s, bs[chunk]);
@@ -261,11 +319,23 @@ _t2(compress_strided_omp, Scalar, 4)(zfp_stream* stream,  const zfp_chunk *chunk
       w = 4 * b;
       p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
       /* compress partial or full block */
-      if (nx - x < 4u || ny - y < 4u || nz - z < 4u || nw - w < 4u)
+      if (nx - x < 4u || ny - y < 4u || nz - z < 4u || nw - w < 4u) {
+        /* compress pending complete blocks first to preserve block order */
+        _t2(zfp_encode_blocks_strided, Scalar, 4)(&s, batch, n, sx, sy, sz, sw);
+        n = 0;
         _t2(zfp_encode_partial_block_strided, Scalar, 4)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), MIN(nw - w, 4u), sx, sy, sz, sw);
-      else
-        _t2(zfp_encode_block_strided, Scalar, 4)(&s, p, sx, sy, sz, sw);
+      }
+      else {
+        /* defer complete block to next batch */
+        batch[n++] = p;
+        if (n == ZFP_BATCH_SIZE) {
+          _t2(zfp_encode_blocks_strided, Scalar, 4)(&s, batch, n, sx, sy, sz, sw);
+          n = 0;
+        }
+      }
     }
+    /* compress remaining batch */
+    _t2(zfp_encode_blocks_strided, Scalar, 4)(&s, batch, n, sx, sy, sz, sw);
   }
 
   /* concatenate per-thread streams */
@@ -0,0 +1,962 @@
+#ifndef ZFP_SIMD_C
+#define ZFP_SIMD_C
+
+/* x86 SIMD kernels compiled for specific instruction sets and selected at
+   run time; callers fall back on portable C when no kernel applies */
+
+#if defined(ZFP_WITH_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+  #define ZFP_SIMD_X86 1
+#else
+  #define ZFP_SIMD_X86 0
+#endif
+
+#if ZFP_SIMD_X86
+
+#include <immintrin.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ZFP_SIMD_NONE   0
+#define ZFP_SIMD_AVX2   1
+#define ZFP_SIMD_AVX512 2
+
+#define simd_avx2_   __attribute__((target("avx2")))
+#define simd_avx512_ __attribute__((target("avx512f")))
+
+/* widest instruction set supported by CPU and OS, optionally capped by
+   environment variable ZFP_SIMD=none|avx2 to exercise narrower kernels */
+static inline int
+simd_level(void)
+{
+  /* concurrent first callers compute the same level, so relaxed atomics suffice */
+  static int level = -1;
+  int l = __atomic_load_n(&level, __ATOMIC_RELAXED);
+  if (l < 0) {
+    const char* cap = getenv("ZFP_SIMD");
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+      l = ZFP_SIMD_AVX512;
+    else if (__builtin_cpu_supports("avx2"))
+      l = ZFP_SIMD_AVX2;
+    else
+      l = ZFP_SIMD_NONE;
+    if (cap && !strcmp(cap, "none"))
+      l = ZFP_SIMD_NONE;
+    else if (cap && !strcmp(cap, "avx2"))
+      l = MIN(l, ZFP_SIMD_AVX2);
+    __atomic_store_n(&level, l, __ATOMIC_RELAXED);
+  }
+  return l;
+}
+
+/* lifting steps of fwd_lift and inv_lift applied lane-wise to vectors */
+#define SIMD_FWD_LIFT(add, sub, sra, x, y, z, w) \
+  do { \
+    x = add(x, w); x = sra(x); w = sub(w, x); \
+    z = add(z, y); z = sra(z); y = sub(y, z); \
+    x = add(x, z); x = sra(x); z = sub(z, x); \
+    w = add(w, y); w = sra(w); y = sub(y, w); \
+    w = add(w, sra(y)); y = sub(y, sra(w)); \
+  } while (0)
+
+#define SIMD_INV_LIFT(add, sub, sra, sla, x, y, z, w) \
+  do { \
+    y = add(y, sra(w)); w = sub(w, sra(y)); \
+    y = add(y, w); w = sla(w); w = sub(w, y); \
+    z = add(z, x); x = sla(x); x = sub(x, z); \
+    y = add(y, z); z = sla(z); z = sub(z, y); \
+    w = add(w, x); x = sla(x); x = sub(x, w); \
+  } while (0)
+
+/* AVX2 ---------------------------------------------------------------------*/
+
+#define avx2_add32(a, b) _mm256_add_epi32(a, b)
+#define avx2_sub32(a, b) _mm256_sub_epi32(a, b)
+#define avx2_sra32(a)    _mm256_srai_epi32(a, 1)
+#define avx2_sla32(a)    _mm256_slli_epi32(a, 1)
+#define avx2_add64(a, b) _mm256_add_epi64(a, b)
+#define avx2_sub64(a, b) _mm256_sub_epi64(a, b)
+#define avx2_sra64(a)    avx2_srai1_epi64(a)
+#define avx2_sla64(a)    _mm256_slli_epi64(a, 1)
+
+/* arithmetic shift right by one of 64-bit lanes, which AVX2 lacks */
+static simd_avx2_ inline __m256i
+avx2_srai1_epi64(__m256i a)
+{
+  const __m256i m = _mm256_set1_epi64x((int64)1 << 62);
+  return _mm256_sub_epi64(_mm256_xor_si256(_mm256_srli_epi64(a, 1), m), m);
+}
+
+/* transpose 4x4 matrices of 32-bit values within each 128-bit lane */
+static simd_avx2_ inline void
+avx2_transpose_epi32(__m256i* v)
+{
+  __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+  __m256i t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+  __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+  __m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+  v[0] = _mm256_unpacklo_epi64(t0, t2);
+  v[1] = _mm256_unpackhi_epi64(t0, t2);
+  v[2] = _mm256_unpacklo_epi64(t1, t3);
+  v[3] = _mm256_unpackhi_epi64(t1, t3);
+}
+
+/* transpose 4x4 matrix of 64-bit values */
+static simd_avx2_ inline void
+avx2_transpose_epi64(__m256i* v)
+{
+  __m256i t0 = _mm256_unpacklo_epi64(v[0], v[1]);
+  __m256i t1 = _mm256_unpackhi_epi64(v[0], v[1]);
+  __m256i t2 = _mm256_unpacklo_epi64(v[2], v[3]);
+  __m256i t3 = _mm256_unpackhi_epi64(v[2], v[3]);
+  v[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+  v[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+  v[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+  v[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+/* forward x, y, and z transforms of 4*4*4 block; each vector holds row y
+   of planes z and z + 1 while the x and y transforms are applied */
+static simd_avx2_ inline void
+avx2_fwd_xyz_int32(int32* p)
+{
+  __m256i v[4];
+  uint y, z;
+  for (z = 0; z < 4; z += 2) {
+    int32* q = p + 16 * z;
+    for (y = 0; y < 4; y++)
+      v[y] = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(q + 4 * y))), _mm_loadu_si128((const __m128i*)(q + 16 + 4 * y)), 1);
+    avx2_transpose_epi32(v);
+    SIMD_FWD_LIFT(avx2_add32, avx2_sub32, avx2_sra32, v[0], v[1], v[2], v[3]);
+    avx2_transpose_epi32(v);
+    SIMD_FWD_LIFT(avx2_add32, avx2_sub32, avx2_sra32, v[0], v[1], v[2], v[3]);
+    for (y = 0; y < 4; y++) {
+      _mm_storeu_si128((__m128i*)(q + 4 * y), _mm256_castsi256_si128(v[y]));
+      _mm_storeu_si128((__m128i*)(q + 16 + 4 * y), _mm256_extracti128_si256(v[y], 1));
+    }
+  }
+  for (y = 0; y < 16; y += 8) {
+    for (z = 0; z < 4; z++)
+      v[z] = _mm256_loadu_si256((const __m256i*)(p + 16 * z + y));
+    SIMD_FWD_LIFT(avx2_add32, avx2_sub32, avx2_sra32, v[0], v[1], v[2], v[3]);
+    for (z = 0; z < 4; z++)
+      _mm256_storeu_si256((__m256i*)(p + 16 * z + y), v[z]);
+  }
+}
+
+/* inverse z, y, and x transforms of 4*4*4 block */
+static simd_avx2_ inline void
+avx2_inv_xyz_int32(int32* p)
+{
+  __m256i v[4];
+  uint y, z;
+  for (y = 0; y < 16; y += 8) {
+    for (z = 0; z < 4; z++)
+      v[z] = _mm256_loadu_si256((const __m256i*)(p + 16 * z + y));
+    SIMD_INV_LIFT(avx2_add32, avx2_sub32, avx2_sra32, avx2_sla32, v[0], v[1], v[2], v[3]);
+    for (z = 0; z < 4; z++)
+      _mm256_storeu_si256((__m256i*)(p + 16 * z + y), v[z]);
+  }
+  for (z = 0; z < 4; z += 2) {
+    int32* q = p + 16 * z;
+    for (y = 0; y < 4; y++)
+      v[y] = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(q + 4 * y))), _mm_loadu_si128((const __m128i*)(q + 16 + 4 * y)), 1);
+    SIMD_INV_LIFT(avx2_add32, avx2_sub32, avx2_sra32, avx2_sla32, v[0], v[1], v[2], v[3]);
+    avx2_transpose_epi32(v);
+    SIMD_INV_LIFT(avx2_add32, avx2_sub32, avx2_sra32, avx2_sla32, v[0], v[1], v[2], v[3]);
+    avx2_transpose_epi32(v);
+    for (y = 0; y < 4; y++) {
+      _mm_storeu_si128((__m128i*)(q + 4 * y), _mm256_castsi256_si128(v[y]));
+      _mm_storeu_si128((__m128i*)(q + 16 + 4 * y), _mm256_extracti128_si256(v[y], 1));
+    }
+  }
+}
+
+/* forward x, y, and z transforms of 4*4*4 block, one plane z at a time */
+static simd_avx2_ inline void
+avx2_fwd_xyz_int64(int64* p)
+{
+  __m256i v[4];
+  uint y, z;
+  for (z = 0; z < 4; z++) {
+    int64* q = p + 16 * z;
+    for (y = 0; y < 4; y++)
+      v[y] = _mm256_loadu_si256((const __m256i*)(q + 4 * y));
+    avx2_transpose_epi64(v);
+    SIMD_FWD_LIFT(avx2_add64, avx2_sub64, avx2_sra64, v[0], v[1], v[2], v[3]);
+    avx2_transpose_epi64(v);
+    SIMD_FWD_LIFT(avx2_add64, avx2_sub64, avx2_sra64, v[0], v[1], v[2], v[3]);
+    for (y = 0; y < 4; y++)
+      _mm256_storeu_si256((__m256i*)(q + 4 * y), v[y]);
+  }
+  for (y = 0; y < 16; y += 4) {
+    for (z = 0; z < 4; z++)
+      v[z] = _mm256_loadu_si256((const __m256i*)(p + 16 * z + y));
+    SIMD_FWD_LIFT(avx2_add64, avx2_sub64, avx2_sra64, v[0], v[1], v[2], v[3]);
+    for (z = 0; z < 4; z++)
+      _mm256_storeu_si256((__m256i*)(p + 16 * z + y), v[z]);
+  }
+}
+
+/* inverse z, y, and x transforms of 4*4*4 block */
+static simd_avx2_ inline void
+avx2_inv_xyz_int64(int64* p)
+{
+  __m256i v[4];
+  uint y, z;
+  for (y = 0; y < 16; y += 4) {
+    for (z = 0; z < 4; z++)
+      v[z] = _mm256_loadu_si256((const __m256i*)(p + 16 * z + y));
+    SIMD_INV_LIFT(avx2_add64, avx2_sub64, avx2_sra64, avx2_sla64, v[0], v[1], v[2], v[3]);
+    for (z = 0; z < 4; z++)
+      _mm256_storeu_si256((__m256i*)(p + 16 * z + y), v[z]);
+  }
+  for (z = 0; z < 4; z++) {
+    int64* q = p + 16 * z;
+    for (y = 0; y < 4; y++)
+      v[y] = _mm256_loadu_si256((const __m256i*)(q + 4 * y));
+    SIMD_INV_LIFT(avx2_add64, avx2_sub64, avx2_sra64, avx2_sla64, v[0], v[1], v[2], v[3]);
+    avx2_transpose_epi64(v);
+    SIMD_INV_LIFT(avx2_add64, avx2_sub64, avx2_sra64, avx2_sla64, v[0], v[1], v[2], v[3]);
+    avx2_transpose_epi64(v);
+    for (y = 0; y < 4; y++)
+      _mm256_storeu_si256((__m256i*)(q + 4 * y), v[y]);
+  }
+}
+
+/* forward w transform of 4*4*4*4 block */
+static simd_avx2_ inline void
+avx2_fwd_w_int32(int32* p)
+{
+  __m256i v[4];
+  uint i, w;
+  for (i = 0; i < 64; i += 8) {
+    for (w = 0; w < 4; w++)
+      v[w] = _mm256_loadu_si256((const __m256i*)(p + 64 * w + i));
+    SIMD_FWD_LIFT(avx2_add32, avx2_sub32, avx2_sra32, v[0], v[1], v[2], v[3]);
+    for (w = 0; w < 4; w++)
+      _mm256_storeu_si256((__m256i*)(p + 64 * w + i), v[w]);
+  }
+}
+
+/* inverse w transform of 4*4*4*4 block */
+static simd_avx2_ inline void
+avx2_inv_w_int32(int32* p)
+{
+  __m256i v[4];
+  uint i, w;
+  for (i = 0; i < 64; i += 8) {
+    for (w = 0; w < 4; w++)
+      v[w] = _mm256_loadu_si256((const __m256i*)(p + 64 * w + i));
+    SIMD_INV_LIFT(avx2_add32, avx2_sub32, avx2_sra32, avx2_sla32, v[0], v[1], v[2], v[3]);
+    for (w = 0; w < 4; w++)
+      _mm256_storeu_si256((__m256i*)(p + 64 * w + i), v[w]);
+  }
+}
+
+/* forward w transform of 4*4*4*4 block */
+static simd_avx2_ inline void
+avx2_fwd_w_int64(int64* p)
+{
+  __m256i v[4];
+  uint i, w;
+  for (i = 0; i < 64; i += 4) {
+    for (w = 0; w < 4; w++)
+      v[w] = _mm256_loadu_si256((const __m256i*)(p + 64 * w + i));
+    SIMD_FWD_LIFT(avx2_add64, avx2_sub64, avx2_sra64, v[0], v[1], v[2], v[3]);
+    for (w = 0; w < 4; w++)
+      _mm256_storeu_si256((__m256i*)(p + 64 * w + i), v[w]);
+  }
+}
+
+/* inverse w transform of 4*4*4*4 block */
+static simd_avx2_ inline void
+avx2_inv_w_int64(int64* p)
+{
+  __m256i v[4];
+  uint i, w;
+  for (i = 0; i < 64; i += 4) {
+    for (w = 0; w < 4; w++)
+      v[w] = _mm256_loadu_si256((const __m256i*)(p + 64 * w + i));
+    SIMD_INV_LIFT(avx2_add64, avx2_sub64, avx2_sra64, avx2_sla64, v[0], v[1], v[2], v[3]);
+    for (w = 0; w < 4; w++)
+      _mm256_storeu_si256((__m256i*)(p + 64 * w + i), v[w]);
+  }
+}
+
+/* forward transform of batch of 8 blocks stored with stride 8, each vector
+   holding one value of all blocks; axis a lifts positions i with digit a
+   of i in base 4 equal to zero */
+static simd_avx2_ inline void
+avx2_fwd_batch_int32(int32* p, uint dims)
+{
+  uint size = 1u << (2 * dims);
+  uint i, k, s;
+  __m256i v[4];
+  for (s = 1; s < size; s *= 4)
+    for (i = 0; i < size; i++)
+      if (!(i & (3 * s))) {
+        for (k = 0; k < 4; k++)
+          v[k] = _mm256_loadu_si256((const __m256i*)(p + 8 * (i + k * s)));
+        SIMD_FWD_LIFT(avx2_add32, avx2_sub32, avx2_sra32, v[0], v[1], v[2], v[3]);
+        for (k = 0; k < 4; k++)
+          _mm256_storeu_si256((__m256i*)(p + 8 * (i + k * s)), v[k]);
+      }
+}
+
+/* inverse transform of batch of 8 blocks */
+static simd_avx2_ inline void
+avx2_inv_batch_int32(int32* p, uint dims)
+{
+  uint size = 1u << (2 * dims);
+  uint i, k, s;
+  __m256i v[4];
+  for (s = size / 4; s; s /= 4)
+    for (i = 0; i < size; i++)
+      if (!(i & (3 * s))) {
+        for (k = 0; k < 4; k++)
+          v[k] = _mm256_loadu_si256((const __m256i*)(p + 8 * (i + k * s)));
+        SIMD_INV_LIFT(avx2_add32, avx2_sub32, avx2_sra32, avx2_sla32, v[0], v[1], v[2], v[3]);
+        for (k = 0; k < 4; k++)
+          _mm256_storeu_si256((__m256i*)(p + 8 * (i + k * s)), v[k]);
+      }
+}
+
+/* forward transform of batch of 8 blocks, four blocks per vector */
+static simd_avx2_ inline void
+avx2_fwd_batch_int64(int64* p, uint dims)
+{
+  uint size = 1u << (2 * dims);
+  uint h, i, k, s;
+  __m256i v[4];
+  for (s = 1; s < size; s *= 4)
+    for (i = 0; i < size; i++)
+      if (!(i & (3 * s)))
+        for (h = 0; h < 8; h += 4) {
+          for (k = 0; k < 4; k++)
+            v[k] = _mm256_loadu_si256((const __m256i*)(p + 8 * (i + k * s) + h));
+          SIMD_FWD_LIFT(avx2_add64, avx2_sub64, avx2_sra64, v[0], v[1], v[2], v[3]);
+          for (k = 0; k < 4; k++)
+            _mm256_storeu_si256((__m256i*)(p + 8 * (i + k * s) + h), v[k]);
+        }
+}
+
+/* inverse transform of batch of 8 blocks */
+static simd_avx2_ inline void
+avx2_inv_batch_int64(int64* p, uint dims)
+{
+  uint size = 1u << (2 * dims);
+  uint h, i, k, s;
+  __m256i v[4];
+  for (s = size / 4; s; s /= 4)
+    for (i = 0; i < size; i++)
+      if (!(i & (3 * s)))
+        for (h = 0; h < 8; h += 4) {
+          for (k = 0; k < 4; k++)
+            v[k] = _mm256_loadu_si256((const __m256i*)(p + 8 * (i + k * s) + h));
+          SIMD_INV_LIFT(avx2_add64, avx2_sub64, avx2_sra64, avx2_sla64, v[0], v[1], v[2], v[3]);
+          for (k = 0; k < 4; k++)
+            _mm256_storeu_si256((__m256i*)(p + 8 * (i + k * s) + h), v[k]);
+        }
+}
+
+/* AVX-512 ------------------------------------------------------------------*/
+
+#define avx512_add32(a, b) _mm512_add_epi32(a, b)
+#define avx512_sub32(a, b) _mm512_sub_epi32(a, b)
+#define avx512_sra32(a)    _mm512_srai_epi32(a, 1)
+#define avx512_sla32(a)    _mm512_slli_epi32(a, 1)
+#define avx512_add64(a, b) _mm512_add_epi64(a, b)
+#define avx512_sub64(a, b) _mm512_sub_epi64(a, b)
+#define avx512_sra64(a)    _mm512_srai_epi64(a, 1)
+#define avx512_sla64(a)    _mm512_slli_epi64(a, 1)
+
+/* transpose 4x4 matrices of 32-bit values within each 128-bit lane */
+static simd_avx512_ inline void
+avx512_transpose_epi32(__m512i* v)
+{
+  __m512i t0 = _mm512_unpacklo_epi32(v[0], v[1]);
+  __m512i t1 = _mm512_unpackhi_epi32(v[0], v[1]);
+  __m512i t2 = _mm512_unpacklo_epi32(v[2], v[3]);
+  __m512i t3 = _mm512_unpackhi_epi32(v[2], v[3]);
+  v[0] = _mm512_unpacklo_epi64(t0, t2);
+  v[1] = _mm512_unpackhi_epi64(t0, t2);
+  v[2] = _mm512_unpacklo_epi64(t1, t3);
+  v[3] = _mm512_unpackhi_epi64(t1, t3);
+}
+
+/* transpose 4x4 matrix of 128-bit lanes */
+static simd_avx512_ inline void
+avx512_transpose_lanes(__m512i* v)
+{
+  __m512i t0 = _mm512_shuffle_i32x4(v[0], v[1], 0x44);
+  __m512i t1 = _mm512_shuffle_i32x4(v[0], v[1], 0xee);
+  __m512i t2 = _mm512_shuffle_i32x4(v[2], v[3], 0x44);
+  __m512i t3 = _mm512_shuffle_i32x4(v[2], v[3], 0xee);
+  v[0] = _mm512_shuffle_i32x4(t0, t2, 0x88);
+  v[1] = _mm512_shuffle_i32x4(t0, t2, 0xdd);
+  v[2] = _mm512_shuffle_i32x4(t1, t3, 0x88);
+  v[3] = _mm512_shuffle_i32x4(t1, t3, 0xdd);
+}
+
+/* transpose 4x4 matrices of 64-bit values within each 256-bit half */
+static simd_avx512_ inline void
+avx512_transpose_epi64(__m512i* v)
+{
+  const __m512i lo = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+  const __m512i hi = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+  __m512i t0 = _mm512_unpacklo_epi64(v[0], v[1]);
+  __m512i t1 = _mm512_unpackhi_epi64(v[0], v[1]);
+  __m512i t2 = _mm512_unpacklo_epi64(v[2], v[3]);
+  __m512i t3 = _mm512_unpackhi_epi64(v[2], v[3]);
+  v[0] = _mm512_permutex2var_epi64(t0, lo, t2);
+  v[1] = _mm512_permutex2var_epi64(t1, lo, t3);
+  v[2] = _mm512_permutex2var_epi64(t0, hi, t2);
+  v[3] = _mm512_permutex2var_epi64(t1, hi, t3);
+}
+
+/* gather row y of planes z and z + 1 of 64-bit block into v[y] */
+static simd_avx512_ inline void
+avx512_rows_epi64(__m512i* v, const __m512i* q)
+{
+  __m512i a = q[0], b = q[1], c = q[2], d = q[3];
+  v[0] = _mm512_shuffle_i64x2(a, c, 0x44);
+  v[1] = _mm512_shuffle_i64x2(a, c, 0xee);
+  v[2] = _mm512_shuffle_i64x2(b, d, 0x44);
+  v[3] = _mm512_shuffle_i64x2(b, d, 0xee);
+}
+
+/* inverse of avx512_rows_epi64 */
+static simd_avx512_ inline void
+avx512_planes_epi64(__m512i* q, const __m512i* v)
+{
+  q[0] = _mm512_shuffle_i64x2(v[0], v[1], 0x44);
+  q[2] = _mm512_shuffle_i64x2(v[0], v[1], 0xee);
+  q[1] = _mm512_shuffle_i64x2(v[2], v[3], 0x44);
+  q[3] = _mm512_shuffle_i64x2(v[2], v[3], 0xee);
+}
+
+/* forward x, y, and z transforms of 4*4*4 block held in four registers,
+   one plane z each; v[y] holds row y of every plane in x and y */
+static simd_avx512_ inline void
+avx512_fwd_xyz_int32(int32* p)
+{
+  __m512i v[4];
+  uint i;
+  for (i = 0; i < 4; i++)
+    v[i] = _mm512_loadu_si512(p + 16 * i);
+  avx512_transpose_lanes(v);
+  avx512_transpose_epi32(v);
+  SIMD_FWD_LIFT(avx512_add32, avx512_sub32, avx512_sra32, v[0], v[1], v[2], v[3]);
+  avx512_transpose_epi32(v);
+  SIMD_FWD_LIFT(avx512_add32, avx512_sub32, avx512_sra32, v[0], v[1], v[2], v[3]);
+  avx512_transpose_lanes(v);
+  SIMD_FWD_LIFT(avx512_add32, avx512_sub32, avx512_sra32, v[0], v[1], v[2], v[3]);
+  for (i = 0; i < 4; i++)
+    _mm512_storeu_si512(p + 16 * i, v[i]);
+}
+
+/* inverse z, y, and x transforms of 4*4*4 block */
+static simd_avx512_ inline void
+avx512_inv_xyz_int32(int32* p)
+{
+  __m512i v[4];
+  uint i;
+  for (i = 0; i < 4; i++)
+    v[i] = _mm512_loadu_si512(p + 16 * i);
+  SIMD_INV_LIFT(avx512_add32, avx512_sub32, avx512_sra32, avx512_sla32, v[0], v[1], v[2], v[3]);
+  avx512_transpose_lanes(v);
+  SIMD_INV_LIFT(avx512_add32, avx512_sub32, avx512_sra32, avx512_sla32, v[0], v[1], v[2], v[3]);
+  avx512_transpose_epi32(v);
+  SIMD_INV_LIFT(avx512_add32, avx512_sub32, avx512_sra32, avx512_sla32, v[0], v[1], v[2], v[3]);
+  avx512_transpose_epi32(v);
+  avx512_transpose_lanes(v);
+  for (i = 0; i < 4; i++)
+    _mm512_storeu_si512(p + 16 * i, v[i]);
+}
+
+/* forward x, y, and z transforms of 4*4*4 block held in eight registers,
+   q[2 * z + h] holding rows 2 * h and 2 * h + 1 of plane z */
+static simd_avx512_ inline void
+avx512_fwd_xyz_int64(int64* p)
+{
+  __m512i q[8], v[4];
+  uint i;
+  for (i = 0; i < 8; i++)
+    q[i] = _mm512_loadu_si512(p + 8 * i);
+  for (i = 0; i < 8; i += 4) {
+    avx512_rows_epi64(v, q + i);
+    avx512_transpose_epi64(v);
+    SIMD_FWD_LIFT(avx512_add64, avx512_sub64, avx512_sra64, v[0], v[1], v[2], v[3]);
+    avx512_transpose_epi64(v);
+    SIMD_FWD_LIFT(avx512_add64, avx512_sub64, avx512_sra64, v[0], v[1], v[2], v[3]);
+    avx512_planes_epi64(q + i, v);
+  }
+  SIMD_FWD_LIFT(avx512_add64, avx512_sub64, avx512_sra64, q[0], q[2], q[4], q[6]);
+  SIMD_FWD_LIFT(avx512_add64, avx512_sub64, avx512_sra64, q[1], q[3], q[5], q[7]);
+  for (i = 0; i < 8; i++)
+    _mm512_storeu_si512(p + 8 * i, q[i]);
+}
+
+/* inverse z, y, and x transforms of 4*4*4 block */
+static simd_avx512_ inline void
+avx512_inv_xyz_int64(int64* p)
+{
+  __m512i q[8], v[4];
+  uint i;
+  for (i = 0; i < 8; i++)
+    q[i] = _mm512_loadu_si512(p + 8 * i);
+  SIMD_INV_LIFT(avx512_add64, avx512_sub64, avx512_sra64, avx512_sla64, q[0], q[2], q[4], q[6]);
+  SIMD_INV_LIFT(avx512_add64, avx512_sub64, avx512_sra64, avx512_sla64, q[1], q[3], q[5], q[7]);
+  for (i = 0; i < 8; i += 4) {
+    avx512_rows_epi64(v, q + i);
+    SIMD_INV_LIFT(avx512_add64, avx512_sub64, avx512_sra64, avx512_sla64, v[0], v[1], v[2], v[3]);
+    avx512_transpose_epi64(v);
+    SIMD_INV_LIFT(avx512_add64, avx512_sub64, avx512_sra64, avx512_sla64, v[0], v[1], v[2], v[3]);
+    avx512_transpose_epi64(v);
+    avx512_planes_epi64(q + i, v);
+  }
+  for (i = 0; i < 8; i++)
+    _mm512_storeu_si512(p + 8 * i, q[i]);
+}
+
+/* forward w transform of 4*4*4*4 block */
+static simd_avx512_ inline void
+avx512_fwd_w_int32(int32* p)
+{
+  __m512i v[4];
+  uint i, w;
+  for (i = 0; i < 64; i += 16) {
+    for (w = 0; w < 4; w++)
+      v[w] = _mm512_loadu_si512(p + 64 * w + i);
+    SIMD_FWD_LIFT(avx512_add32, avx512_sub32, avx512_sra32, v[0], v[1], v[2], v[3]);
+    for (w = 0; w < 4; w++)
+      _mm512_storeu_si512(p + 64 * w + i, v[w]);
+  }
+}
+
+/* inverse w transform of 4*4*4*4 block */
+static simd_avx512_ inline void
+avx512_inv_w_int32(int32* p)
+{
+  __m512i v[4];
+  uint i, w;
+  for (i = 0; i < 64; i += 16) {
+    for (w = 0; w < 4; w++)
+      v[w] = _mm512_loadu_si512(p + 64 * w + i);
+    SIMD_INV_LIFT(avx512_add32, avx512_sub32, avx512_sra32, avx512_sla32, v[0], v[1], v[2], v[3]);
+    for (w = 0; w < 4; w++)
+      _mm512_storeu_si512(p + 64 * w + i, v[w]);
+  }
+}
+
+/* forward w transform of 4*4*4*4 block */
+static simd_avx512_ inline void
+avx512_fwd_w_int64(int64* p)
+{
+  __m512i v[4];
+  uint i, w;
+  for (i = 0; i < 64; i += 8) {
+    for (w = 0; w < 4; w++)
+      v[w] = _mm512_loadu_si512(p + 64 * w + i);
+    SIMD_FWD_LIFT(avx512_add64, avx512_sub64, avx512_sra64, v[0], v[1], v[2], v[3]);
+    for (w = 0; w < 4; w++)
+      _mm512_storeu_si512(p + 64 * w + i, v[w]);
+  }
+}
+
+/* inverse w transform of 4*4*4*4 block */
+static simd_avx512_ inline void
+avx512_inv_w_int64(int64* p)
+{
+  __m512i v[4];
+  uint i, w;
+  for (i = 0; i < 64; i += 8) {
+    for (w = 0; w < 4; w++)
+      v[w] = _mm512_loadu_si512(p + 64 * w + i);
+    SIMD_INV_LIFT(avx512_add64, avx512_sub64, avx512_sra64, avx512_sla64, v[0], v[1], v[2], v[3]);
+    for (w = 0; w < 4; w++)
+      _mm512_storeu_si512(p + 64 * w + i, v[w]);
+  }
+}
+
+/* forward transform of batch of 8 64-bit blocks, one value of each per
+   vector; 32-bit batches fill only 256 bits and use AVX2 */
+static simd_avx512_ inline void
+avx512_fwd_batch_int64(int64* p, uint dims)
+{
+  uint size = 1u << (2 * dims);
+  uint i, k, s;
+  __m512i v[4];
+  for (s = 1; s < size; s *= 4)
+    for (i = 0; i < size; i++)
+      if (!(i & (3 * s))) {
+        for (k = 0; k < 4; k++)
+          v[k] = _mm512_loadu_si512(p + 8 * (i + k * s));
+        SIMD_FWD_LIFT(avx512_add64, avx512_sub64, avx512_sra64, v[0], v[1], v[2], v[3]);
+        for (k = 0; k < 4; k++)
+          _mm512_storeu_si512(p + 8 * (i + k * s), v[k]);
+      }
+}
+
+/* inverse transform of batch of 8 64-bit blocks */
+static simd_avx512_ inline void
+avx512_inv_batch_int64(int64* p, uint dims)
+{
+  uint size = 1u << (2 * dims);
+  uint i, k, s;
+  __m512i v[4];
+  for (s = size / 4; s; s /= 4)
+    for (i = 0; i < size; i++)
+      if (!(i & (3 * s))) {
+        for (k = 0; k < 4; k++)
+          v[k] = _mm512_loadu_si512(p + 8 * (i + k * s));
+        SIMD_INV_LIFT(avx512_add64, avx512_sub64, avx512_sra64, avx512_sla64, v[0], v[1], v[2], v[3]);
+        for (k = 0; k < 4; k++)
+          _mm512_storeu_si512(p + 8 * (i + k * s), v[k]);
+      }
+}
+
+/* bit planes (AVX2) -------------------------------------------------------*/
+
+/* shuffle grouping the bytes of four 32-bit values by significance */
+#define avx2_byte_shuffle() \
+  _mm256_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15, \
+                   0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15)
+
+/* convert 64 32-bit values to byte-planar layout, in which v[b] and
+   v[4 + b] hold byte b of values 0-31 and 32-63 in order */
+static simd_avx2_ inline void
+avx2_fwd_bytes_epi32(__m256i* v)
+{
+  const __m256i s = avx2_byte_shuffle();
+  const __m256i q = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  uint i;
+  for (i = 0; i < 8; i++)
+    v[i] = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v[i], s), q);
+  avx2_transpose_epi64(v);
+  avx2_transpose_epi64(v + 4);
+}
+
+/* convert byte-planar layout back to 64 32-bit values */
+static simd_avx2_ inline void
+avx2_inv_bytes_epi32(__m256i* v)
+{
+  const __m256i s = avx2_byte_shuffle();
+  const __m256i q = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  uint i;
+  avx2_transpose_epi64(v);
+  avx2_transpose_epi64(v + 4);
+  for (i = 0; i < 8; i++)
+    v[i] = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v[i], q), s);
+}
+
+/* extract bit planes #k, kmin <= k < shift + 32, from byte-planar values;
+   each plane is gathered from the byte sign bits and the bytes shifted */
+static simd_avx2_ inline void
+avx2_fwd_planes_epi32(uint64* plane, const __m256i* v, uint kmin, uint shift)
+{
+  uint b, t, k = shift + 32;
+  for (b = 4; b--;) {
+    __m256i lo = v[b];
+    __m256i hi = v[4 + b];
+    for (t = 0; t < 8; t++) {
+      if (k <= kmin)
+        return;
+      k--;
+      plane[k] = (uint64)(uint32)_mm256_movemask_epi8(lo) +
+                 ((uint64)(uint32)_mm256_movemask_epi8(hi) << 32);
+      lo = _mm256_add_epi8(lo, lo);
+      hi = _mm256_add_epi8(hi, hi);
+    }
+  }
+}
+
+/* spread 32-bit mask to 32 bytes of all ones or all zeros */
+static simd_avx2_ inline __m256i
+avx2_expand_mask(uint32 x)
+{
+  const __m256i s = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                     2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  const __m256i m = _mm256_set1_epi64x((int64)0x8040201008040201ull);
+  __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32((int)x), s);
+  return _mm256_cmpeq_epi8(_mm256_and_si256(v, m), m);
+}
+
+/* deposit bit planes #k, kmin <= k < shift + 32, into byte-planar values */
+static simd_avx2_ inline void
+avx2_inv_planes_epi32(__m256i* v, const uint64* plane, uint kmin, uint shift)
+{
+  uint b, t, k = shift + 32;
+  for (b = 4; b--;) {
+    __m256i lo = _mm256_setzero_si256();
+    __m256i hi = _mm256_setzero_si256();
+    if (k > kmin)
+      for (t = 0; t < 8; t++) {
+        uint64 x = --k < kmin ? 0 : plane[k];
+        lo = _mm256_sub_epi8(_mm256_add_epi8(lo, lo), avx2_expand_mask((uint32)x));
+        hi = _mm256_sub_epi8(_mm256_add_epi8(hi, hi), avx2_expand_mask((uint32)(x >> 32)));
+      }
+    else
+      k -= 8;
+    v[b] = lo;
+    v[4 + b] = hi;
+  }
+}
+
+/* transpose size = 16 or 64 32-bit values to bit planes */
+static simd_avx2_ inline void
+avx2_fwd_planes_uint32(uint64* plane, const uint32* data, uint size, uint kmin)
+{
+  __m256i v[8];
+  uint i;
+  for (i = 0; i < 8; i++)
+    v[i] = 8 * i < size ? _mm256_loadu_si256((const __m256i*)(data + 8 * i)) : _mm256_setzero_si256();
+  avx2_fwd_bytes_epi32(v);
+  avx2_fwd_planes_epi32(plane, v, kmin, 0);
+}
+
+/* transpose bit planes to size = 16 or 64 32-bit values */
+static simd_avx2_ inline void
+avx2_inv_planes_uint32(uint32* data, const uint64* plane, uint size, uint kmin)
+{
+  __m256i v[8];
+  uint i;
+  avx2_inv_planes_epi32(v, plane, kmin, 0);
+  avx2_inv_bytes_epi32(v);
+  for (i = 0; 8 * i < size; i++)
+    _mm256_storeu_si256((__m256i*)(data + 8 * i), v[i]);
+}
+
+/* transpose size = 16 or 64 64-bit values to bit planes; the low and high
+   halves are transposed separately */
+static simd_avx2_ inline void
+avx2_fwd_planes_uint64(uint64* plane, const uint64* data, uint size, uint kmin)
+{
+  const __m256i q = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  __m256i lo[8], hi[8];
+  uint i;
+  for (i = 0; i < 8; i++)
+    if (8 * i < size) {
+      __m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(data + 8 * i + 0)), q);
+      __m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(data + 8 * i + 4)), q);
+      lo[i] = _mm256_permute2x128_si256(a, b, 0x20);
+      hi[i] = _mm256_permute2x128_si256(a, b, 0x31);
+    }
+    else
+      lo[i] = hi[i] = _mm256_setzero_si256();
+  avx2_fwd_bytes_epi32(hi);
+  avx2_fwd_planes_epi32(plane, hi, kmin, 32);
+  if (kmin < 32) {
+    avx2_fwd_bytes_epi32(lo);
+    avx2_fwd_planes_epi32(plane, lo, kmin, 0);
+  }
+}
+
+/* transpose bit planes to size = 16 or 64 64-bit values */
+static simd_avx2_ inline void
+avx2_inv_planes_uint64(uint64* data, const uint64* plane, uint size, uint kmin)
+{
+  const __m256i q = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  __m256i lo[8], hi[8];
+  uint i;
+  avx2_inv_planes_epi32(lo, plane, kmin, 0);
+  avx2_inv_planes_epi32(hi, plane, kmin, 32);
+  avx2_inv_bytes_epi32(lo);
+  avx2_inv_bytes_epi32(hi);
+  for (i = 0; 8 * i < size; i++) {
+    __m256i a = _mm256_permute2x128_si256(lo[i], hi[i], 0x20);
+    __m256i b = _mm256_permute2x128_si256(lo[i], hi[i], 0x31);
+    _mm256_storeu_si256((__m256i*)(data + 8 * i + 0), _mm256_permutevar8x32_epi32(a, q));
+    _mm256_storeu_si256((__m256i*)(data + 8 * i + 4), _mm256_permutevar8x32_epi32(b, q));
+  }
+}
+
+/* dispatch -----------------------------------------------------------------*/
+
+/* forward decorrelating transform of 3D or 4D block (false if not done) */
+static inline zfp_bool
+simd_fwd_xform_int32(int32* p, uint dims)
+{
+  uint w;
+  switch (simd_level()) {
+    case ZFP_SIMD_AVX512:
+      for (w = 0; w < (dims == 4 ? 4u : 1u); w++)
+        avx512_fwd_xyz_int32(p + 64 * w);
+      if (dims == 4)
+        avx512_fwd_w_int32(p);
+      return zfp_true;
+    case ZFP_SIMD_AVX2:
+      for (w = 0; w < (dims == 4 ? 4u : 1u); w++)
+        avx2_fwd_xyz_int32(p + 64 * w);
+      if (dims == 4)
+        avx2_fwd_w_int32(p);
+      return zfp_true;
+    default:
+      return zfp_false;
+  }
+}
+
+static inline zfp_bool
+simd_fwd_xform_int64(int64* p, uint dims)
+{
+  uint w;
+  switch (simd_level()) {
+    case ZFP_SIMD_AVX512:
+      for (w = 0; w < (dims == 4 ? 4u : 1u); w++)
+        avx512_fwd_xyz_int64(p + 64 * w);
+      if (dims == 4)
+        avx512_fwd_w_int64(p);
+      return zfp_true;
+    case ZFP_SIMD_AVX2:
+      for (w = 0; w < (dims == 4 ? 4u : 1u); w++)
+        avx2_fwd_xyz_int64(p + 64 * w);
+      if (dims == 4)
+        avx2_fwd_w_int64(p);
+      return zfp_true;
+    default:
+      return zfp_false;
+  }
+}
+
+/* inverse decorrelating transform of 3D or 4D block (false if not done) */
+static inline zfp_bool
+simd_inv_xform_int32(int32* p, uint dims)
+{
+  uint w;
+  switch (simd_level()) {
+    case ZFP_SIMD_AVX512:
+      if (dims == 4)
+        avx512_inv_w_int32(p);
+      for (w = 0; w < (dims == 4 ? 4u : 1u); w++)
+        avx512_inv_xyz_int32(p + 64 * w);
+      return zfp_true;
+    case ZFP_SIMD_AVX2:
+      if (dims == 4)
+        avx2_inv_w_int32(p);
+      for (w = 0; w < (dims == 4 ? 4u : 1u); w++)
+        avx2_inv_xyz_int32(p + 64 * w);
+      return zfp_true;
+    default:
+      return zfp_false;
+  }
+}
+
+static inline zfp_bool
+simd_inv_xform_int64(int64* p, uint dims)
+{
+  uint w;
+  switch (simd_level()) {
+    case ZFP_SIMD_AVX512:
+      if (dims == 4)
+        avx512_inv_w_int64(p);
+      for (w = 0; w < (dims == 4 ? 4u : 1u); w++)
+        avx512_inv_xyz_int64(p + 64 * w);
+      return zfp_true;
+    case ZFP_SIMD_AVX2:
+      if (dims == 4)
+        avx2_inv_w_int64(p);
+      for (w = 0; w < (dims == 4 ? 4u : 1u); w++)
+        avx2_inv_xyz_int64(p + 64 * w);
+      return zfp_true;
+    default:
+      return zfp_false;
+  }
+}
+
+/* forward decorrelating transform of batch of blocks (false if not done) */
+static inline zfp_bool
+simd_fwd_xform_batch_int32(int32* p, uint dims)
+{
+#if ZFP_BATCH_SIZE == 8
+  if (simd_level() >= ZFP_SIMD_AVX2) {
+    avx2_fwd_batch_int32(p, dims);
+    return zfp_true;
+  }
+#endif
+  return zfp_false;
+}
+
+static inline zfp_bool
+simd_fwd_xform_batch_int64(int64* p, uint dims)
+{
+#if ZFP_BATCH_SIZE == 8
+  switch (simd_level()) {
+    case ZFP_SIMD_AVX512:
+      avx512_fwd_batch_int64(p, dims);
+      return zfp_true;
+    case ZFP_SIMD_AVX2:
+      avx2_fwd_batch_int64(p, dims);
+      return zfp_true;
+  }
+#endif
+  return zfp_false;
+}
+
+/* inverse decorrelating transform of batch of blocks (false if not done) */
+static inline zfp_bool
+simd_inv_xform_batch_int32(int32* p, uint dims)
+{
+#if ZFP_BATCH_SIZE == 8
+  if (simd_level() >= ZFP_SIMD_AVX2) {
+    avx2_inv_batch_int32(p, dims);
+    return zfp_true;
+  }
+#endif
+  return zfp_false;
+}
+
+static inline zfp_bool
+simd_inv_xform_batch_int64(int64* p, uint dims)
+{
+#if ZFP_BATCH_SIZE == 8
+  switch (simd_level()) {
+    case ZFP_SIMD_AVX512:
+      avx512_inv_batch_int64(p, dims);
+      return zfp_true;
+    case ZFP_SIMD_AVX2:
+      avx2_inv_batch_int64(p, dims);
+      return zfp_true;
+  }
+#endif
+  return zfp_false;
+}
+
+/* true if bit planes of size unsigned integers can be transposed */
+static inline zfp_bool
+simd_planes(uint size)
+{
+  return simd_level() >= ZFP_SIMD_AVX2 && (size == 16 || size == 64);
+}
+
+/* transpose unsigned integers to bit planes #k, kmin <= k < 32 */
+static inline void
+simd_fwd_planes_uint32(uint64* plane, const uint32* data, uint size, uint kmin)
+{
+  avx2_fwd_planes_uint32(plane, data, size, kmin);
+}
+
+/* transpose unsigned integers to bit planes #k, kmin <= k < 64 */
+static inline void
+simd_fwd_planes_uint64(uint64* plane, const uint64* data, uint size, uint kmin)
+{
+  avx2_fwd_planes_uint64(plane, data, size, kmin);
+}
+
+/* transpose bit planes #k, kmin <= k < 32, to unsigned integers */
+static inline void
+simd_inv_planes_uint32(uint32* data, const uint64* plane, uint size, uint kmin)
+{
+  avx2_inv_planes_uint32(data, plane, size, kmin);
+}
+
+/* transpose bit planes #k, kmin <= k < 64, to unsigned integers */
+static inline void
+simd_inv_planes_uint64(uint64* data, const uint64* plane, uint size, uint kmin)
+{
+  avx2_inv_planes_uint64(data, plane, size, kmin);
+}
+
+#endif
+
+#endif
@@ -1,3 +1,10 @@
+#if defined(__unix__) || defined(__APPLE__)
+  /* mmap, posix_madvise, pread, and pwrite are POSIX.1-2008 */
+  #ifndef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200809L
+  #endif
+#endif
+
 #include <limits.h>
 #include <math.h>
 #include <stdio.h>
@@ -8,6 +15,13 @@
 #include "zfp/version.h"
 #include "template/template.h"
 
+#ifdef ZFP_BLOCKS_FILE_IO
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 /* public data ------------------------------------------------------------- */
 
 const uint zfp_codec_version = ZFP_CODEC;
@@ -49,6 +63,7 @@ is_reversible(const zfp_stream *zfp)
 
 #include "share/parallel.c"
 #include "share/omp.c"
+#include "share/threads.c"
 
 /* template instantiation of integer and float compressor -------------------*/
 
@@ -56,6 +71,9 @@ is_reversible(const zfp_stream *zfp)
 #include "template/compress.c"
 #include "template/decompress.c"
 #include "template/ompcompress.c"
+#include "template/ompdecompress.c"
+#include "template/threadcompress.c"
+#include "template/threaddecompress.c"
 #include "template/cudacompress.c"
 #include "template/cudadecompress.c"
 #undef Scalar
@@ -64,6 +82,9 @@ is_reversible(const zfp_stream *zfp)
 #include "template/compress.c"
 #include "template/decompress.c"
 #include "template/ompcompress.c"
+#include "template/ompdecompress.c"
+#include "template/threadcompress.c"
+#include "template/threaddecompress.c"
 #include "template/cudacompress.c"
 #include "template/cudadecompress.c"
 #undef Scalar
@@ -72,6 +93,9 @@ is_reversible(const zfp_stream *zfp)
 #include "template/compress.c"
 #include "template/decompress.c"
 #include "template/ompcompress.c"
+#include "template/ompdecompress.c"
+#include "template/threadcompress.c"
+#include "template/threaddecompress.c"
 #include "template/cudacompress.c"
 #include "template/cudadecompress.c"
 #undef Scalar
@@ -80,6 +104,9 @@ is_reversible(const zfp_stream *zfp)
 #include "template/compress.c"
 #include "template/decompress.c"
 #include "template/ompcompress.c"
+#include "template/ompdecompress.c"
+#include "template/threadcompress.c"
+#include "template/threaddecompress.c"
 #include "template/cudacompress.c"
 #include "template/cudadecompress.c"
 #undef Scalar
@@ -119,12 +146,19 @@ zfp_chunk_alloc(void)
 zfp_blocks *zfp_blocks_alloc(void)
 {
   zfp_blocks *blocks = (zfp_blocks *)malloc(sizeof(zfp_blocks));
+  /*unused axes have no chunks, so headers do not depend on heap contents*/
+  blocks->bx = blocks->by = blocks->bz = blocks->bw = 0;
   blocks->nbeg = 0;
   blocks->begs = 0;
+  blocks->costs = 0;
+  blocks->nbusy = 0;
+  blocks->busy = 0;
+  blocks->stats = 0;
+  blocks->affinity = 0;
   return blocks;
 }
 
-zfp_streams *zfp_streams_alloc(const int nstreams)
+zfp_streams *zfp_streams_alloc(const size_t nstreams)
 {
   zfp_streams *zstreams = (zfp_streams *)malloc(sizeof(zfp_streams));
   zstreams->streams = (zfp_stream **)malloc(nstreams * sizeof(zfp_stream *));
@@ -138,6 +172,27 @@ void zfp_alloc_nblocks(zfp_blocks *blocks, const size_t nblock)
   blocks->begs = (size_t *)malloc(sizeof(size_t) * (1 + blocks->nbeg));
 }
 
+void zfp_blocks_enable_stats(zfp_blocks *blocks)
+{
+  free(blocks->stats);
+  blocks->stats = (double *)malloc(3 * blocks->nbeg * sizeof(double));
+}
+
+size_t zfp_blocks_chunks_in_range(const zfp_blocks *blocks, const double lo, const double hi, size_t *ichunks)
+{
+  size_t count = 0;
+  for (size_t ichunk = 0; ichunk < blocks->nbeg; ichunk++)
+  {
+    const double *stats = blocks->stats + 3 * ichunk;
+    if (blocks->stats && (stats[1] < lo || stats[0] > hi))
+      continue;
+    if (ichunks)
+      ichunks[count] = ichunk;
+    count++;
+  }
+  return count;
+}
+
 zfp_blocks *zfp_blocks_alloc_beg(const size_t nchunks, const size_t *begs)
 {
   zfp_blocks *blocks = zfp_blocks_alloc();
@@ -146,12 +201,12 @@ zfp_blocks *zfp_blocks_alloc_beg(const size_t nchunks, const size_t *begs)
   return blocks;
 }
 zfp_chunks *
-zfp_chunks_alloc(const int nchunks)
+zfp_chunks_alloc(const size_t nchunks)
 {
   zfp_chunks *chunks = (zfp_chunks *)malloc(sizeof(zfp_chunks));
   chunks->nchunks = nchunks;
   chunks->chunks = (zfp_chunk **)malloc(nchunks * sizeof(zfp_chunk *));
-  for (int i = 0; i < nchunks; i++)
+  for (size_t i = 0; i < nchunks; i++)
     chunks->chunks[i] = zfp_chunk_alloc();
 
   return chunks;
@@ -242,12 +297,15 @@ void zfp_blocks_free(zfp_blocks *blocks)
   {
     free(blocks->begs);
   }
+  free(blocks->costs);
+  free(blocks->busy);
+  free(blocks->stats);
   free(blocks);
 }
 
 void zfp_chunks_free(zfp_chunks *chunks)
 {
-  for (int i = 0; i < chunks->nchunks; i++)
+  for (size_t i = 0; i < chunks->nchunks; i++)
     zfp_chunk_free(chunks->chunks[i]);
   free(chunks->chunks);
   free(chunks);
@@ -568,16 +626,16 @@ zfp_field_set_metadata(zfp_field *field, uint64 meta)
   return zfp_true;
 }
 /*public function to break into blocks*/
-zfp_blocks *zfp_break_into_blocks(const int ndim, const int *nsize, const int storage_per_block, const int elem_size,
+zfp_blocks *zfp_break_into_blocks(const int ndim, const size_t *nsize, const int storage_per_block, const int elem_size,
                                   const float est_compression_rate, const int method)
 {
   float approx_block_size = storage_per_block / (powf(2., (float)ndim) / est_compression_rate * elem_size);
   return zfp_optimal_parts_from_size(ndim, nsize, approx_block_size, method);
 }
 
-int zfp_total_chunks(const int ndim, const zfp_blocks *blocks, int *nchunk_blocks)
+size_t zfp_total_chunks(const int ndim, const zfp_blocks *blocks, size_t *nchunk_blocks)
 {
-  int ntot = 1;
+  size_t ntot = 1;
   switch (ndim)
   {
   case 4:
@@ -601,18 +659,18 @@ int zfp_total_chunks(const int ndim, const zfp_blocks *blocks, int *nchunk_block
   }
   return ntot;
 }
-zfp_chunks *zfp_chunks_from_blocks(const int ndim, const int *nsize, const zfp_blocks *blocks)
+zfp_chunks *zfp_chunks_from_blocks(const int ndim, const size_t *nsize, const zfp_blocks *blocks)
 {
 
-  int nchunk_block[4] = {1, 1, 1, 1};
-  int nblocks = zfp_total_chunks(ndim, blocks, nchunk_block);
+  size_t nchunk_block[4] = {1, 1, 1, 1};
+  size_t nblocks = zfp_total_chunks(ndim, blocks, nchunk_block);
 
-  int **fwind = malloc(ndim * sizeof(int *));
-  int **ewind = malloc(ndim * sizeof(int *));
+  size_t **fwind = malloc(ndim * sizeof(size_t *));
+  size_t **ewind = malloc(ndim * sizeof(size_t *));
   for (int i = 0; i < ndim; i++)
   {
-    fwind[i] = (int *)malloc(nchunk_block[i] * sizeof(int));
-    ewind[i] = (int *)malloc(nchunk_block[i] * sizeof(int));
+    fwind[i] = (size_t *)malloc(nchunk_block[i] * sizeof(size_t));
+    ewind[i] = (size_t *)malloc(nchunk_block[i] * sizeof(size_t));
     zfp_break_axis(nsize[i], nchunk_block[i], fwind[i], ewind[i]);
   }
 
@@ -620,33 +678,33 @@ zfp_chunks *zfp_chunks_from_blocks(const int ndim, const int *nsize, const zfp_b
   switch (ndim)
   {
   case 1:
-    for (int i = 0; i < nblocks; i++)
+    for (size_t i = 0; i < nblocks; i++)
     {
       zfp_set_chunk_1d(chunks->chunks[i], fwind[0][i], ewind[0][i]);
     }
     break;
   case 2:
-    for (int i2 = 0, i = 0; i2 < nchunk_block[1]; i2++)
-      for (int i1 = 0; i1 < nchunk_block[0]; i1++, i++)
+    for (size_t i2 = 0, i = 0; i2 < nchunk_block[1]; i2++)
+      for (size_t i1 = 0; i1 < nchunk_block[0]; i1++, i++)
       {
         zfp_set_chunk_2d(chunks->chunks[i], fwind[0][i1],
                          fwind[1][i2], ewind[0][i1], ewind[1][i2]);
       }
     break;
   case 3:
-    for (int i3 = 0, i = 0; i3 < nchunk_block[2]; i3++)
-      for (int i2 = 0; i2 < nchunk_block[1]; i2++)
-        for (int i1 = 0; i1 < nchunk_block[0]; i1++, i++)
+    for (size_t i3 = 0, i = 0; i3 < nchunk_block[2]; i3++)
+      for (size_t i2 = 0; i2 < nchunk_block[1]; i2++)
+        for (size_t i1 = 0; i1 < nchunk_block[0]; i1++, i++)
         {
           zfp_set_chunk_3d(chunks->chunks[i], fwind[0][i1], fwind[1][i2],
                            fwind[2][i3], ewind[0][i1], ewind[1][i2], ewind[2][i3]);
         }
     break;
   case 4:
-    for (int i4 = 0, i = 0; i4 < nchunk_block[3]; i4++)
-      for (int i3 = 0; i3 < nchunk_block[2]; i3++)
-        for (int i2 = 0; i2 < nchunk_block[1]; i2++)
-          for (int i1 = 0; i1 < nchunk_block[0]; i1++, i++)
+    for (size_t i4 = 0, i = 0; i4 < nchunk_block[3]; i4++)
+      for (size_t i3 = 0; i3 < nchunk_block[2]; i3++)
+        for (size_t i2 = 0; i2 < nchunk_block[1]; i2++)
+          for (size_t i1 = 0; i1 < nchunk_block[0]; i1++, i++)
           {
             zfp_set_chunk_4d(chunks->chunks[i], fwind[0][i1], fwind[1][i2],
                              fwind[2][i3], fwind[3][i4], ewind[0][i1], ewind[1][i2], ewind[2][i3], ewind[3][i4]);
@@ -666,21 +724,52 @@ zfp_chunks *zfp_chunks_from_blocks(const int ndim, const int *nsize, const zfp_b
   return chunks;
 }
 
+/*chunk grid covering nblk zfp blocks per axis with cs blocks per chunk;
+  zfp_break_axis places chunk boundaries on multiples of 4, so no chunk
+  splits a zfp block*/
+static zfp_blocks *zfp_parts_from_shape(zfp_blocks *zfp_b, const int ndim, const size_t *nblk, const size_t *cs)
+{
+  // chunks per axis, rounded up in exact integer arithmetic
+  size_t nc = 1;
+  switch (ndim)
+  {
+  case 4:
+    zfp_b->bw = (nblk[3] + cs[3] - 1) / cs[3];
+    nc *= zfp_b->bw;
+  case 3:
+    zfp_b->bz = (nblk[2] + cs[2] - 1) / cs[2];
+    nc *= zfp_b->bz;
+  case 2:
+    zfp_b->by = (nblk[1] + cs[1] - 1) / cs[1];
+    nc *= zfp_b->by;
+  case 1:
+    zfp_b->bx = (nblk[0] + cs[0] - 1) / cs[0];
+    nc *= zfp_b->bx;
+    break;
+  }
+  zfp_b->nbeg = nc;
+  zfp_b->begs = (size_t *)malloc(sizeof(size_t) * (nc + 1));
+  return zfp_b;
+}
+
 zfp_blocks *zfp_optimal_parts_from_size(const int ndim,               /*dimension*/
-                                        const int *n,                 /*elements in each dimension*/
+                                        const size_t *n,              /*elements in each dimension*/
                                         const float chunks_per_block, /*Approximate chunks in each block*/
                                         const int method              /*Method (1-cache, 2-equal) */
 )
 {
-  int nchunk[4] = {1, 1, 1, 1};
-  int chunck_size_out[4];
+  size_t nchunk[4] = {1, 1, 1, 1};
+  size_t chunck_size_out[4];
   int smallest_to_largest[4];
-  int ntemp[4];
+  size_t ntemp[4];
   size_t ntot = 1;
   zfp_blocks *zfp_b = zfp_blocks_alloc();
-  for (int i = 0; i < ndim; i++)
+  /*unused dimensions hold a single block and sort first*/
+  for (int i = 0; i < 4; i++)
   {
-    ntemp[i] = nchunk[i] = (int)((n[i] + 3) / 4);
+    if (i < ndim)
+      nchunk[i] = (n[i] + 3) / 4;
+    ntemp[i] = nchunk[i];
     chunck_size_out[i] = 1;
     smallest_to_largest[i] = i;
     ntot *= (size_t)nchunk[i];
@@ -711,22 +800,22 @@ zfp_blocks *zfp_optimal_parts_from_size(const int ndim,               /*dimensio
       if (ntemp[i] > ntemp[j])
       {
         // Swap numbers
-        int temp = ntemp[i];
+        size_t temp = ntemp[i];
         ntemp[i] = ntemp[j];
         ntemp[j] = temp;
 
         // Swap corresponding indices
-        temp = smallest_to_largest[i];
+        int itemp = smallest_to_largest[i];
         smallest_to_largest[i] = smallest_to_largest[j];
-        smallest_to_largest[j] = temp;
+        smallest_to_largest[j] = itemp;
       }
     }
   }
 
-  if (method == ZFP_BEST_CACHE)
+  if ((method & ~ZFP_BLOCKS_FLAGS) == ZFP_BEST_CACHE)
   {
     int found = 0;
-    int cur_chunk = 1;
+    size_t cur_chunk = 1;
     int idim = 0;
     while (idim < 4 && found == 0)
     {
@@ -734,7 +823,7 @@ zfp_blocks *zfp_optimal_parts_from_size(const int ndim,               /*dimensio
       if (chunck_size_out[idim] * cur_chunk > chunks_per_block)
       {
         found = 1;
-        chunck_size_out[idim] = (int)(chunks_per_block / cur_chunk);
+        chunck_size_out[idim] = (size_t)(chunks_per_block / cur_chunk);
       }
       else
       {
@@ -743,7 +832,7 @@ zfp_blocks *zfp_optimal_parts_from_size(const int ndim,               /*dimensio
       idim += 1;
     }
   }
-  else if (method == ZFP_MAKE_EQUAL)
+  else if ((method & ~ZFP_BLOCKS_FLAGS) == ZFP_MAKE_EQUAL)
   {
     int found = 0;
     int i = 0;
@@ -755,13 +844,16 @@ zfp_blocks *zfp_optimal_parts_from_size(const int ndim,               /*dimensio
       {
         chunck_size_out[smallest_to_largest[i]] = nchunk[smallest_to_largest[i]];
         block_left /= nchunk[smallest_to_largest[i]];
+        i += 1;
       }
       else
         found = 1;
     }
     for (int j = i; j < 4; j++)
     {
-      int sq_size = (int)(powf(block_left, 1. / (float)(4 - j)));
+      size_t sq_size = (size_t)(powf(block_left, 1. / (float)(4 - j)));
+      if (sq_size < 1)
+        sq_size = 1;
       chunck_size_out[smallest_to_largest[j]] = sq_size;
       block_left /= sq_size;
     }
@@ -771,44 +863,115 @@ zfp_blocks *zfp_optimal_parts_from_size(const int ndim,               /*dimensio
     return zfp_b;
   }
 
-  int nc = 1;
-  switch (ndim)
+  return zfp_parts_from_shape(zfp_b, ndim, nchunk, chunck_size_out);
+}
+
+int zfp_field_to_n(const zfp_field *field, size_t *n)
+{
+  int ndims;
+  n[0] = field->nx;
+  if (field->ny != 0)
   {
-  case 4:
-    zfp_b->bw = ceil((float)((int)(n[3] + 3) / 4) / (float)chunck_size_out[3]);
-    nc *= zfp_b->bw;
-  case 3:
-    zfp_b->bz = ceil((float)((int)(n[2] + 3) / 4) / (float)chunck_size_out[2]);
-    nc *= zfp_b->bz;
-  case 2:
-    zfp_b->by = ceil((float)((int)(n[1] + 3) / 4) / (float)chunck_size_out[1]);
-    nc *= zfp_b->by;
-  case 1:
-    zfp_b->bx = ceil((float)((int)(n[0] + 3) / 4) / (float)chunck_size_out[0]);
-    nc *= zfp_b->bx;
-    break;
+    n[1] = field->ny;
+    if (field->nz != 0)
+    {
+      n[2] = field->nz;
+      if (field->nw != 0)
+      {
+        n[3] = field->nw;
+        ndims = 4;
+      }
+      else
+        ndims = 3;
+    }
+    else
+      ndims = 2;
   }
-  zfp_b->nbeg = nc;
-  zfp_b->begs = (size_t *)malloc(sizeof(size_t) * (nc + 1));
-  return zfp_b;
+  else
+    ndims = 1;
+  return ndims;
+}
+
+/*chunks in best-cache order of axes, holding about target zfp blocks each*/
+static void zfp_shape_for_target(const int ndim, const size_t *nblk, const int *order, const size_t target, size_t *cs)
+{
+  size_t cur = 1;
+  for (int i = 0; i < ndim; i++)
+  {
+    int axis = order[i];
+    cs[axis] = 1;
+    if (cur >= target)
+      continue;
+    cs[axis] = target / cur < nblk[axis] ? target / cur : nblk[axis];
+    cur *= cs[axis];
+  }
+}
+
+/*blocks per chunk and axis order balancing nthreads within cache_bytes*/
+static size_t zfp_threads_target(const zfp_field *field, const int nthreads, const size_t cache_bytes, int *order)
+{
+  size_t n[4], dist[4];
+  ptrdiff_t strides[4];
+  int ndim = zfp_field_to_n(field, n);
+  size_t total = 1;
+  zfp_field_stride(field, strides);
+  for (int i = 0; i < ndim; i++)
+  {
+    total *= (n[i] + 3) / 4;
+    order[i] = i;
+    dist[i] = (size_t)(strides[i] < 0 ? -strides[i] : strides[i]);
+  }
+
+  // grow chunks along the axes with the smallest strides first
+  for (int i = 1; i < ndim; i++)
+    for (int j = i; j > 0 && dist[order[j]] < dist[order[j - 1]]; j--)
+    {
+      int t = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = t;
+    }
+
+  // values read with a non-unit stride each cost a cache line
+  size_t line = 64;
+  size_t elem = zfp_type_size(field->type);
+  size_t step = dist[order[0]] * elem;
+  size_t bytes = step == elem ? elem : (step < line ? step : line);
+  size_t cache = cache_bytes ? cache_bytes : ZFP_DEFAULT_CACHE_BYTES;
+  size_t fit = cache / (bytes << (2 * ndim));
+
+  // several chunks per thread so dynamic scheduling can balance them
+  size_t share = total / (4 * (size_t)(nthreads > 0 ? nthreads : 1));
+  size_t target = fit < share ? fit : share;
+  return target < 1 ? 1 : target;
+}
+
+zfp_blocks *zfp_optimal_parts_for_threads(const zfp_field *field, const int nthreads, const size_t cache_bytes)
+{
+  size_t n[4], nblk[4], cs[4];
+  int order[4];
+  int ndim = zfp_field_to_n(field, n);
+  for (int i = 0; i < ndim; i++)
+    nblk[i] = (n[i] + 3) / 4;
+  size_t target = zfp_threads_target(field, nthreads, cache_bytes, order);
+  zfp_shape_for_target(ndim, nblk, order, target, cs);
+  return zfp_parts_from_shape(zfp_blocks_alloc(), ndim, nblk, cs);
 }
 
-int zfp_break_axis(const int n, const int nparts, int *fwind, int *ewind)
+int zfp_break_axis(const size_t n, const size_t nparts, size_t *fwind, size_t *ewind)
 {
 
-  int nchunk = (int)((n + 3) / 4);
+  size_t nchunk = (n + 3) / 4;
 
-  int ndone = 0;
-  int nleft = nchunk;
-  for (int i = 0; i < nparts; i++)
+  size_t ndone = 0;
+  size_t nleft = nchunk;
+  for (size_t i = 0; i < nparts; i++)
   {
-    int my_part = (int)((float)nleft / (float)(nparts - i));
+    size_t my_part = nleft / (nparts - i);
     fwind[i] = ndone * 4;
     ewind[i] = my_part * 4 + fwind[i];
     ndone += my_part;
     nleft -= my_part;
   }
-  int nmissing = 4 * nparts - n;
   ewind[nparts - 1] = n;
   return 0;
 }
@@ -1112,7 +1275,7 @@ zfp_stream_maximum_size_chunk(const zfp_stream *zfp, const zfp_field *field, con
 }
 size_t zfp_stream_maximum_size_blocks(const zfp_stream *zfp, const zfp_field *field, const zfp_blocks *blocks)
 {
-  return 64 * blocks->nbeg + zfp_stream_maximum_size(zfp, field);
+  return (blocks->stats ? 88 : 64) * blocks->nbeg + zfp_stream_maximum_size(zfp, field);
 }
 size_t
 zfp_stream_maximum_size(const zfp_stream *zfp, const zfp_field *field)
@@ -1330,6 +1493,56 @@ uint zfp_stream_omp_chunk_size(const zfp_stream *zfp)
   return 0u;
 }
 
+uint64 *zfp_stream_omp_index(const zfp_stream *zfp)
+{
+  if (zfp->exec.policy == zfp_exec_omp)
+    return ((zfp_exec_params_omp *)zfp->exec.params)->index;
+  return NULL;
+}
+
+size_t zfp_stream_omp_index_size(const zfp_stream *zfp)
+{
+  if (zfp->exec.policy == zfp_exec_omp)
+    return ((zfp_exec_params_omp *)zfp->exec.params)->index_size;
+  return 0;
+}
+
+size_t zfp_stream_omp_chunks(const zfp_stream *zfp, const zfp_field *field)
+{
+#ifdef _OPENMP
+  size_t bx = (field->nx + 3) / 4;
+  size_t by = field->ny ? (field->ny + 3) / 4 : 1;
+  size_t bz = field->nz ? (field->nz + 3) / 4 : 1;
+  size_t bw = field->nw ? (field->nw + 3) / 4 : 1;
+  return chunk_count_omp(zfp, bx * by * bz * bw, thread_count_omp(zfp));
+#else
+  (void)zfp;
+  (void)field;
+  return 0;
+#endif
+}
+
+uint zfp_stream_threads(const zfp_stream *zfp)
+{
+  if (zfp->exec.policy == zfp_exec_threads)
+    return ((zfp_exec_params_threads *)zfp->exec.params)->threads;
+  return 0u;
+}
+
+uint64 *zfp_stream_threads_index(const zfp_stream *zfp)
+{
+  if (zfp->exec.policy == zfp_exec_threads)
+    return ((zfp_exec_params_threads *)zfp->exec.params)->index;
+  return NULL;
+}
+
+size_t zfp_stream_threads_index_size(const zfp_stream *zfp)
+{
+  if (zfp->exec.policy == zfp_exec_threads)
+    return ((zfp_exec_params_threads *)zfp->exec.params)->index_size;
+  return 0;
+}
+
 zfp_bool
 zfp_stream_set_execution(zfp_stream *zfp, zfp_exec_policy policy)
 {
@@ -1362,6 +1575,26 @@ zfp_stream_set_execution(zfp_stream *zfp, zfp_exec_policy policy)
       zfp_exec_params_omp *params = malloc(sizeof(zfp_exec_params_omp));
       params->threads = 0;
       params->chunk_size = 0;
+      params->index = NULL;
+      params->index_size = 0;
+      zfp->exec.params = (void *)params;
+    }
+    break;
+#else
+    return zfp_false;
+#endif
+  case zfp_exec_threads:
+#ifdef ZFP_WITH_THREADS
+    if (zfp->exec.policy != policy)
+    {
+      zfp_exec_params_threads *params = malloc(sizeof(zfp_exec_params_threads));
+      if (!params)
+        return zfp_false;
+      if (zfp->exec.params != NULL)
+        free(zfp->exec.params);
+      params->threads = 0;
+      params->index = NULL;
+      params->index_size = 0;
       zfp->exec.params = (void *)params;
     }
     break;
@@ -1393,6 +1626,43 @@ zfp_stream_set_omp_chunk_size(zfp_stream *zfp, uint chunk_size)
   return zfp_true;
 }
 
+zfp_bool
+zfp_stream_set_omp_index(zfp_stream *zfp, uint64 *index, size_t size)
+{
+  zfp_exec_params_omp *params;
+  if (index && (size < 2 || size - 1 > INT_MAX))
+    return zfp_false;
+  if (!zfp_stream_set_execution(zfp, zfp_exec_omp))
+    return zfp_false;
+  params = (zfp_exec_params_omp *)zfp->exec.params;
+  params->index = index;
+  params->index_size = index ? size : 0;
+  return zfp_true;
+}
+
+zfp_bool
+zfp_stream_set_threads(zfp_stream *zfp, uint threads)
+{
+  if (!zfp_stream_set_execution(zfp, zfp_exec_threads))
+    return zfp_false;
+  ((zfp_exec_params_threads *)zfp->exec.params)->threads = threads;
+  return zfp_true;
+}
+
+zfp_bool
+zfp_stream_set_threads_index(zfp_stream *zfp, uint64 *index, size_t size)
+{
+  zfp_exec_params_threads *params;
+  if (index && size < 2)
+    return zfp_false;
+  if (!zfp_stream_set_execution(zfp, zfp_exec_threads))
+    return zfp_false;
+  params = (zfp_exec_params_threads *)zfp->exec.params;
+  params->index = index;
+  params->index_size = index ? size : 0;
+  return zfp_true;
+}
+
 /* public functions: utility functions --------------------------------------*/
 
 void zfp_promote_int8_to_int32(int32 *oblock, const int8 *iblock, uint dims)
@@ -1468,21 +1738,16 @@ void zfp_demote_int32_to_uint16(uint16 *oblock, const int32 *iblock, uint dims)
 size_t
 zfp_compress(zfp_stream *zfp, const zfp_field *field)
 {
-  zfp_chunk *chunk = (zfp_chunk *)malloc(sizeof(zfp_chunk));
-  chunk->ez = field->nz;
-  chunk->ey = field->ny;
-  chunk->ex = field->nx;
-  chunk->ew = field->nw;
-  chunk->fx = 0;
-  chunk->fy = 0;
-  chunk->fz = 0;
-  chunk->fw = 0;
-  size_t header_loc = stream_wtell(zfp->stream);
-  size_t sz = zfp_compress_chunk(zfp, chunk, field);
-  size_t end_loc = stream_wtell(zfp->stream);
-
-  free(chunk);
-  return sz;
+  zfp_chunk chunk;
+  chunk.ez = field->nz;
+  chunk.ey = field->ny;
+  chunk.ex = field->nx;
+  chunk.ew = field->nw;
+  chunk.fx = 0;
+  chunk.fy = 0;
+  chunk.fz = 0;
+  chunk.fw = 0;
+  return zfp_compress_chunk(zfp, &chunk, field);
 }
 
 size_t
@@ -1510,7 +1775,7 @@ zfp_compress_chunk(zfp_stream *zfp, const zfp_chunk *chunk, const zfp_field *fie
 size_t zfp_compress_call(zfp_stream *zfp, const zfp_chunk *chunk, const zfp_field *field, const uint exec, const uint strided, const uint dims, const uint type)
 {
   /* function table [execution][strided][dimensionality][scalar type] */
-  void (*ftable[3][2][4][4])(zfp_stream *, const zfp_chunk *chunk, const zfp_field *) = {
+  void (*ftable[4][2][4][4])(zfp_stream *, const zfp_chunk *chunk, const zfp_field *) = {
       /* serial */
       {{{compress_int32_1, compress_int64_1, compress_float_1, compress_double_1},
         {compress_strided_int32_2, compress_strided_int64_2, compress_strided_float_2, compress_strided_double_2},
@@ -1548,6 +1813,20 @@ size_t zfp_compress_call(zfp_stream *zfp, const zfp_chunk *chunk, const zfp_fiel
 #else
       {{{NULL}}},
 #endif
+
+  /* thread pool */
+#ifdef ZFP_WITH_THREADS
+      {{{compress_strided_threads_int32_1, compress_strided_threads_int64_1, compress_strided_threads_float_1, compress_strided_threads_double_1},
+        {compress_strided_threads_int32_2, compress_strided_threads_int64_2, compress_strided_threads_float_2, compress_strided_threads_double_2},
+        {compress_strided_threads_int32_3, compress_strided_threads_int64_3, compress_strided_threads_float_3, compress_strided_threads_double_3},
+        {compress_strided_threads_int32_4, compress_strided_threads_int64_4, compress_strided_threads_float_4, compress_strided_threads_double_4}},
+       {{compress_strided_threads_int32_1, compress_strided_threads_int64_1, compress_strided_threads_float_1, compress_strided_threads_double_1},
+        {compress_strided_threads_int32_2, compress_strided_threads_int64_2, compress_strided_threads_float_2, compress_strided_threads_double_2},
+        {compress_strided_threads_int32_3, compress_strided_threads_int64_3, compress_strided_threads_float_3, compress_strided_threads_double_3},
+        {compress_strided_threads_int32_4, compress_strided_threads_int64_4, compress_strided_threads_float_4, compress_strided_threads_double_4}}},
+#else
+      {{{NULL}}},
+#endif
   };
   void (*compress)(zfp_stream *, const zfp_chunk *chunk, const zfp_field *);
 
@@ -1566,19 +1845,16 @@ size_t zfp_compress_call(zfp_stream *zfp, const zfp_chunk *chunk, const zfp_fiel
 size_t
 zfp_decompress(zfp_stream *zfp, zfp_field *field)
 {
-
-  zfp_chunk *chunk = (zfp_chunk *)malloc(sizeof(zfp_chunk));
-  chunk->ez = field->nz;
-  chunk->ey = field->ny;
-  chunk->ex = field->nx;
-  chunk->ew = field->nw;
-  chunk->fx = 0;
-  chunk->fy = 0;
-  chunk->fz = 0;
-  chunk->fw = 0;
-  size_t ret = zfp_decompress_chunk(zfp, chunk, field);
-  free(chunk);
-  return ret;
+  zfp_chunk chunk;
+  chunk.ez = field->nz;
+  chunk.ey = field->ny;
+  chunk.ex = field->nx;
+  chunk.ew = field->nw;
+  chunk.fx = 0;
+  chunk.fy = 0;
+  chunk.fz = 0;
+  chunk.fw = 0;
+  return zfp_decompress_chunk(zfp, &chunk, field);
 }
 
 size_t
@@ -1609,7 +1885,7 @@ zfp_decompress_call(zfp_stream *zfp, const zfp_chunk *chunk, zfp_field *field, c
   void (*decompress)(zfp_stream *, const zfp_chunk *, zfp_field *);
 
   /* function table [execution][strided][dimensionality][scalar type] */
-  void (*ftable[3][2][4][4])(zfp_stream *, const zfp_chunk *chunk, zfp_field *) = {
+  void (*ftable[4][2][4][4])(zfp_stream *, const zfp_chunk *chunk, zfp_field *) = {
       /* serial */
       {{{decompress_int32_1, decompress_int64_1, decompress_float_1, decompress_double_1},
         {decompress_strided_int32_2, decompress_strided_int64_2, decompress_strided_float_2, decompress_strided_double_2},
@@ -1620,8 +1896,19 @@ zfp_decompress_call(zfp_stream *zfp, const zfp_chunk *chunk, zfp_field *field, c
         {decompress_strided_int32_3, decompress_strided_int64_3, decompress_strided_float_3, decompress_strided_double_3},
         {decompress_strided_int32_4, decompress_strided_int64_4, decompress_strided_float_4, decompress_strided_double_4}}},
 
-      /* OpenMP; not yet supported */
+      /* OpenMP */
+#ifdef _OPENMP
+      {{{decompress_omp_int32_1, decompress_omp_int64_1, decompress_omp_float_1, decompress_omp_double_1},
+        {decompress_strided_omp_int32_2, decompress_strided_omp_int64_2, decompress_strided_omp_float_2, decompress_strided_omp_double_2},
+        {decompress_strided_omp_int32_3, decompress_strided_omp_int64_3, decompress_strided_omp_float_3, decompress_strided_omp_double_3},
+        {decompress_strided_omp_int32_4, decompress_strided_omp_int64_4, decompress_strided_omp_float_4, decompress_strided_omp_double_4}},
+       {{decompress_strided_omp_int32_1, decompress_strided_omp_int64_1, decompress_strided_omp_float_1, decompress_strided_omp_double_1},
+        {decompress_strided_omp_int32_2, decompress_strided_omp_int64_2, decompress_strided_omp_float_2, decompress_strided_omp_double_2},
+        {decompress_strided_omp_int32_3, decompress_strided_omp_int64_3, decompress_strided_omp_float_3, decompress_strided_omp_double_3},
+        {decompress_strided_omp_int32_4, decompress_strided_omp_int64_4, decompress_strided_omp_float_4, decompress_strided_omp_double_4}}},
+#else
       {{{NULL}}},
+#endif
 
   /* CUDA */
 #ifdef ZFP_WITH_CUDA
@@ -1636,6 +1923,20 @@ zfp_decompress_call(zfp_stream *zfp, const zfp_chunk *chunk, zfp_field *field, c
 #else
       {{{NULL}}},
 #endif
+
+  /* thread pool */
+#ifdef ZFP_WITH_THREADS
+      {{{decompress_strided_threads_int32_1, decompress_strided_threads_int64_1, decompress_strided_threads_float_1, decompress_strided_threads_double_1},
+        {decompress_strided_threads_int32_2, decompress_strided_threads_int64_2, decompress_strided_threads_float_2, decompress_strided_threads_double_2},
+        {decompress_strided_threads_int32_3, decompress_strided_threads_int64_3, decompress_strided_threads_float_3, decompress_strided_threads_double_3},
+        {decompress_strided_threads_int32_4, decompress_strided_threads_int64_4, decompress_strided_threads_float_4, decompress_strided_threads_double_4}},
+       {{decompress_strided_threads_int32_1, decompress_strided_threads_int64_1, decompress_strided_threads_float_1, decompress_strided_threads_double_1},
+        {decompress_strided_threads_int32_2, decompress_strided_threads_int64_2, decompress_strided_threads_float_2, decompress_strided_threads_double_2},
+        {decompress_strided_threads_int32_3, decompress_strided_threads_int64_3, decompress_strided_threads_float_3, decompress_strided_threads_double_3},
+        {decompress_strided_threads_int32_4, decompress_strided_threads_int64_4, decompress_strided_threads_float_4, decompress_strided_threads_double_4}}},
+#else
+      {{{NULL}}},
+#endif
   };
 
   decompress = ftable[exec][strided][dims - 1][type - zfp_type_int32];
@@ -1652,7 +1953,6 @@ zfp_write_blocks_header(zfp_stream *zfp, const zfp_field *field, const zfp_block
 {
 
   size_t bits = 0;
-  uint64 meta = 0;
 
   stream_write_bits(zfp->stream, 'z', 8);
   stream_write_bits(zfp->stream, 'f', 8);
@@ -1660,41 +1960,49 @@ zfp_write_blocks_header(zfp_stream *zfp, const zfp_field *field, const zfp_block
   stream_write_bits(zfp->stream, zfp_codec_version, 8);
   bits += ZFP_MAGIC_BITS;
 
+  // version byte is distinguished from the scalar type of 32-bit headers
+  uint version = ZFP_BLOCKS_HEADER_VERSIONED | ZFP_BLOCKS_HEADER_VERSION;
+  if (blocks->stats)
+    version |= ZFP_BLOCKS_HEADER_STATS;
+  stream_write_bits(zfp->stream, version, 8);
   stream_write_bits(zfp->stream, (uint64)field->type, 8);
-  stream_write_bits(zfp->stream, (uint64)field->nx, 32);
-  stream_write_bits(zfp->stream, (uint64)field->ny, 32);
-  stream_write_bits(zfp->stream, (uint64)field->nz, 32);
-  stream_write_bits(zfp->stream, (uint64)field->nw, 32);
-  bits += 136;
-
-  uint64 mode = zfp_stream_mode(zfp);
-
-  uint size = mode > ZFP_MODE_SHORT_MAX ? ZFP_MODE_LONG_BITS : ZFP_MODE_SHORT_BITS;
-  size=64; 
-  stream_write_bits(zfp->stream, mode, size);
-  bits += size;
-
-
-
-
-  stream_write_bits(zfp->stream, (uint64)blocks->nbeg, 32);
-  stream_write_bits(zfp->stream, (uint64)blocks->bx, 32);
-  stream_write_bits(zfp->stream, (uint64)blocks->by, 32);
-  stream_write_bits(zfp->stream, (uint64)blocks->bz, 32);
-  stream_write_bits(zfp->stream, (uint64)blocks->bw, 32);
-  bits+= 160;
-
-  bits += 64 * (blocks->nbeg + 1)+56 ; /*put it on 64-bit word boundary*/;
+  stream_write_bits(zfp->stream, (uint64)field->nx, 64);
+  stream_write_bits(zfp->stream, (uint64)field->ny, 64);
+  stream_write_bits(zfp->stream, (uint64)field->nz, 64);
+  stream_write_bits(zfp->stream, (uint64)field->nw, 64);
+  bits += 272;
+
+  stream_write_bits(zfp->stream, zfp_stream_mode(zfp), ZFP_MODE_LONG_BITS);
+  bits += ZFP_MODE_LONG_BITS;
+
+  stream_write_bits(zfp->stream, (uint64)blocks->nbeg, 64);
+  stream_write_bits(zfp->stream, (uint64)blocks->bx, 64);
+  stream_write_bits(zfp->stream, (uint64)blocks->by, 64);
+  stream_write_bits(zfp->stream, (uint64)blocks->bz, 64);
+  stream_write_bits(zfp->stream, (uint64)blocks->bw, 64);
+  bits += 320;
+
+  bits += 64 * (blocks->nbeg + 1) + 16; /*put it on 64-bit word boundary*/
+  if (blocks->stats)
+    bits += 3 * 64 * blocks->nbeg;
 
   size_t use_offset = 0;
   if (begs_after_header == 1)
     use_offset = bits;
-  for (int i = 0; i < blocks->nbeg + 1; i++)
+  for (size_t i = 0; i < blocks->nbeg + 1; i++)
   {
     stream_write_bits(zfp->stream, (uint64)(use_offset + blocks->begs[i]), 64);
 
   }
 
+  // min, max and mean of each chunk follow begs as raw doubles
+  for (size_t i = 0; blocks->stats && i < 3 * blocks->nbeg; i++)
+  {
+    uint64 value;
+    memcpy(&value, blocks->stats + i, sizeof(value));
+    stream_write_bits(zfp->stream, value, 64);
+  }
+
   stream_flush(zfp->stream);
 
   return bits;
@@ -1744,7 +2052,9 @@ zfp_write_header(zfp_stream *zfp, const zfp_field *field, uint mask)
   return bits;
 }
 
-size_t zfp_read_blocks_header(zfp_stream *zfp, zfp_field *field, zfp_blocks *blocks)
+/*read block header up to begs, noting whether stats follow them; returns
+  its length in bits (0 upon failure)*/
+static size_t zfp_read_blocks_fixed(zfp_stream *zfp, zfp_field *field, zfp_blocks *blocks, int *stats)
 {
 
   size_t bits = 0;
@@ -1757,40 +2067,96 @@ size_t zfp_read_blocks_header(zfp_stream *zfp, zfp_field *field, zfp_blocks *blo
 
   bits += ZFP_MAGIC_BITS;
 
-  field->type = stream_read_bits(zfp->stream, 8);
-  field->nx = stream_read_bits(zfp->stream, 32);
-  field->ny = stream_read_bits(zfp->stream, 32);
-  field->nz = stream_read_bits(zfp->stream, 32);
-  field->nw = stream_read_bits(zfp->stream, 32);
-  bits += 136;
+  // 32-bit headers have the scalar type where versioned ones have a version
+  uint version = (uint)stream_read_bits(zfp->stream, 8);
+  uint width = 32;
+  bits += 8;
+  if (version & ZFP_BLOCKS_HEADER_VERSIONED)
+  {
+    if ((version & ~(ZFP_BLOCKS_HEADER_VERSIONED | ZFP_BLOCKS_HEADER_STATS)) != ZFP_BLOCKS_HEADER_VERSION)
+      return 0;
+    field->type = stream_read_bits(zfp->stream, 8);
+    width = 64;
+    bits += 8;
+  }
+  else
+    field->type = version;
+  field->nx = stream_read_bits(zfp->stream, width);
+  field->ny = stream_read_bits(zfp->stream, width);
+  field->nz = stream_read_bits(zfp->stream, width);
+  field->nw = stream_read_bits(zfp->stream, width);
+  bits += 4 * width;
 
 
-  uint64 mode = stream_read_bits(zfp->stream,64);
-  bits += 64;
+  uint64 mode = stream_read_bits(zfp->stream, ZFP_MODE_LONG_BITS);
+  bits += ZFP_MODE_LONG_BITS;
  
  
   if (zfp_stream_set_mode(zfp, mode) == zfp_mode_null)
     return 0;
 
-  // uint64 meta = stream_read_bits(zfp->stream, ZFP_META_BITS);
-  blocks->nbeg = stream_read_bits(zfp->stream, 32);
-  blocks->bx = stream_read_bits(zfp->stream, 32);
-  blocks->by = stream_read_bits(zfp->stream, 32);
-  blocks->bz = stream_read_bits(zfp->stream, 32);
-  blocks->bw = stream_read_bits(zfp->stream, 32);
-  bits += 160;
+  blocks->nbeg = stream_read_bits(zfp->stream, width);
+  blocks->bx = stream_read_bits(zfp->stream, width);
+  blocks->by = stream_read_bits(zfp->stream, width);
+  blocks->bz = stream_read_bits(zfp->stream, width);
+  blocks->bw = stream_read_bits(zfp->stream, width);
+  bits += 5 * width;
+  *stats = (version & ZFP_BLOCKS_HEADER_VERSIONED) && (version & ZFP_BLOCKS_HEADER_STATS);
+
+  return bits;
+}
+
+/*read min, max and mean of each chunk stored as raw doubles*/
+static void zfp_read_blocks_stats(bitstream *stream, zfp_blocks *blocks)
+{
+  for (size_t i = 0; i < 3 * blocks->nbeg; i++)
+  {
+    uint64 value = stream_read_bits(stream, 64);
+    memcpy(blocks->stats + i, &value, sizeof(value));
+  }
+}
+
+size_t zfp_read_blocks_header(zfp_stream *zfp, zfp_field *field, zfp_blocks *blocks)
+{
 
+  bitstream_offset start = stream_rtell(zfp->stream);
+  int stats;
+  size_t bits = zfp_read_blocks_fixed(zfp, field, blocks, &stats);
+  if (!bits)
+    return 0;
+  free(blocks->stats);
+  blocks->stats = NULL;
+  if (stats)
+    zfp_blocks_enable_stats(blocks);
 
   blocks->begs = (size_t *)malloc(sizeof(size_t) * (blocks->nbeg + 1));
-  for (int i = 0; i < blocks->nbeg + 1; i++)
+  for (size_t i = 0; i < blocks->nbeg + 1; i++)
   {
 
     blocks->begs[i] = stream_read_bits(zfp->stream, 64);
   }
 
   bits += 64 * (blocks->nbeg + 1);
+  if (blocks->stats)
+  {
+    zfp_read_blocks_stats(zfp->stream, blocks);
+    bits += 3 * 64 * blocks->nbeg;
+  }
+
+  // streamed output stores stats and begs after the chunks, at the end of the stream
+  if (blocks->begs[0] == ZFP_BLOCKS_BEGS_TRAILER)
+  {
+    size_t stats = blocks->stats ? 3 * 64 * blocks->nbeg : 0;
+    stream_rseek(zfp->stream, CHAR_BIT * stream_capacity(zfp->stream) - 64 * (blocks->nbeg + 1) - stats);
+    if (blocks->stats)
+      zfp_read_blocks_stats(zfp->stream, blocks);
+    for (size_t i = 0; i < blocks->nbeg + 1; i++)
+      blocks->begs[i] = stream_read_bits(zfp->stream, 64);
+  }
 
-    stream_rseek(zfp->stream,bits+56);
+  /*header ends on 64-bit word boundary*/
+  bits = (bits + 63) & ~(size_t)63;
+  stream_rseek(zfp->stream, start + bits);
 
 
   return bits;
@@ -1839,12 +2205,12 @@ zfp_read_header(zfp_stream *zfp, zfp_field *field, uint mask)
   return bits;
 }
 
-void zfp_set_chunk_1d(zfp_chunk *chunk, const int fx, const int ex)
+void zfp_set_chunk_1d(zfp_chunk *chunk, const size_t fx, const size_t ex)
 {
   chunk->ex = ex;
   chunk->fx = fx;
 }
-void zfp_set_chunk_2d(zfp_chunk *chunk, const int fx, const int fy, const int ex, const int ey)
+void zfp_set_chunk_2d(zfp_chunk *chunk, const size_t fx, const size_t fy, const size_t ex, const size_t ey)
 {
 
   chunk->ey = ey;
@@ -1852,7 +2218,7 @@ void zfp_set_chunk_2d(zfp_chunk *chunk, const int fx, const int fy, const int ex
   chunk->fy = fy;
   chunk->fx = fx;
 }
-void zfp_set_chunk_3d(zfp_chunk *chunk, const int fx, const int fy, const int fz, const int ex, const int ey, const int ez)
+void zfp_set_chunk_3d(zfp_chunk *chunk, const size_t fx, const size_t fy, const size_t fz, const size_t ex, const size_t ey, const size_t ez)
 {
 
   chunk->ez = ez;
@@ -1862,7 +2228,7 @@ void zfp_set_chunk_3d(zfp_chunk *chunk, const int fx, const int fy, const int fz
   chunk->fy = fy;
   chunk->fx = fx;
 }
-void zfp_set_chunk_4d(zfp_chunk *chunk, const int fx, const int fy, const int fz, const int fw, const int ex, const int ey, const int ez, const int ew)
+void zfp_set_chunk_4d(zfp_chunk *chunk, const size_t fx, const size_t fy, const size_t fz, const size_t fw, const size_t ex, const size_t ey, const size_t ez, const size_t ew)
 {
   chunk->ew = ew;
   chunk->ez = ez;
@@ -1877,14 +2243,22 @@ void zfp_set_chunk_4d(zfp_chunk *chunk, const int fx, const int fy, const int fz
 #ifdef _OPENMP
 #include <omp.h>
 
+/*apply the flags or-ed into a partition method*/
+static void zfp_blocks_set_flags(zfp_blocks *blocks, const int method)
+{
+  if (method & ZFP_BLOCKS_STATS)
+    zfp_blocks_enable_stats(blocks);
+  blocks->affinity = method & (ZFP_BLOCKS_NUMA | ZFP_BLOCKS_PIN);
+}
+
 zfp_streams *zfp_create_streams(const zfp_stream *zfp_in,
-                                const int nblocks,              /*number of blocks*/
+                                const size_t nblocks,           /*number of blocks*/
                                 const size_t *blocks_boundaries /*block boundaries*/
 )
 {
   zfp_streams *zstreams = zfp_streams_alloc(nblocks);
 #pragma omp parallel for
-  for (int ichunk = 0; ichunk < nblocks; ichunk++)
+  for (size_t ichunk = 0; ichunk < nblocks; ichunk++)
   {
     stream_rewind(zfp_in->stream);
     bitstream *loc_stream = stream_open((uchar *)stream_data(zfp_in->stream) + blocks_boundaries[ichunk] / 8,
@@ -1902,7 +2276,7 @@ zfp_streams *zfp_create_streams(const zfp_stream *zfp_in,
 void zfp_streams_free(zfp_streams *zstreams)
 {
 
-  for (int i = 0; i < zstreams->nstreams; i++)
+  for (size_t i = 0; i < zstreams->nstreams; i++)
   {
     stream_close(zstreams->streams[i]->stream);
     zfp_stream_close(zstreams->streams[i]);
@@ -1911,73 +2285,475 @@ void zfp_streams_free(zfp_streams *zstreams)
   free(zstreams);
 }
 
-zfp_streams *zfp_blocks_portions(zfp_stream *stream, const zfp_field *field, const int nthreads, zfp_blocks *blocks,
-                                 size_t base_offset)
+typedef struct
 {
+  size_t cost;
+  size_t ichunk;
+} zfp_chunk_cost;
 
-  int nsize[4], block_size[4];
-  omp_set_num_threads(nthreads);
-  int ndims = zfp_field_to_n(field, nsize);
-  block_size[3] = blocks->bw;
-  block_size[2] = blocks->bz;
-  block_size[1] = blocks->by;
-  block_size[0] = blocks->bx;
-  zfp_chunks *chunks = zfp_chunks_from_blocks(ndims, nsize, blocks);
-  blocks->begs[0] = base_offset;
+static int zfp_chunk_cost_compare(const void *a, const void *b)
+{
+  const zfp_chunk_cost *ca = (const zfp_chunk_cost *)a;
+  const zfp_chunk_cost *cb = (const zfp_chunk_cost *)b;
+  if (ca->cost != cb->cost)
+    return ca->cost < cb->cost ? 1 : -1;
+  return ca->ichunk < cb->ichunk ? -1 : ca->ichunk > cb->ichunk;
+}
 
-  for (size_t i = 0; i < chunks->nchunks; i++){
-    blocks->begs[i + 1] = blocks->begs[i] + CHAR_BIT*zfp_stream_maximum_size_chunk(stream, field, chunks->chunks[i]);
+/*order chunks by decreasing cost so the most expensive ones are started first*/
+static size_t *zfp_chunks_by_cost(const size_t *cost, const size_t nchunks)
+{
+  zfp_chunk_cost *cc = (zfp_chunk_cost *)malloc(nchunks * sizeof(zfp_chunk_cost));
+  size_t *order = (size_t *)malloc(nchunks * sizeof(size_t));
+  for (size_t i = 0; i < nchunks; i++)
+  {
+    cc[i].cost = cost ? cost[i] : 0;
+    cc[i].ichunk = i;
   }
-  zfp_streams *zstreams = zfp_create_streams(stream, chunks->nchunks, blocks->begs);
-#pragma omp parallel for
-  for (int ichunk = 0; ichunk < chunks->nchunks; ichunk++)
+  if (cost)
+    qsort(cc, nchunks, sizeof(zfp_chunk_cost), zfp_chunk_cost_compare);
+  for (size_t i = 0; i < nchunks; i++)
+    order[i] = cc[i].ichunk;
+  free(cc);
+  return order;
+}
+
+/*first and one past last element of chunk in each of four dimensions*/
+static void zfp_chunk_bounds(const zfp_chunk *chunk, const int ndims, const size_t *n, size_t *f, size_t *e)
+{
+  const size_t cf[4] = {chunk->fx, chunk->fy, chunk->fz, chunk->fw};
+  const size_t ce[4] = {chunk->ex, chunk->ey, chunk->ez, chunk->ew};
+  for (int i = 0; i < 4; i++)
   {
-    zfp_compress_chunk(zstreams->streams[ichunk], chunks->chunks[ichunk], field);
+    f[i] = i < ndims ? cf[i] : 0;
+    e[i] = i < ndims ? (ce[i] < n[i] ? ce[i] : n[i]) : 1;
+  }
+}
 
-    stream_flush(zstreams->streams[ichunk]->stream);
+/*min, max and mean of the values of field within chunk*/
+static void zfp_chunk_stats(const zfp_field *field, const zfp_chunk *chunk, double *stats)
+{
+  size_t n[4], f[4], e[4];
+  ptrdiff_t s[4];
+  int ndims = zfp_field_to_n(field, n);
+  zfp_chunk_bounds(chunk, ndims, n, f, e);
+  zfp_field_stride(field, s);
+  double lo = HUGE_VAL, hi = -HUGE_VAL, sum = 0.;
+  size_t nx = e[0] - f[0];
+
+#define ZFP_ROW_STATS(T)                          \
+  {                                               \
+    const T *p = (const T *)field->data + offset; \
+    for (size_t x = 0; x < nx; x++, p += s[0])    \
+    {                                             \
+      double v = (double)*p;                      \
+      lo = v < lo ? v : lo;                       \
+      hi = v > hi ? v : hi;                       \
+      sum += v;                                   \
+    }                                             \
   }
+  for (size_t w = f[3]; w < e[3]; w++)
+    for (size_t z = f[2]; z < e[2]; z++)
+      for (size_t y = f[1]; y < e[1]; y++)
+      {
+        ptrdiff_t offset = s[0] * (ptrdiff_t)f[0] + s[1] * (ptrdiff_t)y + s[2] * (ptrdiff_t)z + s[3] * (ptrdiff_t)w;
+        switch (field->type)
+        {
+        case zfp_type_int32:
+          ZFP_ROW_STATS(int32)
+          break;
+        case zfp_type_int64:
+          ZFP_ROW_STATS(int64)
+          break;
+        case zfp_type_float:
+          ZFP_ROW_STATS(float)
+          break;
+        case zfp_type_double:
+          ZFP_ROW_STATS(double)
+          break;
+        default:
+          break;
+        }
+      }
+#undef ZFP_ROW_STATS
 
-  zfp_chunks_free(chunks);
-  return (zstreams);
+  size_t count = nx * (e[1] - f[1]) * (e[2] - f[2]) * (e[3] - f[3]);
+  stats[0] = lo;
+  stats[1] = hi;
+  stats[2] = count ? sum / count : 0.;
 }
 
-/* compress entire field (nonzero return value upon success) */
-size_t /* cumulative number of bytes of compressed storage */
-zfp_blocks_compress_internal(
-    zfp_stream *stream,     /* compressed stream */
-    const zfp_field *field, /* field metadata */
-    const int nthreads,     /*number of threads to use*/
-    zfp_blocks *blocks      /*size of parallel blocks*/
-)
+/*number of zfp blocks in chunk*/
+static size_t zfp_chunk_blocks(const int ndims, const zfp_chunk *chunk)
 {
-  zfp_streams *zstreams = zfp_blocks_portions(stream, field, nthreads, blocks, stream_wtell(stream->stream) / 8);
-  size_t offset = stream_wtell(stream->stream);
-  bitstream *dst = zfp_stream_bit_stream(stream);
-  // stream_rewind(dst);
+  size_t nblocks = (chunk->ex - chunk->fx + 3) / 4;
+  if (ndims > 1)
+    nblocks *= (chunk->ey - chunk->fy + 3) / 4;
+  if (ndims > 2)
+    nblocks *= (chunk->ez - chunk->fz + 3) / 4;
+  if (ndims > 3)
+    nblocks *= (chunk->ew - chunk->fw + 3) / 4;
+  return nblocks;
+}
 
-  for (size_t ichunk = 0; ichunk < blocks->nbeg; ichunk++)
-  {
-    bitstream_size bits = stream_wtell(zstreams->streams[ichunk]->stream);
-    blocks->begs[ichunk + 1] = blocks->begs[ichunk] + bits;
-  }
+/*center of chunk axis, at most two zfp blocks wide*/
+static void zfp_sample_axis(const size_t f, const size_t e, size_t *fs, size_t *es)
+{
+  size_t nb = (e - f + 3) / 4;
+  *fs = f + 4 * ((nb - 1) / 2);
+  *es = MIN(*fs + 8, e);
+}
 
-  /* flush each stream and concatenate if necessary */
+/*estimate cost of chunk by compressing a few blocks near its center*/
+static size_t zfp_chunk_sample_cost(const zfp_stream *stream, const zfp_field *field, const zfp_chunk *chunk)
+{
+  int ndims = (int)zfp_field_dimensionality(field);
+  zfp_chunk sample = *chunk;
+  zfp_field f = *field;
+  ptrdiff_t strides[4];
+  zfp_stream s = *stream;
 
-  for (size_t ichunk = 0; ichunk < blocks->nbeg; ichunk++)
-  {
+  zfp_sample_axis(chunk->fx, chunk->ex, &sample.fx, &sample.ex);
+  if (ndims > 1)
+    zfp_sample_axis(chunk->fy, chunk->ey, &sample.fy, &sample.ey);
+  if (ndims > 2)
+    zfp_sample_axis(chunk->fz, chunk->ez, &sample.fz, &sample.ez);
+  if (ndims > 3)
+    zfp_sample_axis(chunk->fw, chunk->ew, &sample.fw, &sample.ew);
 
-    bitstream_size bits = stream_wtell(zstreams->streams[ichunk]->stream);
-    offset += bits;
-    stream_flush(stream_data(zstreams->streams[ichunk]->stream));
-    stream_rewind(stream_data(zstreams->streams[ichunk]->stream));
-    stream_copy(dst, stream_data(zstreams->streams[ichunk]->stream), bits);
-    stream_close(stream_data(zstreams->streams[ichunk]->stream));
-    zfp_stream_close(zstreams->streams[ichunk]);
-  }
+  // explicit strides select the kernels that honor the chunk extents
+  zfp_field_stride(field, strides);
+  f.sx = strides[0];
+  f.sy = ndims > 1 ? strides[1] : 0;
+  f.sz = ndims > 2 ? strides[2] : 0;
+  f.sw = ndims > 3 ? strides[3] : 0;
 
-  zfp_streams_free(zstreams);
+  size_t bufsize = zfp_stream_maximum_size_chunk(stream, field, &sample);
+  void *buffer = malloc(bufsize);
+  s.stream = stream_open(buffer, bufsize);
+  s.exec.policy = zfp_exec_serial;
+  s.exec.params = NULL;
+  zfp_compress_chunk(&s, &sample, &f);
+  size_t bits = stream_wtell(s.stream);
+  stream_close(s.stream);
+  free(buffer);
 
-  return offset / 8;
+  size_t nsample = zfp_chunk_blocks(ndims, &sample);
+  return (bits * zfp_chunk_blocks(ndims, chunk) + nsample - 1) / nsample;
+}
+
+/*reset per-thread busy times*/
+static void zfp_blocks_busy_reset(zfp_blocks *blocks, const int nthreads)
+{
+  if (blocks->nbusy != nthreads)
+  {
+    free(blocks->busy);
+    blocks->busy = (double *)malloc(nthreads * sizeof(double));
+    blocks->nbusy = nthreads;
+  }
+  for (int i = 0; i < nthreads; i++)
+    blocks->busy[i] = 0.;
+}
+
+void zfp_blocks_costs_from_begs(zfp_blocks *blocks)
+{
+  free(blocks->costs);
+  blocks->costs = (size_t *)malloc(blocks->nbeg * sizeof(size_t));
+  for (size_t i = 0; i < blocks->nbeg; i++)
+    blocks->costs[i] = blocks->begs[i + 1] - blocks->begs[i];
+}
+
+double zfp_blocks_thread_busy(const zfp_blocks *blocks, const int ithread)
+{
+  if (ithread < 0 || ithread >= blocks->nbusy)
+    return 0.;
+  return blocks->busy[ithread];
+}
+
+zfp_blocks *zfp_autotune_parts(const zfp_stream *stream, const zfp_field *field, const int nthreads, const size_t cache_bytes)
+{
+  size_t n[4], nblk[4], cs[4], best[4];
+  ptrdiff_t strides[4] = {0, 0, 0, 0};
+  int order[4];
+  int ndim = zfp_field_to_n(field, n);
+  for (int i = 0; i < ndim; i++)
+    nblk[i] = (n[i] + 3) / 4;
+  size_t target = zfp_threads_target(field, nthreads, cache_bytes, order);
+  int slow = order[ndim - 1];
+
+  // candidates scale the cache- and thread-aware target up and down
+  size_t scale[5] = {1, 2, 4, 8, 16};
+  size_t thick = 1;
+  for (int k = 0; k < 5; k++)
+  {
+    zfp_shape_for_target(ndim, nblk, order, target * scale[k] / 4 ? target * scale[k] / 4 : 1, cs);
+    thick = cs[slow] > thick ? cs[slow] : thick;
+  }
+
+  // sample a leading slab of the slowest axis, at least one chunk thick
+  zfp_field sample = *field;
+  size_t sblk[4];
+  zfp_field_stride(field, strides);
+  sample.sx = strides[0];
+  sample.sy = strides[1];
+  sample.sz = strides[2];
+  sample.sw = strides[3];
+  memcpy(sblk, nblk, sizeof(sblk));
+  sblk[slow] = nblk[slow] / 8 > thick ? nblk[slow] / 8 : thick;
+  if (sblk[slow] < nblk[slow])
+  {
+    size_t *ns[4] = {&sample.nx, &sample.ny, &sample.nz, &sample.nw};
+    *ns[slow] = 4 * sblk[slow];
+  }
+  else
+    sblk[slow] = nblk[slow];
+
+  double fastest = -1.;
+  size_t prev[4] = {0, 0, 0, 0};
+  for (int k = 0; k < 5; k++)
+  {
+    // small targets can collapse to the same shape
+    zfp_shape_for_target(ndim, nblk, order, target * scale[k] / 4 ? target * scale[k] / 4 : 1, cs);
+    if (!memcmp(cs, prev, ndim * sizeof(size_t)))
+      continue;
+    memcpy(prev, cs, sizeof(prev));
+    zfp_blocks *blocks = zfp_parts_from_shape(zfp_blocks_alloc(), ndim, sblk, cs);
+    size_t bufsize = zfp_stream_maximum_size_blocks(stream, &sample, blocks);
+    void *buffer = malloc(bufsize);
+    bitstream *bs = stream_open(buffer, bufsize);
+    zfp_stream *zs = zfp_stream_open(bs);
+    zfp_stream_set_params(zs, stream->minbits, stream->maxbits, stream->maxprec, stream->minexp);
+
+    // best of two runs, so the first one can warm caches and threads
+    double seconds = -1.;
+    for (int run = 0; run < 2; run++)
+    {
+      stream_rewind(bs);
+      double start = omp_get_wtime();
+      zfp_blocks_compress_internal(zs, &sample, nthreads, blocks);
+      double t = omp_get_wtime() - start;
+      if (seconds < 0. || t < seconds)
+        seconds = t;
+    }
+    if (fastest < 0. || seconds < fastest)
+    {
+      fastest = seconds;
+      memcpy(best, cs, sizeof(best));
+    }
+
+    zfp_stream_close(zs);
+    stream_close(bs);
+    free(buffer);
+    zfp_blocks_free(blocks);
+  }
+
+  return zfp_parts_from_shape(zfp_blocks_alloc(), ndim, nblk, best);
+}
+
+/*length of the block header written for blocks, in bits*/
+static size_t zfp_blocks_header_bits(const zfp_blocks *blocks)
+{
+  size_t bits = ZFP_HEADER_BLOCKS_MAX_BITS + 64 * (blocks->nbeg + 1);
+  if (blocks->stats)
+    bits += 3 * 64 * blocks->nbeg;
+  return bits;
+}
+
+/*work done on one chunk by thread ithread*/
+typedef void (*zfp_chunk_task)(void *context, size_t ichunk, int ithread);
+
+/*split chunks into one run of consecutive chunks per thread, each covering
+  about the same number of blocks; consecutive chunks are slabs along the
+  slowest axis, so runs line up with a static first touch of the field*/
+static void zfp_chunk_runs(const zfp_chunks *chunks, const int ndims, const int nteam, size_t *first)
+{
+  size_t total = 0;
+  for (size_t ichunk = 0; ichunk < chunks->nchunks; ichunk++)
+    total += zfp_chunk_blocks(ndims, chunks->chunks[ichunk]);
+  size_t sum = 0, ichunk = 0;
+  first[0] = 0;
+  for (int ithread = 1; ithread < nteam; ithread++)
+  {
+    size_t goal = (size_t)((double)total * ithread / nteam);
+    while (ichunk < chunks->nchunks && sum < goal)
+      sum += zfp_chunk_blocks(ndims, chunks->chunks[ichunk++]);
+    first[ithread] = ichunk;
+  }
+  first[nteam] = chunks->nchunks;
+}
+
+/*body of zfp_chunks_by_thread, run by every thread of the team*/
+static void zfp_chunks_run(zfp_chunk_task task, void *context, const zfp_chunks *chunks, const int ndims, size_t *first)
+{
+#pragma omp single
+  zfp_chunk_runs(chunks, ndims, omp_get_num_threads(), first);
+  int ithread = omp_get_thread_num();
+  for (size_t ichunk = first[ithread]; ichunk < first[ithread + 1]; ichunk++)
+    task(context, ichunk, ithread);
+}
+
+/*run task on every chunk, each thread taking the same run of chunks on
+  every call so its output and input pages stay on its NUMA node; first
+  holds nteam + 1 entries*/
+static void zfp_chunks_by_thread(zfp_chunk_task task, void *context, const zfp_chunks *chunks, const int ndims,
+                                 const int nteam, const int pin, size_t *first)
+{
+  if (pin)
+  {
+#pragma omp parallel num_threads(nteam) proc_bind(spread)
+    zfp_chunks_run(task, context, chunks, ndims, first);
+  }
+  else
+  {
+#pragma omp parallel num_threads(nteam)
+    zfp_chunks_run(task, context, chunks, ndims, first);
+  }
+}
+
+/*chunks of a field being compressed into streams*/
+typedef struct
+{
+  zfp_streams *streams;
+  const zfp_chunks *chunks;
+  const zfp_field *field;
+  zfp_blocks *blocks;
+} zfp_portion;
+
+static void zfp_portion_compress(void *context, size_t ichunk, int ithread)
+{
+  zfp_portion *portion = (zfp_portion *)context;
+  zfp_stream *zs = portion->streams->streams[ichunk];
+  double start = omp_get_wtime();
+  zfp_compress_chunk(zs, portion->chunks->chunks[ichunk], portion->field);
+
+  stream_flush(zs->stream);
+  // chunk is still in cache, so its stats come almost for free
+  if (portion->blocks->stats)
+    zfp_chunk_stats(portion->field, portion->chunks->chunks[ichunk], portion->blocks->stats + 3 * ichunk);
+  portion->blocks->busy[ithread] += omp_get_wtime() - start;
+}
+
+zfp_streams *zfp_blocks_portions(zfp_stream *stream, const zfp_field *field, const int nthreads, zfp_blocks *blocks,
+                                 size_t base_offset)
+{
+
+  size_t nsize[4];
+  // team size is given per region so the caller's OpenMP setting is kept
+  int nteam = nthreads > 0 ? nthreads : omp_get_max_threads();
+  int ndims = zfp_field_to_n(field, nsize);
+  zfp_chunks *chunks = zfp_chunks_from_blocks(ndims, nsize, blocks);
+  blocks->begs[0] = base_offset;
+
+  for (size_t i = 0; i < chunks->nchunks; i++){
+    blocks->begs[i + 1] = blocks->begs[i] + CHAR_BIT*zfp_stream_maximum_size_chunk(stream, field, chunks->chunks[i]);
+  }
+  zfp_streams *zstreams = zfp_create_streams(stream, chunks->nchunks, blocks->begs);
+  zfp_portion portion = {zstreams, chunks, field, blocks};
+  zfp_blocks_busy_reset(blocks, nteam);
+
+  // each thread first touches, and so places, the slots of its own run
+  if (blocks->affinity & ZFP_BLOCKS_NUMA)
+  {
+    size_t *first = (size_t *)malloc((nteam + 1) * sizeof(size_t));
+    zfp_chunks_by_thread(zfp_portion_compress, &portion, chunks, ndims, nteam,
+                         blocks->affinity & ZFP_BLOCKS_PIN, first);
+    free(first);
+    zfp_chunks_free(chunks);
+    return zstreams;
+  }
+
+  // cost is taken from the caller, uniform in fixed-rate mode, or sampled
+  size_t *cost = blocks->costs;
+  if (!cost && stream->minbits != stream->maxbits)
+  {
+    cost = (size_t *)malloc(chunks->nchunks * sizeof(size_t));
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nteam)
+    for (size_t ichunk = 0; ichunk < chunks->nchunks; ichunk++)
+      cost[ichunk] = zfp_chunk_sample_cost(stream, field, chunks->chunks[ichunk]);
+  }
+  size_t *order = zfp_chunks_by_cost(cost, chunks->nchunks);
+  if (cost != blocks->costs)
+    free(cost);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nteam)
+  for (size_t i = 0; i < chunks->nchunks; i++)
+    zfp_portion_compress(&portion, order[i], omp_get_thread_num());
+
+  free(order);
+  zfp_chunks_free(chunks);
+  return (zstreams);
+}
+
+/*move word-aligned chunks from their worst-case slots to their final byte
+  offsets; chunks only move toward the front, so batches whose destinations
+  all end before the first source of the batch begins (or that stay in
+  place) can move in parallel*/
+static void zfp_blocks_pack(uchar *data, const size_t *src, const size_t *dst, const size_t *len, const size_t nchunks)
+{
+  size_t first = 0;
+  while (first < nchunks)
+  {
+    size_t last = first + 1;
+    while (last < nchunks && (dst[last] == src[last] || dst[last] + len[last] <= src[first]))
+      last++;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t ichunk = first; ichunk < last; ichunk++)
+      if (dst[ichunk] != src[ichunk])
+        memmove(data + dst[ichunk], data + src[ichunk], len[ichunk]);
+    first = last;
+  }
+}
+
+/*pack chunks compressed into zstreams so they follow offset bits of dst*/
+static size_t zfp_blocks_pack_streams(bitstream *dst, const zfp_streams *zstreams, size_t offset, size_t *begs)
+{
+  size_t nchunks = zstreams->nstreams;
+  uchar *data = (uchar *)stream_data(dst);
+  size_t *src = (size_t *)malloc(nchunks * sizeof(size_t));
+  size_t *pos = (size_t *)malloc(nchunks * sizeof(size_t));
+  size_t *len = (size_t *)malloc(nchunks * sizeof(size_t));
+
+  // each chunk stream was flushed, so chunks are whole words
+  for (size_t ichunk = 0; ichunk < nchunks; ichunk++)
+  {
+    bitstream *bs = zstreams->streams[ichunk]->stream;
+    src[ichunk] = (size_t)((uchar *)stream_data(bs) - data);
+    len[ichunk] = stream_wtell(bs) / CHAR_BIT;
+    pos[ichunk] = offset / CHAR_BIT;
+    if (begs)
+      begs[ichunk + 1] = begs[ichunk] + stream_wtell(bs);
+    offset += stream_wtell(bs);
+  }
+  zfp_blocks_pack(data, src, pos, len, nchunks);
+
+  free(src);
+  free(pos);
+  free(len);
+  stream_wseek(dst, offset);
+  return offset;
+}
+
+/* compress entire field (nonzero return value upon success) */
+size_t /* cumulative number of bytes of compressed storage */
+zfp_blocks_compress_internal(
+    zfp_stream *stream,     /* compressed stream */
+    const zfp_field *field, /* field metadata */
+    const int nthreads,     /*number of threads to use*/
+    zfp_blocks *blocks      /*size of parallel blocks*/
+)
+{
+  bitstream *dst = zfp_stream_bit_stream(stream);
+
+  // chunks start on a word boundary so they can be moved as whole words
+  stream_flush(dst);
+  size_t offset = stream_wtell(dst);
+  zfp_streams *zstreams = zfp_blocks_portions(stream, field, nthreads, blocks, offset);
+
+  offset = zfp_blocks_pack_streams(dst, zstreams, offset, blocks->begs);
+
+  zfp_streams_free(zstreams);
+
+  return offset / 8;
 }
 
 size_t /* cumulative number of bytes of compressed storage */
@@ -1985,22 +2761,36 @@ zfp_blocks_decompress(
     zfp_stream *stream,      /* compressed stream */
     zfp_field *field,        /* field metadata */
     const int nthreads,      /*number of threads to use*/
-    const zfp_blocks *blocks /*size of parallel blocks*/
+    zfp_blocks *blocks       /*size of parallel blocks*/
 )
 {
 
-  int nsize[4];
-  omp_set_num_threads(nthreads);
+  size_t nsize[4];
+  int nteam = nthreads > 0 ? nthreads : omp_get_max_threads();
   int ndims = zfp_field_to_n(field, nsize);
 
   zfp_chunks *chunks = zfp_chunks_from_blocks(ndims, nsize, blocks);
 
   zfp_streams *zstreams = zfp_create_streams(stream, chunks->nchunks, blocks->begs);
 
-#pragma omp parallel for
+  // compressed size of each chunk is a good proxy for its decoding cost
+  size_t *cost = (size_t *)malloc(chunks->nchunks * sizeof(size_t));
   for (size_t ichunk = 0; ichunk < chunks->nchunks; ichunk++)
+    cost[ichunk] = blocks->begs[ichunk + 1] - blocks->begs[ichunk];
+  size_t *order = zfp_chunks_by_cost(cost, chunks->nchunks);
+  free(cost);
+
+  zfp_blocks_busy_reset(blocks, nteam);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nteam)
+  for (size_t i = 0; i < chunks->nchunks; i++)
+  {
+    size_t ichunk = order[i];
+    double start = omp_get_wtime();
     zfp_decompress_chunk(zstreams->streams[ichunk], chunks->chunks[ichunk], field);
+    blocks->busy[omp_get_thread_num()] += omp_get_wtime() - start;
+  }
 
+  free(order);
   zfp_streams_free(zstreams);
   size_t val = blocks->begs[chunks->nchunks];
 
@@ -2009,31 +2799,6 @@ zfp_blocks_decompress(
   return val / 8;
 }
 
-int zfp_field_to_n(const zfp_field *field, int *n)
-{
-  int ndims;
-  n[0] = field->nx;
-  if (field->ny != 0)
-  {
-    n[1] = field->ny;
-    if (field->nz != 0)
-    {
-      n[2] = field->nz;
-      if (field->nw != 0)
-      {
-        n[3] = field->nw;
-        ndims = 4;
-      }
-      else
-        ndims = 3;
-    }
-    else
-      ndims = 2;
-  }
-  else
-    ndims = 1;
-  return ndims;
-}
 size_t zfp_blocks_compress_single_stream(
     zfp_stream *stream,           /* compressed stream */
     const zfp_field *field,       /* field metadata */
@@ -2046,24 +2811,136 @@ size_t zfp_blocks_compress_single_stream(
   zfp_streams *zstreams = zfp_blocks_compress(stream, field, 
        nthreads, blocks_per_chunk, method, 1);
   bitstream *dst = stream->stream;
-  size_t offset = stream_wtell(dst);
 
-  for (size_t ichunk = 0; ichunk < zstreams->nstreams; ichunk++)
-  {
-
-    //stream_flush(zstreams->streams[ichunk]->stream);
-    size_t bits = stream_wtell(zstreams->streams[ichunk]->stream);
-    stream_rewind(zstreams->streams[ichunk]->stream);
-    stream_copy(dst, zstreams->streams[ichunk]->stream, bits);
-    offset += bits;
-  }
- 
-  stream_wseek(dst, offset);
+  // header is flushed, so chunks follow it on a word boundary
+  size_t offset = zfp_blocks_pack_streams(dst, zstreams, stream_wtell(dst), NULL);
 
   zfp_streams_free(zstreams);
   return offset / 8;
 }
 
+/*hand bytes to sink, remembering any failure*/
+static void zfp_blocks_emit(zfp_blocks_sink sink, void *context, const void *data, size_t bytes, int *ok)
+{
+  if (*ok && sink(context, data, bytes) != bytes)
+    *ok = 0;
+}
+
+size_t zfp_blocks_compress_to_sink(
+    zfp_stream *stream,           /* compression parameters */
+    const zfp_field *field,       /* field metadata */
+    const int nthreads,           /*number of threads to use*/
+    const float blocks_per_chunk, /*number of blocks per chunk*/
+    const int method,             /*method for compression*/
+    zfp_blocks_sink sink,         /*destination of compressed bytes*/
+    void *context                 /*passed through to sink*/
+)
+{
+  size_t n[4];
+  int ndims = zfp_field_to_n(field, n);
+  zfp_blocks *zfp_b = zfp_optimal_parts_from_size(ndims, n, blocks_per_chunk, method);
+  zfp_chunks *chunks = zfp_chunks_from_blocks(ndims, n, zfp_b);
+  size_t nchunks = chunks->nchunks;
+  bitstream *saved = zfp_stream_bit_stream(stream);
+  int ok = 1;
+  zfp_blocks_set_flags(zfp_b, method);
+
+  // header carries placeholder begs and stats; the real tables are written last
+  size_t hbytes = zfp_blocks_header_bits(zfp_b) / CHAR_BIT;
+  void *header = malloc(hbytes);
+  bitstream *hs = stream_open(header, hbytes);
+  for (size_t i = 0; i < nchunks + 1; i++)
+    zfp_b->begs[i] = ZFP_BLOCKS_BEGS_TRAILER;
+  for (size_t i = 0; zfp_b->stats && i < 3 * nchunks; i++)
+    zfp_b->stats[i] = 0.;
+  zfp_stream_set_bit_stream(stream, hs);
+  zfp_write_blocks_header(stream, field, zfp_b, 0);
+  zfp_stream_set_bit_stream(stream, saved);
+  stream_close(hs);
+  zfp_blocks_emit(sink, context, header, hbytes, &ok);
+  free(header);
+
+  // ring of two halves, each holding a batch of worst-case sized chunks
+  size_t slot = 0;
+  for (size_t ichunk = 0; ichunk < nchunks; ichunk++)
+  {
+    size_t size = zfp_stream_maximum_size_chunk(stream, field, chunks->chunks[ichunk]);
+    if (size > slot)
+      slot = size;
+  }
+  slot = (slot + sizeof(uint64) - 1) / sizeof(uint64) * sizeof(uint64);
+  size_t nslot = 2 * (size_t)nthreads;
+  size_t nbatch = (nchunks + nslot - 1) / nslot;
+  uchar *ring = (uchar *)malloc(2 * nslot * slot);
+  size_t *len = (size_t *)malloc(2 * nslot * sizeof(size_t));
+
+  zfp_b->begs[0] = CHAR_BIT * hbytes;
+  omp_set_num_threads(nthreads);
+#pragma omp parallel
+  for (size_t batch = 0; batch <= nbatch; batch++)
+  {
+    // master emits the previous batch while the team compresses this one
+#pragma omp master
+    if (batch > 0)
+    {
+      size_t first = (batch - 1) * nslot;
+      size_t last = first + nslot < nchunks ? first + nslot : nchunks;
+      size_t half = ((batch - 1) % 2) * nslot;
+      for (size_t ichunk = first; ichunk < last; ichunk++)
+      {
+        size_t islot = half + ichunk - first;
+        zfp_b->begs[ichunk + 1] = zfp_b->begs[ichunk] + CHAR_BIT * len[islot];
+        zfp_blocks_emit(sink, context, ring + islot * slot, len[islot], &ok);
+      }
+    }
+    if (batch < nbatch)
+    {
+      size_t first = batch * nslot;
+      size_t last = first + nslot < nchunks ? first + nslot : nchunks;
+      size_t half = (batch % 2) * nslot;
+#pragma omp for schedule(dynamic, 1)
+      for (size_t ichunk = first; ichunk < last; ichunk++)
+      {
+        size_t islot = half + ichunk - first;
+        bitstream *bs = stream_open(ring + islot * slot, slot);
+        zfp_stream *zs = zfp_stream_open(bs);
+        zfp_stream_set_params(zs, stream->minbits, stream->maxbits, stream->maxprec, stream->minexp);
+        zfp_compress_chunk(zs, chunks->chunks[ichunk], field);
+        stream_flush(bs);
+        len[islot] = stream_wtell(bs) / CHAR_BIT;
+        if (zfp_b->stats)
+          zfp_chunk_stats(field, chunks->chunks[ichunk], zfp_b->stats + 3 * ichunk);
+        zfp_stream_close(zs);
+        stream_close(bs);
+      }
+    }
+  }
+  free(ring);
+  free(len);
+
+  // trailer holds any stats, then begs as absolute bit offsets, as in a single stream
+  size_t tbytes = (zfp_blocks_header_bits(zfp_b) - ZFP_HEADER_BLOCKS_MAX_BITS) / CHAR_BIT;
+  void *trailer = malloc(tbytes);
+  bitstream *ts = stream_open(trailer, tbytes);
+  for (size_t i = 0; zfp_b->stats && i < 3 * nchunks; i++)
+  {
+    uint64 value;
+    memcpy(&value, zfp_b->stats + i, sizeof(value));
+    stream_write_bits(ts, value, 64);
+  }
+  for (size_t i = 0; i < nchunks + 1; i++)
+    stream_write_bits(ts, (uint64)zfp_b->begs[i], 64);
+  stream_flush(ts);
+  stream_close(ts);
+  zfp_blocks_emit(sink, context, trailer, tbytes, &ok);
+  free(trailer);
+
+  size_t total = zfp_b->begs[nchunks] / CHAR_BIT + tbytes;
+  zfp_chunks_free(chunks);
+  zfp_blocks_free(zfp_b);
+  return ok ? total : 0;
+}
+
 zfp_streams *zfp_blocks_compress_multi(
     zfp_stream *stream,           /* compressed stream */
     const zfp_field *field,       /* field metadata */
@@ -2085,18 +2962,19 @@ zfp_streams *zfp_blocks_compress(
     const int begs_after_header   /*write blocks after header*/
 )
 {
-  int n[4], nblocks[4];
+  size_t n[4], nblocks[4];
   int ndims = zfp_field_to_n(field, n);
   zfp_blocks *zfp_b = zfp_optimal_parts_from_size(ndims, n, blocks_per_chunk, method);
+  zfp_blocks_set_flags(zfp_b, method);
 
-  int nchunks = zfp_total_chunks(ndims, zfp_b, nblocks);
+  zfp_total_chunks(ndims, zfp_b, nblocks);
   size_t bufsize = zfp_stream_maximum_size_blocks(stream, field, zfp_b);
 
   void *buffer = (void *)malloc(bufsize);
   bitstream *dst = stream_open(buffer, bufsize);
   zfp_stream_set_bit_stream(stream, dst);
 
-  zfp_streams *zstreams = zfp_blocks_portions(stream, field, nthreads, zfp_b, ZFP_HEADER_BLOCKS_MAX_BITS + (nchunks + 1) * 64);
+  zfp_streams *zstreams = zfp_blocks_portions(stream, field, nthreads, zfp_b, zfp_blocks_header_bits(zfp_b));
 
   zfp_b->begs[0] = 0;
   for (size_t ichunk = 0; ichunk < zfp_b->nbeg; ichunk++)
@@ -2113,6 +2991,198 @@ zfp_streams *zfp_blocks_compress(
   return zstreams;
 }
 
+/*field moved through a plan by one call*/
+typedef struct
+{
+  zfp_plan *plan;
+  zfp_field *field;
+} zfp_plan_call;
+
+static void zfp_plan_touch_chunk(void *context, size_t ichunk, int ithread)
+{
+  zfp_plan *plan = ((zfp_plan_call *)context)->plan;
+  size_t first = plan->slots[ichunk] / CHAR_BIT;
+  memset((uchar *)plan->buffer + first, 0, plan->slots[ichunk + 1] / CHAR_BIT - first);
+  (void)ithread;
+}
+
+static void zfp_plan_compress_chunk(void *context, size_t ichunk, int ithread)
+{
+  zfp_plan *plan = ((zfp_plan_call *)context)->plan;
+  zfp_field *field = ((zfp_plan_call *)context)->field;
+  zfp_stream *zs = plan->threads->streams[ithread];
+  size_t *len = plan->scratch + 2 * plan->chunks->nchunks;
+  double start = omp_get_wtime();
+  stream_wseek(zs->stream, plan->slots[ichunk]);
+  zfp_compress_chunk(zs, plan->chunks->chunks[ichunk], field);
+  len[ichunk] = (stream_wtell(zs->stream) - plan->slots[ichunk]) / CHAR_BIT;
+  if (plan->blocks->stats)
+    zfp_chunk_stats(field, plan->chunks->chunks[ichunk], plan->blocks->stats + 3 * ichunk);
+  plan->blocks->busy[ithread] += omp_get_wtime() - start;
+}
+
+static void zfp_plan_decompress_chunk(void *context, size_t ichunk, int ithread)
+{
+  zfp_plan *plan = ((zfp_plan_call *)context)->plan;
+  zfp_stream *zs = plan->threads->streams[ithread];
+  double start = omp_get_wtime();
+  stream_rseek(zs->stream, plan->blocks->begs[ichunk]);
+  zfp_decompress_chunk(zs, plan->chunks->chunks[ichunk], ((zfp_plan_call *)context)->field);
+  plan->blocks->busy[ithread] += omp_get_wtime() - start;
+}
+
+/*hand every chunk to task, by fixed runs or dynamically by order*/
+static void zfp_plan_run(zfp_plan *plan, zfp_chunk_task task, zfp_plan_call *call)
+{
+  int nteam = (int)plan->threads->nstreams;
+  zfp_blocks_busy_reset(plan->blocks, nteam);
+  if (plan->blocks->affinity & ZFP_BLOCKS_NUMA)
+    zfp_chunks_by_thread(task, call, plan->chunks, (int)zfp_field_dimensionality(&plan->field), nteam,
+                         plan->blocks->affinity & ZFP_BLOCKS_PIN, plan->runs);
+  else
+  {
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nteam)
+    for (size_t i = 0; i < plan->chunks->nchunks; i++)
+      task(call, plan->order[i], omp_get_thread_num());
+  }
+}
+
+zfp_plan *zfp_plan_create(
+    const zfp_stream *stream,     /* compression parameters */
+    const zfp_field *field,       /* field metadata */
+    const int nthreads,           /*number of threads to use*/
+    const float blocks_per_chunk, /*number of blocks per chunk*/
+    const int method              /*method for compression*/
+)
+{
+  size_t n[4];
+  int ndims = zfp_field_to_n(field, n);
+  // team size is fixed per plan without changing the caller's OpenMP settings
+  int nteam = nthreads > 0 ? nthreads : omp_get_max_threads();
+  zfp_plan *plan = (zfp_plan *)malloc(sizeof(zfp_plan));
+  plan->field = *field;
+  plan->field.data = NULL;
+  plan->nthreads = nteam;
+  plan->blocks = zfp_optimal_parts_from_size(ndims, n, blocks_per_chunk, method);
+  zfp_blocks_set_flags(plan->blocks, method);
+  plan->chunks = zfp_chunks_from_blocks(ndims, n, plan->blocks);
+  size_t nchunks = plan->chunks->nchunks;
+
+  // each chunk is compressed into a worst-case slot following the header
+  plan->slots = (size_t *)malloc((nchunks + 1) * sizeof(size_t));
+  plan->slots[0] = zfp_blocks_header_bits(plan->blocks);
+  for (size_t ichunk = 0; ichunk < nchunks; ichunk++)
+    plan->slots[ichunk + 1] = plan->slots[ichunk] + CHAR_BIT * zfp_stream_maximum_size_chunk(stream, field, plan->chunks->chunks[ichunk]);
+  memcpy(plan->blocks->begs, plan->slots, (nchunks + 1) * sizeof(size_t));
+  plan->bytes = plan->slots[nchunks] / CHAR_BIT;
+  plan->buffer = malloc(plan->bytes);
+  plan->stream = zfp_stream_open(stream_open(plan->buffer, plan->bytes));
+  zfp_stream_set_params(plan->stream, stream->minbits, stream->maxbits, stream->maxprec, stream->minexp);
+  plan->scratch = (size_t *)malloc(3 * nchunks * sizeof(size_t));
+
+  // order is fixed here, from sampled costs when data is already available
+  size_t *cost = plan->blocks->costs;
+  if (!cost && field->data && stream->minbits != stream->maxbits)
+  {
+    cost = (size_t *)malloc(nchunks * sizeof(size_t));
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nteam)
+    for (size_t ichunk = 0; ichunk < nchunks; ichunk++)
+      cost[ichunk] = zfp_chunk_sample_cost(stream, field, plan->chunks->chunks[ichunk]);
+  }
+  plan->order = zfp_chunks_by_cost(cost, nchunks);
+  if (cost != plan->blocks->costs)
+    free(cost);
+
+  // every thread reads and writes the whole buffer through its own stream
+  plan->threads = zfp_streams_alloc((size_t)nteam);
+  for (int ithread = 0; ithread < nteam; ithread++)
+  {
+    plan->threads->streams[ithread] = zfp_stream_open(stream_open(plan->buffer, plan->bytes));
+    zfp_stream_set_params(plan->threads->streams[ithread], stream->minbits, stream->maxbits, stream->maxprec, stream->minexp);
+  }
+  plan->runs = (size_t *)malloc((nteam + 1) * sizeof(size_t));
+
+  // slots are placed on the node of the thread that will write them
+  zfp_plan_call call = {plan, &plan->field};
+  if (plan->blocks->affinity & ZFP_BLOCKS_NUMA)
+    zfp_plan_run(plan, zfp_plan_touch_chunk, &call);
+  zfp_blocks_busy_reset(plan->blocks, nteam);
+  return plan;
+}
+
+size_t zfp_plan_compress(zfp_plan *plan, const void *data)
+{
+  zfp_field field = plan->field;
+  zfp_blocks *blocks = plan->blocks;
+  size_t nchunks = plan->chunks->nchunks;
+  size_t *src = plan->scratch;
+  size_t *dst = src + nchunks;
+  size_t *len = dst + nchunks;
+  zfp_plan_call call = {plan, &field};
+  field.data = (void *)data;
+  zfp_plan_run(plan, zfp_plan_compress_chunk, &call);
+
+  // chunks move from their slots to follow one another after the header
+  blocks->begs[0] = plan->slots[0];
+  for (size_t ichunk = 0; ichunk < nchunks; ichunk++)
+  {
+    src[ichunk] = plan->slots[ichunk] / CHAR_BIT;
+    dst[ichunk] = blocks->begs[ichunk] / CHAR_BIT;
+    blocks->begs[ichunk + 1] = blocks->begs[ichunk] + CHAR_BIT * len[ichunk];
+  }
+  zfp_blocks_pack((uchar *)plan->buffer, src, dst, len, nchunks);
+
+  stream_rewind(plan->stream->stream);
+  zfp_write_blocks_header(plan->stream, &field, blocks, 0);
+  return blocks->begs[nchunks] / CHAR_BIT;
+}
+
+size_t zfp_plan_decompress(zfp_plan *plan, void *data)
+{
+  zfp_field field = plan->field;
+  zfp_blocks *blocks = plan->blocks;
+  size_t nchunks = plan->chunks->nchunks;
+  field.data = data;
+
+  // header must describe the planned field, grid and parameters
+  zfp_stream zs = *plan->stream;
+  zfp_field head = field;
+  zfp_blocks grid = *blocks;
+  int stats;
+  stream_rewind(zs.stream);
+  if (!zfp_read_blocks_fixed(&zs, &head, &grid, &stats) ||
+      head.type != field.type || head.nx != field.nx || head.ny != field.ny ||
+      head.nz != field.nz || head.nw != field.nw || grid.nbeg != blocks->nbeg ||
+      grid.bx != blocks->bx || grid.by != blocks->by || grid.bz != blocks->bz ||
+      grid.bw != blocks->bw || zfp_stream_mode(&zs) != zfp_stream_mode(plan->stream))
+    return 0;
+  for (size_t i = 0; i < nchunks + 1; i++)
+    blocks->begs[i] = stream_read_bits(zs.stream, 64);
+  if (stats && blocks->stats)
+    zfp_read_blocks_stats(zs.stream, blocks);
+  if (blocks->begs[0] == ZFP_BLOCKS_BEGS_TRAILER || blocks->begs[nchunks] > CHAR_BIT * plan->bytes)
+    return 0;
+
+  zfp_plan_call call = {plan, &field};
+  zfp_plan_run(plan, zfp_plan_decompress_chunk, &call);
+  return blocks->begs[nchunks] / CHAR_BIT;
+}
+
+void zfp_plan_free(zfp_plan *plan)
+{
+  zfp_streams_free(plan->threads);
+  stream_close(plan->stream->stream);
+  zfp_stream_close(plan->stream);
+  zfp_chunks_free(plan->chunks);
+  zfp_blocks_free(plan->blocks);
+  free(plan->buffer);
+  free(plan->slots);
+  free(plan->scratch);
+  free(plan->runs);
+  free(plan->order);
+  free(plan);
+}
+
 size_t zfp_blocks_decompress_single_stream(
     zfp_stream *stream, /* compressed stream */
     zfp_field *field,   /* field metadata */
@@ -2125,7 +3195,7 @@ size_t zfp_blocks_decompress_single_stream(
   zfp_read_blocks_header(stream, field, zfp_b);
 
 
-  int nsize[4];
+  size_t nsize[4];
   omp_set_num_threads(nthreads);
   int ndims = zfp_field_to_n(field, nsize);
 
@@ -2144,6 +3214,452 @@ size_t zfp_blocks_decompress_single_stream(
   return loc;
 }
 
+size_t zfp_blocks_decompress_region(
+    zfp_stream *stream,   /* compressed stream */
+    zfp_field *field,     /* destination of sub-box */
+    const zfp_chunk *box, /*first (fx..) and one past last (ex..) element*/
+    const int nthreads    /*number of threads to use*/
+)
+{
+  size_t n[4] = {1, 1, 1, 1};
+  size_t bf[4], be[4], size[4];
+  ptrdiff_t os[4] = {0, 0, 0, 0};
+  zfp_field *full = zfp_field_alloc();
+  zfp_blocks *zfp_b = zfp_blocks_alloc();
+
+  // container starts at the current position, which is restored on return
+  bitstream_offset base = stream_rtell(stream->stream);
+  size_t hbits = zfp_read_blocks_header(stream, full, zfp_b);
+  stream_rseek(stream->stream, base);
+  if (!hbits)
+  {
+    zfp_field_free(full);
+    zfp_blocks_free(zfp_b);
+    return 0;
+  }
+  int ndims = zfp_field_to_n(full, n);
+  zfp_chunk_bounds(box, ndims, n, bf, be);
+
+  // destination must hold the stored scalar type with the extents of the box
+  int valid = field->type == full->type && (int)zfp_field_dimensionality(field) == ndims;
+  if (valid)
+  {
+    zfp_field_size(field, size);
+    zfp_field_stride(field, os);
+    for (int i = 0; i < ndims; i++)
+      valid &= bf[i] < be[i] && size[i] == be[i] - bf[i];
+  }
+  if (!valid)
+  {
+    zfp_field_free(full);
+    zfp_blocks_free(zfp_b);
+    return 0;
+  }
+
+  // only chunks overlapping the box are decoded
+  zfp_chunks *chunks = zfp_chunks_from_blocks(ndims, n, zfp_b);
+  size_t *touched = (size_t *)malloc(chunks->nchunks * sizeof(size_t));
+  size_t *cost = (size_t *)malloc(chunks->nchunks * sizeof(size_t));
+  size_t ntouched = 0;
+  size_t slot = 0;
+  for (size_t ichunk = 0; ichunk < chunks->nchunks; ichunk++)
+  {
+    size_t cf[4], ce[4];
+    size_t cells = 1;
+    int hit = 1;
+    zfp_chunk_bounds(chunks->chunks[ichunk], ndims, n, cf, ce);
+    for (int i = 0; i < 4; i++)
+    {
+      hit &= cf[i] < be[i] && bf[i] < ce[i];
+      cells *= ce[i] - cf[i];
+    }
+    if (!hit)
+      continue;
+    touched[ntouched] = ichunk;
+    cost[ntouched++] = zfp_b->begs[ichunk + 1] - zfp_b->begs[ichunk];
+    if (cells > slot)
+      slot = cells;
+  }
+  size_t *order = zfp_chunks_by_cost(cost, ntouched);
+  free(cost);
+
+  omp_set_num_threads(nthreads);
+  size_t elem = zfp_type_size(full->type);
+  uchar *scratch = (uchar *)malloc(omp_get_max_threads() * slot * elem);
+  uchar *data = (uchar *)stream_data(stream->stream) + base / CHAR_BIT;
+  size_t bytes = 0;
+#pragma omp parallel for schedule(dynamic, 1) reduction(+ : bytes)
+  for (size_t i = 0; i < ntouched; i++)
+  {
+    size_t ichunk = touched[order[i]];
+    size_t cf[4], ce[4], lo[4], hi[4];
+    zfp_chunk_bounds(chunks->chunks[ichunk], ndims, n, cf, ce);
+    ptrdiff_t cs[4] = {1, 0, 0, 0};
+    for (int d = 1; d < ndims; d++)
+      cs[d] = cs[d - 1] * (ptrdiff_t)(ce[d - 1] - cf[d - 1]);
+    uchar *buf = scratch + omp_get_thread_num() * slot * elem;
+
+    // chunk starts on a block boundary, so it decodes like a stand-alone
+    // contiguous field of its own extents with origin cf
+    zfp_field part = *full;
+    part.nx = ce[0] - cf[0];
+    part.ny = ndims > 1 ? ce[1] - cf[1] : 0;
+    part.nz = ndims > 2 ? ce[2] - cf[2] : 0;
+    part.nw = ndims > 3 ? ce[3] - cf[3] : 0;
+    part.sx = part.sy = part.sz = part.sw = 0;
+    part.data = buf;
+    size_t len = (zfp_b->begs[ichunk + 1] - zfp_b->begs[ichunk]) / CHAR_BIT;
+    bitstream *bs = stream_open(data + zfp_b->begs[ichunk] / CHAR_BIT, len);
+    zfp_stream *zs = zfp_stream_open(bs);
+    zfp_stream_set_params(zs, stream->minbits, stream->maxbits, stream->maxprec, stream->minexp);
+    zfp_decompress(zs, &part);
+    zfp_stream_close(zs);
+    stream_close(bs);
+    bytes += len;
+
+    // copy the part of the chunk inside the box, a row at a time
+    for (int d = 0; d < 4; d++)
+    {
+      lo[d] = cf[d] > bf[d] ? cf[d] : bf[d];
+      hi[d] = ce[d] < be[d] ? ce[d] : be[d];
+    }
+    size_t row = hi[0] - lo[0];
+    for (size_t w = lo[3]; w < hi[3]; w++)
+      for (size_t z = lo[2]; z < hi[2]; z++)
+        for (size_t y = lo[1]; y < hi[1]; y++)
+        {
+          const uchar *src = buf + elem * ((lo[0] - cf[0]) + (y - cf[1]) * cs[1] +
+                                           (z - cf[2]) * cs[2] + (w - cf[3]) * cs[3]);
+          uchar *dst = (uchar *)field->data +
+                       (ptrdiff_t)elem * ((ptrdiff_t)(lo[0] - bf[0]) * os[0] + (ptrdiff_t)(y - bf[1]) * os[1] +
+                                          (ptrdiff_t)(z - bf[2]) * os[2] + (ptrdiff_t)(w - bf[3]) * os[3]);
+          if (os[0] == 1)
+            memcpy(dst, src, row * elem);
+          else
+            for (size_t x = 0; x < row; x++)
+              memcpy(dst + (ptrdiff_t)elem * (ptrdiff_t)x * os[0], src + elem * x, elem);
+        }
+  }
+
+  free(scratch);
+  free(order);
+  free(touched);
+  zfp_chunks_free(chunks);
+  zfp_field_free(full);
+  zfp_blocks_free(zfp_b);
+  return bytes;
+}
+
+#ifdef ZFP_BLOCKS_FILE_IO
+zfp_blocks_map *zfp_blocks_map_open(const char *path)
+{
+  struct stat st;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return NULL;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < ZFP_HEADER_BLOCKS_V1_BITS / CHAR_BIT + sizeof(uint64))
+  {
+    close(fd);
+    return NULL;
+  }
+  void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // mapping remains valid once the descriptor is closed
+  close(fd);
+  if (data == MAP_FAILED)
+    return NULL;
+
+  zfp_blocks_map *map = (zfp_blocks_map *)malloc(sizeof(zfp_blocks_map));
+  map->data = data;
+  map->bytes = (size_t)st.st_size;
+  map->stream = zfp_stream_open(stream_open(data, map->bytes));
+  map->field = zfp_field_alloc();
+  map->blocks = zfp_blocks_alloc();
+  if (!zfp_read_blocks_header(map->stream, map->field, map->blocks) ||
+      map->blocks->begs[map->blocks->nbeg] > CHAR_BIT * map->bytes)
+  {
+    zfp_blocks_map_close(map);
+    return NULL;
+  }
+  stream_rewind(map->stream->stream);
+  return map;
+}
+
+int zfp_blocks_map_advise(const zfp_blocks_map *map, const zfp_chunk *box)
+{
+  size_t n[4] = {1, 1, 1, 1};
+  size_t bf[4], be[4];
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  int ndims = zfp_field_to_n(map->field, n);
+  zfp_chunks *chunks = zfp_chunks_from_blocks(ndims, n, map->blocks);
+  int advised = 0;
+
+  if (box)
+    zfp_chunk_bounds(box, ndims, n, bf, be);
+  for (size_t ichunk = 0; ichunk < chunks->nchunks; ichunk++)
+  {
+    if (box)
+    {
+      size_t cf[4], ce[4];
+      int hit = 1;
+      zfp_chunk_bounds(chunks->chunks[ichunk], ndims, n, cf, ce);
+      for (int i = 0; i < 4; i++)
+        hit &= cf[i] < be[i] && bf[i] < ce[i];
+      if (!hit)
+        continue;
+    }
+    // advice must start on a page boundary
+    size_t beg = map->blocks->begs[ichunk] / CHAR_BIT / page * page;
+    size_t end = map->blocks->begs[ichunk + 1] / CHAR_BIT;
+    if (posix_madvise((uchar *)map->data + beg, end - beg, POSIX_MADV_WILLNEED) == 0)
+      advised++;
+  }
+
+  zfp_chunks_free(chunks);
+  return advised;
+}
+
+void zfp_blocks_map_close(zfp_blocks_map *map)
+{
+  zfp_blocks_free(map->blocks);
+  zfp_field_free(map->field);
+  stream_close(map->stream->stream);
+  zfp_stream_close(map->stream);
+  munmap(map->data, map->bytes);
+  free(map);
+}
+
+/*write all bytes at offset of file (nonzero upon success)*/
+static int zfp_blocks_pwrite(const int fd, const void *data, size_t bytes, size_t offset)
+{
+  const uchar *p = (const uchar *)data;
+  while (bytes)
+  {
+    ssize_t n = pwrite(fd, p, bytes, (off_t)offset);
+    if (n <= 0)
+      return 0;
+    p += n;
+    bytes -= (size_t)n;
+    offset += (size_t)n;
+  }
+  return 1;
+}
+
+/*read all bytes at offset of file (nonzero upon success)*/
+static int zfp_blocks_pread(const int fd, void *data, size_t bytes, size_t offset)
+{
+  uchar *p = (uchar *)data;
+  while (bytes)
+  {
+    ssize_t n = pread(fd, p, bytes, (off_t)offset);
+    if (n <= 0)
+      return 0;
+    p += n;
+    bytes -= (size_t)n;
+    offset += (size_t)n;
+  }
+  return 1;
+}
+
+size_t zfp_blocks_compress_to_fd(
+    zfp_stream *stream,           /* compression parameters */
+    const zfp_field *field,       /* field metadata */
+    const int nthreads,           /*number of threads to use*/
+    const float blocks_per_chunk, /*number of blocks per chunk*/
+    const int method,             /*method for compression*/
+    const int fd,                 /*file descriptor open for writing*/
+    const size_t offset           /*byte position of container in file*/
+)
+{
+  size_t n[4];
+  int ndims = zfp_field_to_n(field, n);
+  zfp_blocks *zfp_b = zfp_optimal_parts_from_size(ndims, n, blocks_per_chunk, method);
+  zfp_chunks *chunks = zfp_chunks_from_blocks(ndims, n, zfp_b);
+  size_t nchunks = chunks->nchunks;
+  zfp_blocks_set_flags(zfp_b, method);
+  size_t hbytes = zfp_blocks_header_bits(zfp_b) / CHAR_BIT;
+  int ok = 1;
+
+  // ring of two halves, each holding a batch of worst-case sized chunks
+  size_t slot = 0;
+  for (size_t ichunk = 0; ichunk < nchunks; ichunk++)
+  {
+    size_t size = zfp_stream_maximum_size_chunk(stream, field, chunks->chunks[ichunk]);
+    if (size > slot)
+      slot = size;
+  }
+  slot = (slot + sizeof(uint64) - 1) / sizeof(uint64) * sizeof(uint64);
+  size_t nslot = 2 * (size_t)nthreads;
+  size_t nbatch = (nchunks + nslot - 1) / nslot;
+  uchar *ring = (uchar *)malloc(2 * nslot * slot);
+  size_t *len = (size_t *)malloc(2 * nslot * sizeof(size_t));
+
+  // chunks follow the header, whose size is known up front
+  zfp_b->begs[0] = CHAR_BIT * hbytes;
+  omp_set_num_threads(nthreads);
+#pragma omp parallel
+  for (size_t batch = 0; batch <= nbatch; batch++)
+  {
+    size_t wfirst = (batch - 1) * nslot;
+    size_t nwrite = batch == 0 ? 0 : (nslot < nchunks - wfirst ? nslot : nchunks - wfirst);
+    size_t cfirst = batch * nslot;
+    size_t ncompress = batch == nbatch ? 0 : (nslot < nchunks - cfirst ? nslot : nchunks - cfirst);
+
+    // file positions of the previous batch follow from its compressed sizes
+#pragma omp single
+    for (size_t i = 0; i < nwrite; i++)
+      zfp_b->begs[wfirst + i + 1] = zfp_b->begs[wfirst + i] + CHAR_BIT * len[((batch - 1) % 2) * nslot + i];
+
+    // write the previous batch while compressing this one
+#pragma omp for schedule(dynamic, 1)
+    for (size_t i = 0; i < nwrite + ncompress; i++)
+    {
+      if (i < nwrite)
+      {
+        size_t islot = ((batch - 1) % 2) * nslot + i;
+        if (!zfp_blocks_pwrite(fd, ring + islot * slot, len[islot], offset + zfp_b->begs[wfirst + i] / CHAR_BIT))
+        {
+#pragma omp atomic write
+          ok = 0;
+        }
+      }
+      else
+      {
+        size_t islot = (batch % 2) * nslot + i - nwrite;
+        bitstream *bs = stream_open(ring + islot * slot, slot);
+        zfp_stream *zs = zfp_stream_open(bs);
+        zfp_stream_set_params(zs, stream->minbits, stream->maxbits, stream->maxprec, stream->minexp);
+        zfp_compress_chunk(zs, chunks->chunks[cfirst + i - nwrite], field);
+        stream_flush(bs);
+        len[islot] = stream_wtell(bs) / CHAR_BIT;
+        if (zfp_b->stats)
+          zfp_chunk_stats(field, chunks->chunks[cfirst + i - nwrite], zfp_b->stats + 3 * (cfirst + i - nwrite));
+        zfp_stream_close(zs);
+        stream_close(bs);
+      }
+    }
+  }
+  free(ring);
+  free(len);
+
+  // header goes in last, once every chunk position is known
+  void *header = malloc(hbytes);
+  bitstream *hs = stream_open(header, hbytes);
+  bitstream *saved = zfp_stream_bit_stream(stream);
+  zfp_stream_set_bit_stream(stream, hs);
+  zfp_write_blocks_header(stream, field, zfp_b, 0);
+  zfp_stream_set_bit_stream(stream, saved);
+  stream_close(hs);
+  if (!zfp_blocks_pwrite(fd, header, hbytes, offset))
+    ok = 0;
+  free(header);
+
+  size_t total = zfp_b->begs[nchunks] / CHAR_BIT;
+  zfp_chunks_free(chunks);
+  zfp_blocks_free(zfp_b);
+  return ok ? total : 0;
+}
+
+size_t zfp_blocks_decompress_from_fd(
+    zfp_field *field,   /* field metadata */
+    const int nthreads, /*number of threads to use*/
+    const int fd,       /*file descriptor open for reading*/
+    const size_t offset /*byte position of container in file*/
+)
+{
+  // magic and version byte tell how long the fixed part of the header is
+  uint64 fixed[ZFP_HEADER_BLOCKS_MAX_BITS / 64 + 1];
+  if (!zfp_blocks_pread(fd, fixed, sizeof(uint64), offset))
+    return 0;
+  bitstream *bs = stream_open(fixed, sizeof(fixed));
+  stream_skip(bs, ZFP_MAGIC_BITS);
+  size_t fbits = stream_read_bits(bs, 8) & ZFP_BLOCKS_HEADER_VERSIONED ? ZFP_HEADER_BLOCKS_MAX_BITS
+                                                                       : ZFP_HEADER_BLOCKS_V1_BITS;
+
+  // every header holds its fixed part and at least one beg
+  zfp_stream *zs = zfp_stream_open(bs);
+  zfp_blocks *zfp_b = zfp_blocks_alloc();
+  size_t bits = 0;
+  int trailer = 0, stats = 0;
+  stream_rewind(bs);
+  if (zfp_blocks_pread(fd, fixed, fbits / CHAR_BIT + sizeof(uint64), offset))
+    bits = zfp_read_blocks_fixed(zs, field, zfp_b, &stats);
+  if (bits)
+    trailer = (size_t)stream_read_bits(bs, 64) == ZFP_BLOCKS_BEGS_TRAILER;
+  zfp_stream_close(zs);
+  stream_close(bs);
+  if (!bits)
+  {
+    zfp_blocks_free(zfp_b);
+    return 0;
+  }
+
+  // streamed containers keep begs at the end of the file; append them
+  size_t tables = 64 * (zfp_b->nbeg + 1) + (stats ? 3 * 64 * zfp_b->nbeg : 0);
+  size_t hbytes = ((bits + tables + 63) & ~(size_t)63) / CHAR_BIT;
+  size_t tbytes = trailer ? tables / CHAR_BIT : 0;
+  struct stat st;
+  uchar *header = (uchar *)malloc(hbytes + tbytes);
+  int ok = zfp_blocks_pread(fd, header, hbytes, offset);
+  if (ok && trailer)
+    ok = fstat(fd, &st) == 0 && (size_t)st.st_size >= tbytes &&
+         zfp_blocks_pread(fd, header + hbytes, tbytes, (size_t)st.st_size - tbytes);
+  zs = zfp_stream_open(stream_open(header, hbytes + tbytes));
+  if (!ok || !zfp_read_blocks_header(zs, field, zfp_b))
+  {
+    stream_close(zs->stream);
+    zfp_stream_close(zs);
+    free(header);
+    zfp_blocks_free(zfp_b);
+    return 0;
+  }
+
+  size_t nsize[4];
+  int ndims = zfp_field_to_n(field, nsize);
+  zfp_chunks *chunks = zfp_chunks_from_blocks(ndims, nsize, zfp_b);
+  size_t *cost = (size_t *)malloc(chunks->nchunks * sizeof(size_t));
+  size_t slot = 0;
+  for (size_t ichunk = 0; ichunk < chunks->nchunks; ichunk++)
+  {
+    cost[ichunk] = (zfp_b->begs[ichunk + 1] - zfp_b->begs[ichunk]) / CHAR_BIT;
+    if (cost[ichunk] > slot)
+      slot = cost[ichunk];
+  }
+  size_t *order = zfp_chunks_by_cost(cost, chunks->nchunks);
+
+  omp_set_num_threads(nthreads);
+  uchar *buffer = (uchar *)malloc(omp_get_max_threads() * slot);
+#pragma omp parallel for schedule(dynamic, 1)
+  for (size_t i = 0; i < chunks->nchunks; i++)
+  {
+    size_t ichunk = order[i];
+    uchar *buf = buffer + omp_get_thread_num() * slot;
+    if (!zfp_blocks_pread(fd, buf, cost[ichunk], offset + zfp_b->begs[ichunk] / CHAR_BIT))
+    {
+#pragma omp atomic write
+      ok = 0;
+      continue;
+    }
+    bitstream *cs = stream_open(buf, cost[ichunk]);
+    zfp_stream *zc = zfp_stream_open(cs);
+    zfp_stream_set_params(zc, zs->minbits, zs->maxbits, zs->maxprec, zs->minexp);
+    zfp_decompress_chunk(zc, chunks->chunks[ichunk], field);
+    zfp_stream_close(zc);
+    stream_close(cs);
+  }
+
+  size_t total = zfp_b->begs[zfp_b->nbeg] / CHAR_BIT;
+  free(buffer);
+  free(order);
+  free(cost);
+  zfp_chunks_free(chunks);
+  stream_close(zs->stream);
+  zfp_stream_close(zs);
+  free(header);
+  zfp_blocks_free(zfp_b);
+  return ok ? total : 0;
+}
+#endif
+
 size_t zfp_blocks_decompress_multi_stream(
     zfp_stream *stream,    /* compressed stream */
     zfp_field *field,      /* field metadata */
@@ -2151,7 +3667,7 @@ size_t zfp_blocks_decompress_multi_stream(
     const int nthreads     /*number of threads to use*/
 )
 {
-  int block_size[4], nsize[4];
+  size_t nsize[4];
   omp_set_num_threads(nthreads);
   zfp_blocks *zfp_b = zfp_blocks_alloc();
 
@@ -2161,12 +3677,20 @@ size_t zfp_blocks_decompress_multi_stream(
   int ndims = zfp_field_to_n(field, nsize);
   zfp_chunks *chunks = zfp_chunks_from_blocks(ndims, nsize, zfp_b);
 
-#pragma omp parallel for
+  size_t *cost = (size_t *)malloc(chunks->nchunks * sizeof(size_t));
   for (size_t ichunk = 0; ichunk < chunks->nchunks; ichunk++)
+    cost[ichunk] = zfp_b->begs[ichunk + 1] - zfp_b->begs[ichunk];
+  size_t *order = zfp_chunks_by_cost(cost, chunks->nchunks);
+  free(cost);
+
+#pragma omp parallel for schedule(dynamic, 1)
+  for (size_t i = 0; i < chunks->nchunks; i++)
   {
+    size_t ichunk = order[i];
     stream_rewind(zstreams->streams[ichunk]->stream);
     zfp_decompress_chunk(zstreams->streams[ichunk], chunks->chunks[ichunk], field);
   }
+  free(order);
 
   size_t val = zfp_b->begs[zfp_b->nbeg];
 
@@ -2176,4 +3700,150 @@ size_t zfp_blocks_decompress_multi_stream(
   return val / 8;
 }
 
-#endif
\ No newline at end of file
+#endif
+
+/* public functions: asynchronous compression ------------------------------ */
+
+/* compression request running in the background */
+struct zfp_async {
+  zfp_stream* stream;          /* compressed stream */
+  const zfp_field* field;      /* field metadata */
+  zfp_bool blocks;             /* compress to a single-stream block container */
+  int nthreads;                /* block container threads */
+  float blocks_per_chunk;      /* block container blocks per chunk */
+  int method;                  /* block container method */
+  zfp_async_callback callback; /* called once done (may be NULL) */
+  void* context;               /* passed through to callback */
+  size_t bytes;                /* return value of compression call */
+  zfp_bool done;               /* true once compression finished */
+#ifdef ZFP_WITH_THREADS
+  zfp_bool finished;           /* true once callback returned */
+  thread_post post;            /* pool task running this request */
+  pthread_mutex_t mutex;       /* guards done and finished */
+  pthread_cond_t cond;         /* signals that request finished */
+#endif
+};
+
+/* compress, mark request done, and notify the caller */
+static void
+async_run(zfp_async* handle)
+{
+  size_t bytes;
+#ifdef _OPENMP
+  if (handle->blocks)
+    bytes = zfp_blocks_compress_single_stream(handle->stream, handle->field, handle->nthreads, handle->blocks_per_chunk, handle->method);
+  else
+#endif
+    bytes = zfp_compress(handle->stream, handle->field);
+#ifdef ZFP_WITH_THREADS
+  pthread_mutex_lock(&handle->mutex);
+#endif
+  handle->bytes = bytes;
+  handle->done = zfp_true;
+#ifdef ZFP_WITH_THREADS
+  pthread_mutex_unlock(&handle->mutex);
+#endif
+  if (handle->callback)
+    handle->callback(handle->context, bytes);
+#ifdef ZFP_WITH_THREADS
+  pthread_mutex_lock(&handle->mutex);
+  handle->finished = zfp_true;
+  pthread_cond_signal(&handle->cond);
+  pthread_mutex_unlock(&handle->mutex);
+#endif
+}
+
+#ifdef ZFP_WITH_THREADS
+static void
+async_task(void* context, size_t item)
+{
+  (void)item;
+  async_run((zfp_async*)context);
+}
+#endif
+
+/* run request on a pool thread, or on the calling thread if the pool is empty */
+static zfp_async*
+async_start(zfp_async* handle)
+{
+  handle->bytes = 0;
+  handle->done = zfp_false;
+#ifdef ZFP_WITH_THREADS
+  handle->finished = zfp_false;
+  pthread_mutex_init(&handle->mutex, NULL);
+  pthread_cond_init(&handle->cond, NULL);
+  handle->post.task = async_task;
+  handle->post.context = handle;
+  if (thread_pool_post(&handle->post))
+    return handle;
+#endif
+  async_run(handle);
+  return handle;
+}
+
+zfp_async*
+zfp_compress_async(zfp_stream* zfp, const zfp_field* field, zfp_async_callback callback, void* context)
+{
+  zfp_async* handle = (zfp_async*)malloc(sizeof(zfp_async));
+  if (!handle)
+    return NULL;
+  handle->stream = zfp;
+  handle->field = field;
+  handle->blocks = zfp_false;
+  handle->nthreads = 0;
+  handle->blocks_per_chunk = 0;
+  handle->method = 0;
+  handle->callback = callback;
+  handle->context = context;
+  return async_start(handle);
+}
+
+#ifdef _OPENMP
+zfp_async*
+zfp_blocks_compress_async(zfp_stream* zfp, const zfp_field* field, const int nthreads, const float blocks_per_chunk, const int method, zfp_async_callback callback, void* context)
+{
+  zfp_async* handle = (zfp_async*)malloc(sizeof(zfp_async));
+  if (!handle)
+    return NULL;
+  handle->stream = zfp;
+  handle->field = field;
+  handle->blocks = zfp_true;
+  handle->nthreads = nthreads;
+  handle->blocks_per_chunk = blocks_per_chunk;
+  handle->method = method;
+  handle->callback = callback;
+  handle->context = context;
+  return async_start(handle);
+}
+#endif
+
+zfp_bool
+zfp_test(zfp_async* handle)
+{
+  zfp_bool done;
+#ifdef ZFP_WITH_THREADS
+  pthread_mutex_lock(&handle->mutex);
+  done = handle->done;
+  pthread_mutex_unlock(&handle->mutex);
+#else
+  done = handle->done;
+#endif
+  return done;
+}
+
+size_t
+zfp_wait(zfp_async* handle)
+{
+  size_t bytes;
+#ifdef ZFP_WITH_THREADS
+  pthread_mutex_lock(&handle->mutex);
+  while (!handle->finished)
+    pthread_cond_wait(&handle->cond, &handle->mutex);
+  pthread_mutex_unlock(&handle->mutex);
+  pthread_cond_destroy(&handle->cond);
+  pthread_mutex_destroy(&handle->mutex);
+#endif
+  bytes = handle->bytes;
+  free(handle);
+  return bytes;
+}
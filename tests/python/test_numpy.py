@@ -47,6 +47,59 @@ class TestNumpy(unittest.TestCase):
             array = np.random.randint(2**30, size=shape)
             self.lossless_round_trip(array)
 
+    def test_zero_copy_round_trip(self):
+        orig_array = np.random.rand(20, 30, 7)
+        compressed = zfpy.compress_numpy(orig_array)
+
+        view = zfpy.compress_numpy(orig_array, copy=False)
+        self.assertIsInstance(view, memoryview)
+        self.assertEqual(bytes(view), compressed)
+        # storage allocated for the worst case is shrunk to the compressed size
+        self.assertEqual(view.obj.nbytes, len(compressed))
+
+        buf = bytearray(2 * orig_array.nbytes)
+        view = zfpy.compress_numpy(orig_array, out=buf)
+        self.assertEqual(bytes(buf[:len(compressed)]), compressed)
+        self.assertRaises(ValueError, zfpy.compress_numpy, orig_array, out=bytearray(16))
+
+        out = np.empty_like(orig_array)
+        decompressed_array = zfpy.decompress_numpy(view, out=out)
+        self.assertIs(decompressed_array, out)
+        np.testing.assert_array_equal(out, orig_array)
+
+        # out must be writable and must not overlap the compressed bytes
+        readonly = np.empty_like(orig_array)
+        readonly.flags.writeable = False
+        self.assertRaises(ValueError, zfpy.decompress_numpy, view, out=readonly)
+        self.assertRaises(ValueError, zfpy.decompress_numpy, view, out=bytes(orig_array.nbytes))
+        self.assertRaises(ValueError, zfpy.decompress_numpy, view, out=memoryview(buf)[:orig_array.nbytes])
+        self.assertRaises(ValueError, zfpy.decompress_numpy, view, out=memoryview(buf)[8:8 + orig_array.nbytes])
+
+    def test_parallel_chunks_round_trip(self):
+        for shape in [(1001,), (70, 50), (33, 40, 21), (9, 10, 11, 12)]:
+            orig_array = np.random.rand(*shape)
+            par = zfpy.zfp_parallel(shape, 'float64', nparts=8)
+            par.get_numpy_array()[:] = orig_array
+            par.compress(nthreads=4)
+            data, offsets = par.get_compressed_data()
+            self.assertEqual(len(data), offsets[-1])
+            par.get_numpy_array()[:] = 0
+            par.decompress(nthreads=4)
+            np.testing.assert_array_equal(par.get_numpy_array(), orig_array)
+
+    def test_lazy_array_slicing(self):
+        shape = (33, 40, 21)
+        orig_array = np.random.rand(*shape)
+        par = zfpy.zfp_parallel(shape, 'float64', nparts=8)
+        par.get_numpy_array()[:] = orig_array
+        par.compress(nthreads=4)
+        lazy = par.get_lazy_array(cache_bytes=orig_array.nbytes // 4)
+        for key in [(5,), (slice(3, 30, 2), -1), (Ellipsis, slice(None, None, -3)),
+                    (slice(10, 2, -1), slice(7, 8), 4), (slice(5, 5),)]:
+            np.testing.assert_array_equal(lazy[key], orig_array[key])
+        self.assertLessEqual(lazy._cached_bytes, lazy.cache_bytes)
+        np.testing.assert_array_equal(np.asarray(lazy), orig_array)
+
     def test_advanced_decompression_checksum(self):
         ndims = 2
         ztype = zfpy.type_float
@@ -9,6 +9,9 @@ _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_Decod
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_DecodeBlockStrided_expect_OnlyStridedEntriesChangedInDestinationArray), setup, teardown),
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_DecodeBlockStrided_expect_ArrayChecksumMatches), setup, teardown),
 
+_cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Blocks_when_DecodeBlocksStridedFixedRate_expect_ArraysMatchDecodeBlockStrided), setup, teardown),
+_cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Blocks_when_DecodeBlocksStridedFixedPrecision_expect_ArraysMatchDecodeBlockStrided), setup, teardown),
+
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_DecodePartialBlockStrided_expect_ReturnValReflectsNumBitsReadFromBitstream), setup, teardown),
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_DecodePartialBlockStrided_expect_NonStridedEntriesUnchangedInDestinationArray), setup, teardown),
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_DecodePartialBlockStrided_expect_EntriesOutsidePartialBlockBoundsUnchangedInDestinationArray), setup, teardown),
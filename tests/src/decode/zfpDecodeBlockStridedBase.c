@@ -20,6 +20,8 @@
 #define PW 4
 
 #define DUMMY_VAL 99
+// one full batch of ZFP_BATCH_SIZE blocks followed by a partial batch
+#define BATCH_BLOCKS 11
 
 struct setupVars {
   size_t dimLens[4];
@@ -328,6 +330,28 @@ decodeBlockStrided(zfp_stream* stream, Scalar* dataArr)
   return numBitsRead;
 }
 
+size_t
+decodeBlocksStrided(zfp_stream* stream, Scalar* const* dataArrs, size_t n)
+{
+  size_t numBitsRead;
+  switch (DIMS) {
+    case 1:
+      numBitsRead = _t2(zfp_decode_blocks_strided, Scalar, 1)(stream, dataArrs, n, SX);
+      break;
+    case 2:
+      numBitsRead = _t2(zfp_decode_blocks_strided, Scalar, 2)(stream, dataArrs, n, SX, SY);
+      break;
+    case 3:
+      numBitsRead = _t2(zfp_decode_blocks_strided, Scalar, 3)(stream, dataArrs, n, SX, SY, SZ);
+      break;
+    case 4:
+      numBitsRead = _t2(zfp_decode_blocks_strided, Scalar, 4)(stream, dataArrs, n, SX, SY, SZ, SW);
+      break;
+  }
+
+  return numBitsRead;
+}
+
 size_t
 decodePartialBlockStrided(zfp_stream* stream, Scalar* dataArr)
 {
@@ -558,6 +582,110 @@ _catFunc3(given_, DIM_INT_STR, Block_when_DecodeBlockStrided_expect_ArrayChecksu
   ASSERT_EQ_CHECKSUM(DIMS, ZFP_TYPE, checksum, key1, key2);
 }
 
+// maximum compressed size of BATCH_BLOCKS blocks
+static size_t
+batchMaximumSize(zfp_stream* stream)
+{
+  zfp_type type = ZFP_TYPE;
+  size_t nx = BATCH_BLOCKS * BLOCK_SIDE_LEN;
+  zfp_field* field;
+  switch(DIMS) {
+    case 1:
+      field = zfp_field_1d(NULL, type, nx);
+      break;
+    case 2:
+      field = zfp_field_2d(NULL, type, nx, BLOCK_SIDE_LEN);
+      break;
+    case 3:
+      field = zfp_field_3d(NULL, type, nx, BLOCK_SIDE_LEN, BLOCK_SIDE_LEN);
+      break;
+    case 4:
+      field = zfp_field_4d(NULL, type, nx, BLOCK_SIDE_LEN, BLOCK_SIDE_LEN, BLOCK_SIDE_LEN);
+      break;
+  }
+
+  size_t bufsizeBytes = zfp_stream_maximum_size(stream, field);
+  zfp_field_free(field);
+
+  return bufsizeBytes;
+}
+
+// decode BATCH_BLOCKS blocks one at a time and as a batch, and compare arrays
+static void
+assertBatchMatchesBlocks(zfp_stream* stream)
+{
+  bitstream* original = zfp_stream_bit_stream(stream);
+  size_t bufsizeBytes = batchMaximumSize(stream);
+  char* buffer = calloc(bufsizeBytes, sizeof(char));
+  assert_non_null(buffer);
+
+  Scalar* dataArrs[BATCH_BLOCKS];
+  Scalar* singleArrs[BATCH_BLOCKS];
+  Scalar* batchArrs[BATCH_BLOCKS];
+  size_t arrayLen = 0;
+  int i;
+  for (i = 0; i < BATCH_BLOCKS; i++) {
+    arrayLen = initializeStridedArray(&dataArrs[i], DUMMY_VAL);
+    singleArrs[i] = calloc(arrayLen, sizeof(Scalar));
+    batchArrs[i] = calloc(arrayLen, sizeof(Scalar));
+    assert_non_null(singleArrs[i]);
+    assert_non_null(batchArrs[i]);
+  }
+
+  bitstream* s = stream_open(buffer, bufsizeBytes);
+  zfp_stream_set_bit_stream(stream, s);
+  for (i = 0; i < BATCH_BLOCKS; i++)
+    encodeBlockStrided(stream, dataArrs[i]);
+  zfp_stream_flush(stream);
+
+  zfp_stream_rewind(stream);
+  size_t singleBits = 0;
+  for (i = 0; i < BATCH_BLOCKS; i++)
+    singleBits += decodeBlockStrided(stream, singleArrs[i]);
+  size_t singleOffset = stream_rtell(s);
+
+  zfp_stream_rewind(stream);
+  size_t batchBits = decodeBlocksStrided(stream, batchArrs, BATCH_BLOCKS);
+  size_t batchOffset = stream_rtell(s);
+
+  // restore bitstream before asserting so that teardown closes it
+  stream_close(s);
+  zfp_stream_set_bit_stream(stream, original);
+  free(buffer);
+
+  assert_int_equal(singleBits, singleOffset);
+  assert_int_equal(batchBits, batchOffset);
+  assert_int_equal(batchBits, singleBits);
+  for (i = 0; i < BATCH_BLOCKS; i++) {
+    assert_memory_equal(batchArrs[i], singleArrs[i], arrayLen * sizeof(Scalar));
+    // entries outside the strided block are left untouched
+    assertNonStridedEntriesZero(batchArrs[i]);
+  }
+
+  for (i = 0; i < BATCH_BLOCKS; i++) {
+    free(dataArrs[i]);
+    free(singleArrs[i]);
+    free(batchArrs[i]);
+  }
+}
+
+static void
+_catFunc3(given_, DIM_INT_STR, Blocks_when_DecodeBlocksStridedFixedRate_expect_ArraysMatchDecodeBlockStrided)(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assertBatchMatchesBlocks(bundle->stream);
+}
+
+static void
+_catFunc3(given_, DIM_INT_STR, Blocks_when_DecodeBlocksStridedFixedPrecision_expect_ArraysMatchDecodeBlockStrided)(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_precision(bundle->stream, ZFP_PREC_PARAM_BITS);
+  assertBatchMatchesBlocks(bundle->stream);
+}
+
 static void
 _catFunc3(given_, DIM_INT_STR, Block_when_DecodePartialBlockStrided_expect_ReturnValReflectsNumBitsReadFromBitstream)(void **state)
 {
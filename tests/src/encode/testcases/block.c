@@ -8,4 +8,7 @@ _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_Encod
 #ifdef FL_PT_DATA
 // reversible compression of blocks containing special floating-point values
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_EncodeSpecialBlocks_expect_BitstreamChecksumMatches), setupSpecial, teardown),
+
+// bit-manipulated exponents and scale factors agree with frexp and ldexp
+_cmocka_unit_test(_catFunc3(given_, DIM_INT_STR, Block_when_ComputeExponentsAndScaleFactors_expect_MatchFrexpAndLdexp)),
 #endif
@@ -9,6 +9,9 @@ _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_Encod
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_EncodeBlockStrided_expect_OnlyStridedEntriesUsed), setup, teardown),
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_EncodeBlockStrided_expect_BitstreamChecksumMatches), setup, teardown),
 
+_cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Blocks_when_EncodeBlocksStridedFixedRate_expect_BitstreamMatchesEncodeBlockStrided), setup, teardown),
+_cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Blocks_when_EncodeBlocksStridedFixedPrecision_expect_BitstreamMatchesEncodeBlockStrided), setup, teardown),
+
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_EncodePartialBlockStrided_expect_ReturnValReflectsNumBitsWrittenToBitstream), setup, teardown),
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_EncodePartialBlockStrided_expect_OnlyStridedEntriesUsed), setup, teardown),
 _cmocka_unit_test_setup_teardown(_catFunc3(given_, DIM_INT_STR, Block_when_EncodePartialBlockStrided_expect_OnlyEntriesWithinPartialBlockBoundsUsed), setup, teardown),
@@ -3,6 +3,8 @@
 #include <setjmp.h>
 #include <cmocka.h>
 
+#include <float.h>
+#include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -264,3 +266,75 @@ _catFunc3(given_, DIM_INT_STR, Block_when_EncodeSpecialBlocks_expect_BitstreamCh
     fail_msg("At least 1 special block testcase failed\n");
   }
 }
+
+#ifdef FL_PT_DATA
+// frexp-based exponent of finite x >= 0 that exponent_block must reproduce
+static int
+referenceExponent(Scalar x)
+{
+  int e = -EBIAS;
+#ifdef ZFP_WITH_DAZ
+  if (x >= (sizeof(Scalar) == sizeof(float) ? FLT_MIN : DBL_MIN))
+    frexp(x, &e);
+#else
+  if (x > 0) {
+    frexp(x, &e);
+    e = MAX(e, 1 - EBIAS);
+  }
+#endif
+  return e;
+}
+
+static void
+_catFunc3(given_, DIM_INT_STR, Block_when_ComputeExponentsAndScaleFactors_expect_MatchFrexpAndLdexp)(void **state)
+{
+  const int mbits = (int)(CHAR_BIT * sizeof(Scalar)) - 1 - EBITS;
+  const int pbits = (int)(CHAR_BIT * sizeof(Scalar)) - 2;
+  Scalar block[BLOCK_SIZE];
+  Scalar batch[BATCH_SIZE * BLOCK_SIZE];
+  int expected[BATCH_SIZE];
+  int emax[BATCH_SIZE];
+  int b, e, i, j;
+  (void)state;
+
+  // sweep largest magnitude over all finite biased exponents, including zero and subnormals
+  for (b = 0; b < (1 << EBITS) - 1; b++) {
+    for (j = 0; j < BATCH_SIZE; j++) {
+      // vary mantissa and position of largest magnitude across blocks of batch
+      UInt u = ((UInt)b << mbits) | ((j & 1) ? ((UInt)1 << mbits) - 1 : (UInt)j);
+      Scalar x;
+      memcpy(&x, &u, sizeof(x));
+      for (i = 0; i < BLOCK_SIZE; i++)
+        block[i] = (i == (5 * j) % BLOCK_SIZE) ? -x : x / 3;
+      expected[j] = referenceExponent(x);
+      assert_int_equal(_t1(exponent_block, Scalar)(block, BLOCK_SIZE), expected[j]);
+      // batches interleave the blocks' values
+      for (i = 0; i < BLOCK_SIZE; i++)
+        batch[i * BATCH_SIZE + j] = block[i];
+    }
+    _t1(exponent_batch, Scalar)(emax, batch, BLOCK_SIZE);
+    assert_memory_equal(emax, expected, sizeof(expected));
+  }
+
+  // NaNs do not contribute to the block maximum
+  for (i = 0; i < BLOCK_SIZE; i++)
+    block[i] = (i == 1) ? (Scalar)NAN : (Scalar)0.75;
+  assert_int_equal(_t1(exponent_block, Scalar)(block, BLOCK_SIZE), 0);
+  block[0] = (Scalar)3;
+  assert_int_equal(_t1(exponent_block, Scalar)(block, BLOCK_SIZE), 2);
+
+  // infinities have exponent zero, like frexp
+  block[1] = -(Scalar)INFINITY;
+  assert_int_equal(_t1(exponent_block, Scalar)(block, BLOCK_SIZE), 0);
+
+  // scale factors match ldexp over the range of normal exponents, including overflow and underflow
+  for (e = 1 - EBIAS; e <= EBIAS; e++) {
+    Scalar actual = _t1(quantize, Scalar)(e);
+    Scalar ref = (Scalar)ldexp(1.0, pbits - e);
+    assert_memory_equal(&actual, &ref, sizeof(Scalar));
+    actual = _t1(dequantize, Scalar)(e);
+    ref = (Scalar)ldexp(1.0, e - pbits);
+    assert_memory_equal(&actual, &ref, sizeof(Scalar));
+  }
+}
+#endif
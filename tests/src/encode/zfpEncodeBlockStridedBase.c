@@ -20,6 +20,8 @@
 #define PW 4
 
 #define DUMMY_VAL 99
+// one full batch of ZFP_BATCH_SIZE blocks followed by a partial batch
+#define BATCH_BLOCKS 11
 
 struct setupVars {
   size_t dimLens[4];
@@ -252,6 +254,29 @@ encodeBlockStrided(zfp_stream* stream, Scalar* dataArr)
   return numBitsWritten;
 }
 
+size_t
+encodeBlocksStrided(zfp_stream* stream, Scalar* const* dataArrs, size_t n)
+{
+  const Scalar* const* p = (const Scalar* const*)dataArrs;
+  size_t numBitsWritten;
+  switch (DIMS) {
+    case 1:
+      numBitsWritten = _t2(zfp_encode_blocks_strided, Scalar, 1)(stream, p, n, SX);
+      break;
+    case 2:
+      numBitsWritten = _t2(zfp_encode_blocks_strided, Scalar, 2)(stream, p, n, SX, SY);
+      break;
+    case 3:
+      numBitsWritten = _t2(zfp_encode_blocks_strided, Scalar, 3)(stream, p, n, SX, SY, SZ);
+      break;
+    case 4:
+      numBitsWritten = _t2(zfp_encode_blocks_strided, Scalar, 4)(stream, p, n, SX, SY, SZ, SW);
+      break;
+  }
+
+  return numBitsWritten;
+}
+
 size_t
 encodePartialBlockStrided(zfp_stream* stream, Scalar* dataArr)
 {
@@ -354,6 +379,97 @@ _catFunc3(given_, DIM_INT_STR, Block_when_EncodeBlockStrided_expect_BitstreamChe
   ASSERT_EQ_CHECKSUM(DIMS, ZFP_TYPE, checksum, key1, key2);
 }
 
+// maximum compressed size of BATCH_BLOCKS blocks
+static size_t
+batchMaximumSize(zfp_stream* stream)
+{
+  zfp_type type = ZFP_TYPE;
+  size_t nx = BATCH_BLOCKS * BLOCK_SIDE_LEN;
+  zfp_field* field;
+  switch(DIMS) {
+    case 1:
+      field = zfp_field_1d(NULL, type, nx);
+      break;
+    case 2:
+      field = zfp_field_2d(NULL, type, nx, BLOCK_SIDE_LEN);
+      break;
+    case 3:
+      field = zfp_field_3d(NULL, type, nx, BLOCK_SIDE_LEN, BLOCK_SIDE_LEN);
+      break;
+    case 4:
+      field = zfp_field_4d(NULL, type, nx, BLOCK_SIDE_LEN, BLOCK_SIDE_LEN, BLOCK_SIDE_LEN);
+      break;
+  }
+
+  size_t bufsizeBytes = zfp_stream_maximum_size(stream, field);
+  zfp_field_free(field);
+
+  return bufsizeBytes;
+}
+
+// encode BATCH_BLOCKS blocks one at a time and as a batch, and compare bitstreams
+static void
+assertBatchMatchesBlocks(zfp_stream* stream)
+{
+  bitstream* original = zfp_stream_bit_stream(stream);
+  size_t bufsizeBytes = batchMaximumSize(stream);
+  char* singleBuffer = calloc(bufsizeBytes, sizeof(char));
+  char* batchBuffer = calloc(bufsizeBytes, sizeof(char));
+  assert_non_null(singleBuffer);
+  assert_non_null(batchBuffer);
+
+  Scalar* dataArrs[BATCH_BLOCKS];
+  int i;
+  for (i = 0; i < BATCH_BLOCKS; i++)
+    initializeStridedArray(&dataArrs[i], DUMMY_VAL);
+
+  bitstream* s = stream_open(singleBuffer, bufsizeBytes);
+  zfp_stream_set_bit_stream(stream, s);
+  size_t singleBits = 0;
+  for (i = 0; i < BATCH_BLOCKS; i++)
+    singleBits += encodeBlockStrided(stream, dataArrs[i]);
+  size_t singleOffset = stream_wtell(s);
+  zfp_stream_flush(stream);
+  stream_close(s);
+
+  s = stream_open(batchBuffer, bufsizeBytes);
+  zfp_stream_set_bit_stream(stream, s);
+  size_t batchBits = encodeBlocksStrided(stream, dataArrs, BATCH_BLOCKS);
+  size_t batchOffset = stream_wtell(s);
+  zfp_stream_flush(stream);
+  stream_close(s);
+
+  // restore bitstream before asserting so that teardown closes it
+  zfp_stream_set_bit_stream(stream, original);
+  for (i = 0; i < BATCH_BLOCKS; i++)
+    free(dataArrs[i]);
+
+  assert_int_equal(singleBits, singleOffset);
+  assert_int_equal(batchBits, batchOffset);
+  assert_int_equal(batchBits, singleBits);
+  assert_memory_equal(batchBuffer, singleBuffer, bufsizeBytes);
+
+  free(singleBuffer);
+  free(batchBuffer);
+}
+
+static void
+_catFunc3(given_, DIM_INT_STR, Blocks_when_EncodeBlocksStridedFixedRate_expect_BitstreamMatchesEncodeBlockStrided)(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assertBatchMatchesBlocks(bundle->stream);
+}
+
+static void
+_catFunc3(given_, DIM_INT_STR, Blocks_when_EncodeBlocksStridedFixedPrecision_expect_BitstreamMatchesEncodeBlockStrided)(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_set_precision(bundle->stream, ZFP_PREC_PARAM_BITS);
+  assertBatchMatchesBlocks(bundle->stream);
+}
+
 static void
 _catFunc3(given_, DIM_INT_STR, Block_when_EncodePartialBlockStrided_expect_ReturnValReflectsNumBitsWrittenToBitstream)(void **state)
 {
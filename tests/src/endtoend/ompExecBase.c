@@ -88,7 +88,6 @@ setThreadCount(struct setupVars *bundle, int param)
 }
 
 // OpenMP endtoend entry functions
-// pass doDecompress=0 because decompression not yet supported
 // loop across 3 compression parameters
 
 // returns 0 on success, 1 on test failure
@@ -121,7 +120,7 @@ runCompressAcrossThreadsChunks(void **state, zfp_mode mode)
       }
 
       int numCompressParams = (mode == zfp_mode_reversible) ? 1 : 3;
-      failures += runCompressDecompressAcrossParamsGivenMode(state, 0, mode, numCompressParams);
+      failures += runCompressDecompressAcrossParamsGivenMode(state, 1, mode, numCompressParams);
     }
   }
 
@@ -139,12 +139,48 @@ given_withOpenMP_serialExec_when_setOmpChunkSize_expect_setToExecOmp(void **stat
 }
 
 static void
-given_withOpenMP_whenDecompressOmpPolicy_expect_noop(void **state)
+given_withOpenMP_when_setOmpIndex_expect_set(void **state)
 {
   struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  uint64 index[3];
 
-  assert_int_equal(zfp_decompress(bundle->stream, bundle->field), 0);
-  assert_int_equal(stream_size(bundle->bs), bundle->streamSize);
+  assert_int_equal(zfp_stream_set_omp_index(stream, index, 3), 1);
+  assert_ptr_equal(zfp_stream_omp_index(stream), index);
+  assert_int_equal(zfp_stream_omp_index_size(stream), 3);
+
+  assert_int_equal(zfp_stream_set_omp_index(stream, index, 1), 0);
+}
+
+static void
+given_withOpenMP_ompIndex_whenDecompressOmpPolicy_expect_matchesInput(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = bundle->field;
+  int32 input[9] = {1, -2, 3, -4, 5, -6, 7, -8, 9};
+  int32 output[9];
+  uint64 index[3];
+  size_t size;
+
+  /* replace manually set policy with one that has parameters allocated */
+  zfp_stream_set_execution(stream, zfp_exec_serial);
+  zfp_stream_set_reversible(stream);
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  assert_int_equal(zfp_stream_set_omp_index(stream, index, 3), 1);
+  assert_int_equal(zfp_stream_omp_chunks(stream, field), 2);
+
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, input);
+  size = zfp_compress(stream, field);
+  assert_int_not_equal(size, 0);
+  assert_int_equal(index[0], 0);
+  assert_true(index[1] <= index[2]);
+
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, output);
+  assert_int_equal(zfp_decompress(stream, field), size);
+  assert_memory_equal(output, input, sizeof(input));
 }
 
 #else
@@ -200,7 +236,9 @@ int main()
     cmocka_unit_test_setup_teardown(given_withOpenMP_when_setOmpChunkSize_expect_set, setup, teardown),
     cmocka_unit_test_setup_teardown(given_withOpenMP_serialExec_when_setOmpChunkSize_expect_setToExecOmp, setup, teardown),
 
-    cmocka_unit_test_setup_teardown(given_withOpenMP_whenDecompressOmpPolicy_expect_noop, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withOpenMP_when_setOmpIndex_expect_set, setup, teardown),
+
+    cmocka_unit_test_setup_teardown(given_withOpenMP_ompIndex_whenDecompressOmpPolicy_expect_matchesInput, setupForCompress, teardownForCompress),
 #else
     cmocka_unit_test_setup_teardown(given_withoutOpenMP_when_setExecutionOmp_expect_unableTo, setup, teardown),
     cmocka_unit_test_setup_teardown(given_withoutOpenMP_when_setOmpParams_expect_unableTo, setup, teardown),
@@ -0,0 +1,1143 @@
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <omp.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef ZFP_BLOCKS_FILE_IO
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+#define NX 32
+#define NY 24
+#define NZ 20
+#define NTHREADS 4
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  double* input;
+  double* output;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  size_t i;
+  assert_non_null(bundle);
+
+  bundle->input = malloc(NX * NY * NZ * sizeof(double));
+  bundle->output = malloc(NX * NY * NZ * sizeof(double));
+  assert_non_null(bundle->input);
+  assert_non_null(bundle->output);
+  for (i = 0; i < NX * NY * NZ; i++)
+    bundle->input[i] = (double)(i % 97) - 0.25 * (double)(i % 13);
+  memset(bundle->output, 0, NX * NY * NZ * sizeof(double));
+
+  bundle->field = zfp_field_3d(bundle->input, zfp_type_double, NX, NY, NZ);
+  assert_non_null(bundle->field);
+
+  bundle->stream = zfp_stream_open(NULL);
+  zfp_stream_set_reversible(bundle->stream);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+  bitstream* bs = zfp_stream_bit_stream(bundle->stream);
+
+  /* block containers are compressed to a buffer owned by their bit stream */
+  if (bs) {
+    free(stream_data(bs));
+    stream_close(bs);
+  }
+  zfp_stream_close(bundle->stream);
+  zfp_field_free(bundle->field);
+  free(bundle->input);
+  free(bundle->output);
+  free(bundle);
+
+  return 0;
+}
+
+/* compress field to a block container and decompress it to output */
+static void
+roundTripTo(struct setupVars *bundle, float blocksPerChunk, int method)
+{
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = bundle->field;
+  size_t bytes;
+
+  bytes = zfp_blocks_compress_single_stream(stream, field, NTHREADS, blocksPerChunk, method);
+  assert_int_not_equal(bytes, 0);
+
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, bundle->output);
+  assert_int_not_equal(zfp_blocks_decompress_single_stream(stream, field, NTHREADS), 0);
+  zfp_field_set_pointer(field, bundle->input);
+}
+
+/* losslessly compress field to a block container and decompress it */
+static void
+roundTrip(struct setupVars *bundle, float blocksPerChunk, int method)
+{
+  roundTripTo(bundle, blocksPerChunk, method);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+}
+
+/* compress field with blocks into a new buffer; returns buffer */
+static void*
+compressInternal(struct setupVars *bundle, zfp_blocks* blocks, size_t* bytes)
+{
+  zfp_stream* stream = bundle->stream;
+  size_t bufsize = zfp_stream_maximum_size_blocks(stream, bundle->field, blocks);
+  void* buffer = calloc(bufsize, 1);
+  bitstream* bs = stream_open(buffer, bufsize);
+  assert_non_null(buffer);
+
+  zfp_stream_set_bit_stream(stream, bs);
+  *bytes = zfp_blocks_compress_internal(stream, bundle->field, NTHREADS, blocks);
+  assert_int_not_equal(*bytes, 0);
+
+  zfp_stream_set_bit_stream(stream, NULL);
+  stream_close(bs);
+  return buffer;
+}
+
+/* compress field to a block container; returns copy of its bytes */
+static void*
+compressSingle(struct setupVars *bundle, int nthreads, int method, size_t* bytes)
+{
+  zfp_stream* stream = bundle->stream;
+  bitstream* bs;
+  void* copy;
+
+  *bytes = zfp_blocks_compress_single_stream(stream, bundle->field, nthreads, 4, method);
+  assert_int_not_equal(*bytes, 0);
+  copy = malloc(*bytes);
+  assert_non_null(copy);
+
+  bs = zfp_stream_bit_stream(stream);
+  memcpy(copy, stream_data(bs), *bytes);
+  free(stream_data(bs));
+  stream_close(bs);
+  zfp_stream_set_bit_stream(stream, NULL);
+  return copy;
+}
+
+/* sink appending to a growing buffer; fails once limit bytes are taken */
+struct memorySink {
+  unsigned char* data;
+  size_t size;
+  size_t capacity;
+  size_t limit;
+  int calls;
+};
+
+static size_t
+memorySinkWrite(void* context, const void* data, size_t bytes)
+{
+  struct memorySink* sink = context;
+  sink->calls++;
+  if (sink->size + bytes > sink->limit)
+    return 0;
+  if (sink->size + bytes > sink->capacity) {
+    sink->capacity = 2 * (sink->size + bytes);
+    sink->data = realloc(sink->data, sink->capacity);
+  }
+  memcpy(sink->data + sink->size, data, bytes);
+  sink->size += bytes;
+  return bytes;
+}
+
+static void
+given_3dCube_whenMakeEqualParts_expect_cubicChunks(void **state)
+{
+  size_t n[3] = {64, 64, 64};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 64, ZFP_MAKE_EQUAL);
+  (void)state;
+
+  assert_non_null(blocks);
+  assert_int_equal(blocks->bx, 4);
+  assert_int_equal(blocks->by, 4);
+  assert_int_equal(blocks->bz, 4);
+  assert_int_equal(blocks->nbeg, 64);
+
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_2dSquare_whenMakeEqualParts_expect_squareChunks(void **state)
+{
+  size_t n[2] = {64, 64};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(2, n, 64, ZFP_MAKE_EQUAL);
+  (void)state;
+
+  assert_non_null(blocks);
+  assert_int_equal(blocks->bx, 2);
+  assert_int_equal(blocks->by, 2);
+  assert_int_equal(blocks->nbeg, 4);
+
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_3dSlab_whenMakeEqualParts_expect_shortAxisKeptWhole(void **state)
+{
+  size_t n[3] = {8, 64, 256};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 64, ZFP_MAKE_EQUAL);
+  (void)state;
+
+  assert_non_null(blocks);
+  assert_int_equal(blocks->bx, 1);
+  assert_int_equal(blocks->nbeg, blocks->by * blocks->bz);
+  assert_true(blocks->nbeg >= 16);
+
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_extentBeyond32Bits_whenBreakAxis_expect_contiguousParts(void **state)
+{
+  size_t n = ((size_t)1 << 34) + 6;
+  size_t f[3], e[3];
+  int i;
+  (void)state;
+
+  zfp_break_axis(n, 3, f, e);
+  assert_int_equal(f[0], 0);
+  for (i = 0; i < 3; i++) {
+    assert_int_equal(f[i] % 4, 0);
+    assert_true(e[i] > f[i]);
+    assert_true(e[i] - f[i] >= n / 3 - 4 && e[i] - f[i] <= n / 3 + 8);
+    if (i)
+      assert_int_equal(f[i], e[i - 1]);
+  }
+  assert_int_equal(e[2], n);
+}
+
+static void
+given_extentBeyond32Bits_whenMakeEqualParts_expect_chunksCoverAxis(void **state)
+{
+  size_t n[1] = {((size_t)1 << 34) + 6};
+  size_t nblocks = (n[0] + 3) / 4;
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(1, n, (float)((size_t)1 << 28), ZFP_MAKE_EQUAL);
+  zfp_chunks* chunks;
+  size_t i;
+  (void)state;
+
+  /* 2^32 + 2 blocks in chunks of 2^28 blocks */
+  assert_non_null(blocks);
+  assert_int_equal(blocks->bx, (nblocks + ((size_t)1 << 28) - 1) >> 28);
+  assert_int_equal(blocks->nbeg, blocks->bx);
+
+  chunks = zfp_chunks_from_blocks(1, n, blocks);
+  assert_int_equal(chunks->nchunks, blocks->nbeg);
+  assert_int_equal(chunks->chunks[0]->fx, 0);
+  for (i = 1; i < chunks->nchunks; i++)
+    assert_int_equal(chunks->chunks[i]->fx, chunks->chunks[i - 1]->ex);
+  assert_int_equal(chunks->chunks[chunks->nchunks - 1]->ex, n[0]);
+
+  zfp_chunks_free(chunks);
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_3dField_whenCompressMakeEqual_expect_roundTrip(void **state)
+{
+  roundTrip(*state, 16, ZFP_MAKE_EQUAL);
+}
+
+static void
+given_3dField_whenCompressBestCache_expect_roundTrip(void **state)
+{
+  roundTrip(*state, 16, ZFP_BEST_CACHE);
+}
+
+static void
+given_chunkCosts_whenCompressInternal_expect_sameStreamAsSampledCosts(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n[3] = {NX, NY, NZ};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 4, ZFP_MAKE_EQUAL);
+  size_t bytes, costBytes, i;
+  void* sampled;
+  void* given;
+  assert_true(blocks->nbeg > 1);
+
+  /* costs sampled from field */
+  sampled = compressInternal(bundle, blocks, &bytes);
+
+  /* costs that reverse the order in which chunks are handed out */
+  blocks->costs = malloc(blocks->nbeg * sizeof(size_t));
+  for (i = 0; i < blocks->nbeg; i++)
+    blocks->costs[i] = i;
+  given = compressInternal(bundle, blocks, &costBytes);
+
+  assert_int_equal(costBytes, bytes);
+  assert_memory_equal(given, sampled, bytes);
+
+  free(sampled);
+  free(given);
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_compressedBlocks_whenCostsFromBegs_expect_chunkSizes(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n[3] = {NX, NY, NZ};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 4, ZFP_MAKE_EQUAL);
+  size_t bytes, i;
+  void* buffer = compressInternal(bundle, blocks, &bytes);
+
+  zfp_blocks_costs_from_begs(blocks);
+  assert_non_null(blocks->costs);
+  for (i = 0; i < blocks->nbeg; i++) {
+    assert_int_equal(blocks->costs[i], blocks->begs[i + 1] - blocks->begs[i]);
+    assert_int_not_equal(blocks->costs[i], 0);
+  }
+
+  free(buffer);
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_compressedBlocks_whenDecompress_expect_roundTripAndBusyThreads(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n[3] = {NX, NY, NZ};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 4, ZFP_MAKE_EQUAL);
+  double busy = 0;
+  size_t bytes;
+  int i;
+  void* buffer = compressInternal(bundle, blocks, &bytes);
+  bitstream* bs = stream_open(buffer, bytes);
+
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  zfp_field_set_pointer(bundle->field, bundle->output);
+  assert_int_equal(zfp_blocks_decompress(bundle->stream, bundle->field, NTHREADS, blocks), bytes);
+  zfp_field_set_pointer(bundle->field, bundle->input);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  /* every chunk was timed by one of the threads */
+  assert_int_equal(blocks->nbusy, NTHREADS);
+  for (i = 0; i < NTHREADS; i++) {
+    assert_true(zfp_blocks_thread_busy(blocks, i) >= 0);
+    busy += zfp_blocks_thread_busy(blocks, i);
+  }
+  assert_true(busy > 0);
+  assert_true(zfp_blocks_thread_busy(blocks, -1) == 0);
+  assert_true(zfp_blocks_thread_busy(blocks, NTHREADS) == 0);
+
+  zfp_stream_set_bit_stream(bundle->stream, NULL);
+  stream_close(bs);
+  free(buffer);
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_compressedBlocks_whenCompressAndDecompress_expect_ompThreadCountUnchanged(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n[3] = {NX, NY, NZ};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 4, ZFP_MAKE_EQUAL);
+  int nthreads = omp_get_max_threads();
+  size_t bytes;
+  void* buffer;
+  bitstream* bs;
+
+  omp_set_num_threads(NTHREADS + 1);
+  buffer = compressInternal(bundle, blocks, &bytes);
+  assert_int_equal(omp_get_max_threads(), NTHREADS + 1);
+  assert_int_equal(blocks->nbusy, NTHREADS);
+
+  bs = stream_open(buffer, bytes);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  zfp_field_set_pointer(bundle->field, bundle->output);
+  assert_int_equal(zfp_blocks_decompress(bundle->stream, bundle->field, NTHREADS, blocks), bytes);
+  zfp_field_set_pointer(bundle->field, bundle->input);
+  assert_int_equal(omp_get_max_threads(), NTHREADS + 1);
+  assert_int_equal(blocks->nbusy, NTHREADS);
+
+  omp_set_num_threads(nthreads);
+  zfp_stream_set_bit_stream(bundle->stream, NULL);
+  stream_close(bs);
+  free(buffer);
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_compressInternal_expect_wordAlignedChunks(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n[3] = {NX, NY, NZ};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 4, ZFP_MAKE_EQUAL);
+  size_t bytes, i;
+  void* buffer = compressInternal(bundle, blocks, &bytes);
+
+  for (i = 0; i <= blocks->nbeg; i++)
+    assert_int_equal(blocks->begs[i] % stream_word_bits, 0);
+  assert_int_equal(blocks->begs[blocks->nbeg], 8 * bytes);
+
+  free(buffer);
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_singleStream_whenCompressWithOneOrManyThreads_expect_sameBytes(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t serialBytes, parallelBytes;
+  void* serial = compressSingle(bundle, 1, ZFP_MAKE_EQUAL, &serialBytes);
+  void* parallel = compressSingle(bundle, NTHREADS, ZFP_MAKE_EQUAL, &parallelBytes);
+
+  assert_int_equal(parallelBytes, serialBytes);
+  assert_memory_equal(parallel, serial, serialBytes);
+
+  free(serial);
+  free(parallel);
+}
+
+static void
+given_fixedRate_whenCompressSingleStream_expect_sameValuesAsSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = bundle->field;
+  size_t bufsize, i;
+  double* expected = malloc(NX * NY * NZ * sizeof(double));
+  void* buffer;
+  bitstream* bs;
+  assert_non_null(expected);
+
+  /* chunks hold whole blocks, which fixed-rate mode encodes alike */
+  zfp_stream_set_rate(stream, 12, zfp_type_double, 3, zfp_false);
+  bufsize = zfp_stream_maximum_size(stream, field);
+  buffer = malloc(bufsize);
+  bs = stream_open(buffer, bufsize);
+  zfp_stream_set_bit_stream(stream, bs);
+  zfp_stream_set_execution(stream, zfp_exec_serial);
+  assert_int_not_equal(zfp_compress(stream, field), 0);
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, expected);
+  assert_int_not_equal(zfp_decompress(stream, field), 0);
+  zfp_field_set_pointer(field, bundle->input);
+  zfp_stream_set_bit_stream(stream, NULL);
+  stream_close(bs);
+  free(buffer);
+
+  roundTripTo(bundle, 16, ZFP_MAKE_EQUAL);
+  for (i = 0; i < NX * NY * NZ; i++)
+    assert_true(bundle->output[i] == expected[i]);
+
+  free(expected);
+}
+
+static void
+given_sink_whenCompressToSink_expect_singleStreamRoundTrip(void **state)
+{
+  struct setupVars *bundle = *state;
+  struct memorySink sink = {NULL, 0, 0, (size_t)-1, 0};
+  bitstream* bs;
+  size_t bytes;
+
+  /* one block per chunk, so the ring of slots is reused many times */
+  bytes = zfp_blocks_compress_to_sink(bundle->stream, bundle->field, NTHREADS, 1, ZFP_MAKE_EQUAL, memorySinkWrite, &sink);
+  assert_int_not_equal(bytes, 0);
+  assert_int_equal(bytes, sink.size);
+  assert_true(sink.calls > 2);
+
+  bs = stream_open(sink.data, sink.size);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  zfp_field_set_pointer(bundle->field, bundle->output);
+  assert_int_not_equal(zfp_blocks_decompress_single_stream(bundle->stream, bundle->field, NTHREADS), 0);
+  zfp_field_set_pointer(bundle->field, bundle->input);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  zfp_stream_set_bit_stream(bundle->stream, NULL);
+  stream_close(bs);
+  free(sink.data);
+}
+
+static void
+given_failingSink_whenCompressToSink_expect_zero(void **state)
+{
+  struct setupVars *bundle = *state;
+  struct memorySink sink = {NULL, 0, 0, 1000, 0};
+
+  assert_int_equal(zfp_blocks_compress_to_sink(bundle->stream, bundle->field, NTHREADS, 1, ZFP_MAKE_EQUAL, memorySinkWrite, &sink), 0);
+  assert_true(sink.size <= 1000);
+
+  free(sink.data);
+}
+
+/* compress field to a single-stream container owned by the stream */
+static size_t
+compressToStream(struct setupVars *bundle)
+{
+  size_t bytes = zfp_blocks_compress_single_stream(bundle->stream, bundle->field, NTHREADS, 16, ZFP_MAKE_EQUAL);
+  assert_int_not_equal(bytes, 0);
+  zfp_stream_rewind(bundle->stream);
+  return bytes;
+}
+
+/* value of input at (x, y, z) */
+static double
+inputAt(struct setupVars *bundle, size_t x, size_t y, size_t z)
+{
+  return bundle->input[x + NX * (y + NY * z)];
+}
+
+static void
+given_box_whenDecompressRegion_expect_subBoxOfInput(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_chunk box = {5, 3, 2, 0, 29, 17, 11, 1};
+  size_t mx = 24, my = 14, mz = 9;
+  size_t x, y, z, total;
+  zfp_field* region = zfp_field_3d(bundle->output, zfp_type_double, mx, my, mz);
+
+  total = compressToStream(bundle);
+  assert_int_not_equal(zfp_blocks_decompress_region(bundle->stream, region, &box, NTHREADS), 0);
+
+  for (z = 0; z < mz; z++)
+    for (y = 0; y < my; y++)
+      for (x = 0; x < mx; x++)
+        assert_true(bundle->output[x + mx * (y + my * z)] == inputAt(bundle, 5 + x, 3 + y, 2 + z));
+
+  /* a box within one chunk reads only that chunk */
+  box.ex = 6;
+  box.ey = 4;
+  box.ez = 3;
+  zfp_field_set_size_3d(region, 1, 1, 1);
+  assert_true(zfp_blocks_decompress_region(bundle->stream, region, &box, NTHREADS) < total);
+  assert_true(bundle->output[0] == inputAt(bundle, 5, 3, 2));
+
+  zfp_field_free(region);
+}
+
+static void
+given_stridedDestination_whenDecompressRegion_expect_transposedSubBox(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_chunk box = {8, 0, 4, 0, 24, 24, 8, 1};
+  size_t mx = 16, my = 24, mz = 4;
+  size_t x, y, z;
+  zfp_field* region = zfp_field_3d(bundle->output, zfp_type_double, mx, my, mz);
+
+  /* x varies slowest in destination */
+  zfp_field_set_stride_3d(region, (ptrdiff_t)(my * mz), (ptrdiff_t)mz, 1);
+  compressToStream(bundle);
+  assert_int_not_equal(zfp_blocks_decompress_region(bundle->stream, region, &box, NTHREADS), 0);
+
+  for (z = 0; z < mz; z++)
+    for (y = 0; y < my; y++)
+      for (x = 0; x < mx; x++)
+        assert_true(bundle->output[z + mz * (y + my * x)] == inputAt(bundle, 8 + x, y, 4 + z));
+
+  zfp_field_free(region);
+}
+
+static void
+given_prefixedContainer_whenDecompressRegion_expect_subBoxAndPositionKept(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_chunk box = {4, 4, 4, 0, 20, 12, 8, 1};
+  size_t mx = 16, my = 8, mz = 4;
+  size_t x, y, z, total;
+  zfp_field* region = zfp_field_3d(bundle->output, zfp_type_double, mx, my, mz);
+  bitstream* bs;
+  uchar* buffer;
+
+  /* place container after a 64-bit word that the caller has already read */
+  total = compressToStream(bundle);
+  bs = zfp_stream_bit_stream(bundle->stream);
+  buffer = calloc(total + sizeof(uint64), 1);
+  assert_non_null(buffer);
+  memcpy(buffer + sizeof(uint64), stream_data(bs), total);
+  free(stream_data(bs));
+  stream_close(bs);
+  bs = stream_open(buffer, total + sizeof(uint64));
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  stream_read_bits(bs, 64);
+
+  assert_int_not_equal(zfp_blocks_decompress_region(bundle->stream, region, &box, NTHREADS), 0);
+  assert_int_equal(stream_rtell(bs), 64);
+  for (z = 0; z < mz; z++)
+    for (y = 0; y < my; y++)
+      for (x = 0; x < mx; x++)
+        assert_true(bundle->output[x + mx * (y + my * z)] == inputAt(bundle, 4 + x, 4 + y, 4 + z));
+
+  /* region decompression can be repeated from the same position */
+  memset(bundle->output, 0, mx * my * mz * sizeof(double));
+  assert_int_not_equal(zfp_blocks_decompress_region(bundle->stream, region, &box, NTHREADS), 0);
+  assert_true(bundle->output[0] == inputAt(bundle, 4, 4, 4));
+
+  zfp_field_free(region);
+}
+
+static void
+given_mismatchedDestination_whenDecompressRegion_expect_zero(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_chunk box = {0, 0, 0, 0, 8, 8, 8, 1};
+  zfp_field* region = zfp_field_3d(bundle->output, zfp_type_double, 8, 8, 4);
+
+  compressToStream(bundle);
+  assert_int_equal(zfp_blocks_decompress_region(bundle->stream, region, &box, NTHREADS), 0);
+
+  /* stored scalar type must match */
+  zfp_field_set_size_3d(region, 8, 8, 8);
+  zfp_field_set_type(region, zfp_type_float);
+  assert_int_equal(zfp_blocks_decompress_region(bundle->stream, region, &box, NTHREADS), 0);
+
+  zfp_field_free(region);
+}
+
+/* min, max, and mean of input within chunk */
+static void
+chunkStats(struct setupVars *bundle, const zfp_chunk* chunk, double* stats)
+{
+  double sum = 0;
+  size_t x, y, z;
+  stats[0] = HUGE_VAL;
+  stats[1] = -HUGE_VAL;
+  for (z = chunk->fz; z < chunk->ez; z++)
+    for (y = chunk->fy; y < chunk->ey; y++)
+      for (x = chunk->fx; x < chunk->ex; x++) {
+        double v = inputAt(bundle, x, y, z);
+        stats[0] = v < stats[0] ? v : stats[0];
+        stats[1] = v > stats[1] ? v : stats[1];
+        sum += v;
+      }
+  stats[2] = sum / (double)((chunk->ex - chunk->fx) * (chunk->ey - chunk->fy) * (chunk->ez - chunk->fz));
+}
+
+static void
+given_statsEnabled_whenCompressInternal_expect_chunkMinMaxMean(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n[3] = {NX, NY, NZ};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 4, ZFP_MAKE_EQUAL);
+  zfp_chunks* chunks = zfp_chunks_from_blocks(3, n, blocks);
+  size_t bytes, i;
+  void* buffer;
+
+  zfp_blocks_enable_stats(blocks);
+  buffer = compressInternal(bundle, blocks, &bytes);
+  for (i = 0; i < chunks->nchunks; i++) {
+    double expected[3];
+    const double* stats = blocks->stats + 3 * i;
+    chunkStats(bundle, chunks->chunks[i], expected);
+    assert_true(stats[0] == expected[0]);
+    assert_true(stats[1] == expected[1]);
+    assert_true(fabs(stats[2] - expected[2]) <= 1e-12 * fabs(expected[2]) + 1e-12);
+  }
+
+  free(buffer);
+  zfp_chunks_free(chunks);
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_chunkStats_whenChunksInRange_expect_chunksHoldingPlane(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n[3] = {NX, NY, NZ};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 4, ZFP_MAKE_EQUAL);
+  zfp_chunks* chunks = zfp_chunks_from_blocks(3, n, blocks);
+  size_t* ichunks = malloc(blocks->nbeg * sizeof(size_t));
+  size_t bytes, count, expected, i;
+  void* buffer;
+
+  /* values lie in [z, z + 0.5) */
+  for (i = 0; i < NX * NY * NZ; i++)
+    bundle->input[i] = (double)(i / (NX * NY)) + 0.5 * (double)(i % NX) / NX;
+
+  /* without stats, every chunk may hold values in range */
+  assert_int_equal(zfp_blocks_chunks_in_range(blocks, 10, 10.2, NULL), blocks->nbeg);
+
+  zfp_blocks_enable_stats(blocks);
+  buffer = compressInternal(bundle, blocks, &bytes);
+  count = zfp_blocks_chunks_in_range(blocks, 10, 10.2, ichunks);
+  for (i = 0, expected = 0; i < chunks->nchunks; i++)
+    if (chunks->chunks[i]->fz <= 10 && 10 < chunks->chunks[i]->ez) {
+      assert_true(expected < count);
+      assert_int_equal(ichunks[expected++], i);
+    }
+  assert_int_equal(count, expected);
+  assert_true(count < blocks->nbeg);
+  assert_int_equal(zfp_blocks_chunks_in_range(blocks, 100, 200, NULL), 0);
+
+  free(buffer);
+  free(ichunks);
+  zfp_chunks_free(chunks);
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_plan_whenCompress_expect_singleStreamContainer(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_plan* plan = zfp_plan_create(bundle->stream, bundle->field, NTHREADS, 4, ZFP_MAKE_EQUAL);
+  size_t bytes;
+  void* container = compressSingle(bundle, NTHREADS, ZFP_MAKE_EQUAL, &bytes);
+
+  assert_non_null(plan);
+  assert_int_equal(zfp_plan_compress(plan, bundle->input), bytes);
+  assert_memory_equal(plan->buffer, container, bytes);
+
+  zfp_plan_free(plan);
+  free(container);
+}
+
+static void
+given_plan_whenCompressRepeatedly_expect_roundTripOfEachField(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_plan* plan = zfp_plan_create(bundle->stream, bundle->field, NTHREADS, 4, ZFP_MAKE_EQUAL);
+  double* other = malloc(NX * NY * NZ * sizeof(double));
+  size_t i;
+  for (i = 0; i < NX * NY * NZ; i++)
+    other[i] = 1e3 * (double)(i % 7) - (double)i;
+
+  assert_int_not_equal(zfp_plan_compress(plan, bundle->input), 0);
+  assert_int_not_equal(zfp_plan_decompress(plan, bundle->output), 0);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  assert_int_not_equal(zfp_plan_compress(plan, other), 0);
+  assert_int_not_equal(zfp_plan_decompress(plan, bundle->output), 0);
+  assert_memory_equal(bundle->output, other, NX * NY * NZ * sizeof(double));
+
+  zfp_plan_free(plan);
+  free(other);
+}
+
+static void
+given_plan_whenDecompressOtherContainer_expect_zero(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_plan* plan = zfp_plan_create(bundle->stream, bundle->field, NTHREADS, 4, ZFP_MAKE_EQUAL);
+  zfp_plan* other = zfp_plan_create(bundle->stream, bundle->field, NTHREADS, 16, ZFP_MAKE_EQUAL);
+  size_t bytes = zfp_plan_compress(other, bundle->input);
+
+  /* container written with a different chunk grid */
+  memcpy(plan->buffer, other->buffer, bytes);
+  assert_int_equal(zfp_plan_decompress(plan, bundle->output), 0);
+
+  /* nothing written yet */
+  memset(plan->buffer, 0, plan->bytes);
+  assert_int_equal(zfp_plan_decompress(plan, bundle->output), 0);
+
+  zfp_plan_free(plan);
+  zfp_plan_free(other);
+}
+
+static void
+given_plan_whenCompress_expect_ompThreadCountUnchanged(void **state)
+{
+  struct setupVars *bundle = *state;
+  int nthreads = omp_get_max_threads();
+  zfp_plan* plan;
+
+  omp_set_num_threads(NTHREADS + 1);
+  plan = zfp_plan_create(bundle->stream, bundle->field, NTHREADS, 4, ZFP_MAKE_EQUAL);
+  assert_int_not_equal(zfp_plan_compress(plan, bundle->input), 0);
+  assert_int_not_equal(zfp_plan_decompress(plan, bundle->output), 0);
+  assert_int_equal(omp_get_max_threads(), NTHREADS + 1);
+  assert_int_equal(plan->blocks->nbusy, NTHREADS);
+
+  omp_set_num_threads(nthreads);
+  zfp_plan_free(plan);
+}
+
+static void
+given_numaFlags_whenCompressSingleStream_expect_sameBytesAsDynamic(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t bytes, numaBytes, pinBytes;
+  void* dynamic = compressSingle(bundle, NTHREADS, ZFP_MAKE_EQUAL, &bytes);
+  void* numa = compressSingle(bundle, NTHREADS, ZFP_MAKE_EQUAL | ZFP_BLOCKS_NUMA, &numaBytes);
+  void* pinned = compressSingle(bundle, NTHREADS, ZFP_MAKE_EQUAL | ZFP_BLOCKS_NUMA | ZFP_BLOCKS_PIN, &pinBytes);
+
+  assert_int_equal(numaBytes, bytes);
+  assert_int_equal(pinBytes, bytes);
+  assert_memory_equal(numa, dynamic, bytes);
+  assert_memory_equal(pinned, dynamic, bytes);
+
+  free(dynamic);
+  free(numa);
+  free(pinned);
+}
+
+static void
+given_numaPlan_whenCompress_expect_fixedRunsPerThread(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_plan* plan = zfp_plan_create(bundle->stream, bundle->field, NTHREADS, 4, ZFP_MAKE_EQUAL | ZFP_BLOCKS_NUMA);
+  size_t runs[NTHREADS + 1];
+  int i;
+
+  assert_int_equal(plan->blocks->affinity, ZFP_BLOCKS_NUMA);
+  assert_int_not_equal(zfp_plan_compress(plan, bundle->input), 0);
+  memcpy(runs, plan->runs, sizeof(runs));
+  assert_int_equal(runs[0], 0);
+  assert_int_equal(runs[NTHREADS], plan->chunks->nchunks);
+  for (i = 0; i < NTHREADS; i++)
+    assert_true(runs[i] < runs[i + 1]);
+
+  /* every call hands each thread the same run of chunks */
+  assert_int_not_equal(zfp_plan_decompress(plan, bundle->output), 0);
+  assert_memory_equal(plan->runs, runs, sizeof(runs));
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  zfp_plan_free(plan);
+}
+
+#ifdef ZFP_BLOCKS_FILE_IO
+/* write bytes to a new temporary file whose name is stored in path */
+static void
+writeTempFile(char* path, const void* data, size_t bytes)
+{
+  int fd;
+  strcpy(path, "/tmp/testOmpBlocksXXXXXX");
+  fd = mkstemp(path);
+  assert_true(fd >= 0);
+  assert_int_equal(write(fd, data, bytes), bytes);
+  close(fd);
+}
+
+static void
+given_containerFile_whenMapOpen_expect_roundTrip(void **state)
+{
+  struct setupVars *bundle = *state;
+  char path[64];
+  size_t bytes;
+  void* container = compressSingle(bundle, NTHREADS, ZFP_MAKE_EQUAL, &bytes);
+  zfp_blocks_map* map;
+  zfp_chunk box = {0, 0, 0, 0, 4, 4, 4, 1};
+
+  writeTempFile(path, container, bytes);
+  map = zfp_blocks_map_open(path);
+  assert_non_null(map);
+  assert_int_equal(map->bytes, bytes);
+  assert_int_equal(zfp_field_size(map->field, NULL), NX * NY * NZ);
+  assert_int_equal(map->field->type, zfp_type_double);
+
+  /* all chunks, or only the one holding the first block */
+  assert_int_equal(zfp_blocks_map_advise(map, NULL), map->blocks->nbeg);
+  assert_int_equal(zfp_blocks_map_advise(map, &box), 1);
+
+  zfp_field_set_pointer(bundle->field, bundle->output);
+  assert_int_not_equal(zfp_blocks_decompress_single_stream(map->stream, bundle->field, NTHREADS), 0);
+  zfp_field_set_pointer(bundle->field, bundle->input);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  zfp_blocks_map_close(map);
+  unlink(path);
+  free(container);
+}
+
+static void
+given_truncatedOrMissingFile_whenMapOpen_expect_null(void **state)
+{
+  struct setupVars *bundle = *state;
+  char path[64];
+  size_t bytes;
+  void* container = compressSingle(bundle, NTHREADS, ZFP_MAKE_EQUAL, &bytes);
+
+  /* chunks extend past end of file */
+  writeTempFile(path, container, bytes / 2);
+  assert_null(zfp_blocks_map_open(path));
+  unlink(path);
+
+  assert_null(zfp_blocks_map_open(path));
+  free(container);
+}
+
+static void
+given_statsFlag_whenMapOpen_expect_statsFromHeader(void **state)
+{
+  struct setupVars *bundle = *state;
+  size_t n[3] = {NX, NY, NZ};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 4, ZFP_MAKE_EQUAL);
+  char path[64];
+  size_t bytes, internalBytes;
+  void* container = compressSingle(bundle, NTHREADS, ZFP_MAKE_EQUAL | ZFP_BLOCKS_STATS, &bytes);
+  void* buffer;
+  zfp_blocks_map* map;
+
+  zfp_blocks_enable_stats(blocks);
+  buffer = compressInternal(bundle, blocks, &internalBytes);
+
+  writeTempFile(path, container, bytes);
+  map = zfp_blocks_map_open(path);
+  assert_non_null(map);
+  assert_non_null(map->blocks->stats);
+  assert_int_equal(map->blocks->nbeg, blocks->nbeg);
+  assert_memory_equal(map->blocks->stats, blocks->stats, 3 * blocks->nbeg * sizeof(double));
+
+  /* stats do not change how chunks decode */
+  zfp_field_set_pointer(bundle->field, bundle->output);
+  assert_int_not_equal(zfp_blocks_decompress_single_stream(map->stream, bundle->field, NTHREADS), 0);
+  zfp_field_set_pointer(bundle->field, bundle->input);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  zfp_blocks_map_close(map);
+  unlink(path);
+  free(buffer);
+  free(container);
+  zfp_blocks_free(blocks);
+}
+
+#define OFFSET 100
+
+static void
+given_fd_whenCompressToFdAtOffset_expect_singleStreamAfterPrefix(void **state)
+{
+  struct setupVars *bundle = *state;
+  unsigned char prefix[OFFSET];
+  unsigned char* data;
+  char path[64];
+  size_t bytes, fdBytes;
+  void* container = compressSingle(bundle, NTHREADS, ZFP_MAKE_EQUAL, &bytes);
+  zfp_field* field = zfp_field_alloc();
+  int fd;
+
+  memset(prefix, 0x5a, OFFSET);
+  writeTempFile(path, prefix, OFFSET);
+  fd = open(path, O_RDWR);
+  assert_true(fd >= 0);
+  fdBytes = zfp_blocks_compress_to_fd(bundle->stream, bundle->field, NTHREADS, 4, ZFP_MAKE_EQUAL, fd, OFFSET);
+  assert_int_equal(fdBytes, bytes);
+
+  /* prefix is kept and container is laid out as in memory */
+  data = malloc(OFFSET + bytes);
+  assert_int_equal(pread(fd, data, OFFSET + bytes, 0), OFFSET + bytes);
+  assert_memory_equal(data, prefix, OFFSET);
+  assert_memory_equal(data + OFFSET, container, bytes);
+
+  /* field metadata comes from header */
+  zfp_field_set_pointer(field, bundle->output);
+  assert_int_equal(zfp_blocks_decompress_from_fd(field, NTHREADS, fd, OFFSET), bytes);
+  assert_int_equal(field->type, zfp_type_double);
+  assert_int_equal(zfp_field_size(field, NULL), NX * NY * NZ);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  close(fd);
+  unlink(path);
+  zfp_field_free(field);
+  free(data);
+  free(container);
+}
+
+static void
+given_sinkWrittenFile_whenDecompressFromFd_expect_roundTrip(void **state)
+{
+  struct setupVars *bundle = *state;
+  struct memorySink sink = {NULL, 0, 0, (size_t)-1, 0};
+  zfp_field* field = zfp_field_alloc();
+  char path[64];
+  int fd;
+
+  /* begs trail the chunks of a streamed container */
+  assert_int_not_equal(zfp_blocks_compress_to_sink(bundle->stream, bundle->field, NTHREADS, 4, ZFP_MAKE_EQUAL, memorySinkWrite, &sink), 0);
+  writeTempFile(path, sink.data, sink.size);
+  fd = open(path, O_RDONLY);
+  assert_true(fd >= 0);
+
+  zfp_field_set_pointer(field, bundle->output);
+  assert_int_not_equal(zfp_blocks_decompress_from_fd(field, NTHREADS, fd, 0), 0);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  close(fd);
+  unlink(path);
+  zfp_field_free(field);
+  free(sink.data);
+}
+#endif
+
+static void
+given_32BitHeader_whenDecompressSingleStream_expect_roundTrip(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = bundle->field;
+  size_t n[3] = {NX, NY, NZ};
+  zfp_blocks* blocks = zfp_optimal_parts_from_size(3, n, 16, ZFP_MAKE_EQUAL);
+  size_t bytes, header, i;
+  void* chunks = compressInternal(bundle, blocks, &bytes);
+  void* buffer;
+  bitstream* bs;
+
+  /* container in the layout written before extents were 64 bits wide */
+  header = (ZFP_HEADER_BLOCKS_V1_BITS + 64 * (blocks->nbeg + 1)) / 8;
+  buffer = calloc(header + bytes, 1);
+  bs = stream_open(buffer, header + bytes);
+  zfp_stream_set_bit_stream(stream, bs);
+  zfp_write_header(stream, field, ZFP_HEADER_MAGIC);
+  stream_write_bits(bs, zfp_type_double, 8);
+  stream_write_bits(bs, NX, 32);
+  stream_write_bits(bs, NY, 32);
+  stream_write_bits(bs, NZ, 32);
+  stream_write_bits(bs, 0, 32);
+  stream_write_bits(bs, zfp_stream_mode(stream), ZFP_MODE_LONG_BITS);
+  stream_write_bits(bs, blocks->nbeg, 32);
+  stream_write_bits(bs, blocks->bx, 32);
+  stream_write_bits(bs, blocks->by, 32);
+  stream_write_bits(bs, blocks->bz, 32);
+  stream_write_bits(bs, blocks->bw, 32);
+  for (i = 0; i <= blocks->nbeg; i++)
+    stream_write_bits(bs, 8 * header + blocks->begs[i], 64);
+  stream_flush(bs);
+  assert_int_equal(stream_size(bs), header);
+  memcpy((unsigned char*)buffer + header, chunks, bytes);
+
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, bundle->output);
+  assert_int_not_equal(zfp_blocks_decompress_single_stream(stream, field, NTHREADS), 0);
+  zfp_field_set_pointer(field, bundle->input);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  zfp_stream_set_bit_stream(stream, NULL);
+  stream_close(bs);
+  free(buffer);
+  free(chunks);
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_contiguousField_whenPartsForThreads_expect_rowsAlongUnitStride(void **state)
+{
+  struct setupVars *bundle = *state;
+  /* 8 * 6 * 5 blocks shared by NTHREADS threads, several chunks each */
+  zfp_blocks* blocks = zfp_optimal_parts_for_threads(bundle->field, NTHREADS, 0);
+
+  assert_non_null(blocks);
+  assert_true(blocks->nbeg >= 4 * NTHREADS);
+  assert_int_equal(blocks->bx, 1);
+  assert_int_equal(blocks->nbeg, blocks->bx * blocks->by * blocks->bz);
+
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_smallCache_whenPartsForThreads_expect_chunksFitCache(void **state)
+{
+  struct setupVars *bundle = *state;
+  /* 2048 bytes hold four 4*4*4 blocks of doubles */
+  zfp_blocks* blocks = zfp_optimal_parts_for_threads(bundle->field, NTHREADS, 2048);
+
+  assert_non_null(blocks);
+  assert_int_equal(blocks->bx, 2);
+  assert_int_equal(blocks->by, 6);
+  assert_int_equal(blocks->bz, 5);
+
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_transposedField_whenPartsForThreads_expect_chunksAlongSmallestStride(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_blocks* blocks;
+
+  /* z has unit stride, x the largest */
+  zfp_field_set_stride_3d(bundle->field, NY * NZ, NZ, 1);
+  blocks = zfp_optimal_parts_for_threads(bundle->field, NTHREADS, 0);
+
+  assert_non_null(blocks);
+  assert_int_equal(blocks->bz, 1);
+  assert_int_equal(blocks->bx, NX / 4);
+
+  zfp_blocks_free(blocks);
+}
+
+static void
+given_autotunedParts_whenCompressInternal_expect_roundTrip(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_blocks* blocks = zfp_autotune_parts(bundle->stream, bundle->field, NTHREADS, 0);
+  size_t bytes;
+  void* buffer;
+  bitstream* bs;
+
+  assert_non_null(blocks);
+  assert_true(blocks->nbeg >= 1);
+  buffer = compressInternal(bundle, blocks, &bytes);
+
+  bs = stream_open(buffer, bytes);
+  zfp_stream_set_bit_stream(bundle->stream, bs);
+  zfp_field_set_pointer(bundle->field, bundle->output);
+  assert_int_equal(zfp_blocks_decompress(bundle->stream, bundle->field, NTHREADS, blocks), bytes);
+  zfp_field_set_pointer(bundle->field, bundle->input);
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+
+  zfp_stream_set_bit_stream(bundle->stream, NULL);
+  stream_close(bs);
+  free(buffer);
+  zfp_blocks_free(blocks);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test(given_3dCube_whenMakeEqualParts_expect_cubicChunks),
+    cmocka_unit_test(given_2dSquare_whenMakeEqualParts_expect_squareChunks),
+    cmocka_unit_test(given_3dSlab_whenMakeEqualParts_expect_shortAxisKeptWhole),
+    cmocka_unit_test(given_extentBeyond32Bits_whenBreakAxis_expect_contiguousParts),
+    cmocka_unit_test(given_extentBeyond32Bits_whenMakeEqualParts_expect_chunksCoverAxis),
+
+    cmocka_unit_test_setup_teardown(given_contiguousField_whenPartsForThreads_expect_rowsAlongUnitStride, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_smallCache_whenPartsForThreads_expect_chunksFitCache, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_transposedField_whenPartsForThreads_expect_chunksAlongSmallestStride, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_autotunedParts_whenCompressInternal_expect_roundTrip, setup, teardown),
+
+    cmocka_unit_test_setup_teardown(given_3dField_whenCompressMakeEqual_expect_roundTrip, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_3dField_whenCompressBestCache_expect_roundTrip, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_chunkCosts_whenCompressInternal_expect_sameStreamAsSampledCosts, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_compressedBlocks_whenCostsFromBegs_expect_chunkSizes, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_compressedBlocks_whenDecompress_expect_roundTripAndBusyThreads, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_compressedBlocks_whenCompressAndDecompress_expect_ompThreadCountUnchanged, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_compressInternal_expect_wordAlignedChunks, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_singleStream_whenCompressWithOneOrManyThreads_expect_sameBytes, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fixedRate_whenCompressSingleStream_expect_sameValuesAsSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_sink_whenCompressToSink_expect_singleStreamRoundTrip, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_failingSink_whenCompressToSink_expect_zero, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_box_whenDecompressRegion_expect_subBoxOfInput, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_stridedDestination_whenDecompressRegion_expect_transposedSubBox, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_prefixedContainer_whenDecompressRegion_expect_subBoxAndPositionKept, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_mismatchedDestination_whenDecompressRegion_expect_zero, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_32BitHeader_whenDecompressSingleStream_expect_roundTrip, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_statsEnabled_whenCompressInternal_expect_chunkMinMaxMean, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_chunkStats_whenChunksInRange_expect_chunksHoldingPlane, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_plan_whenCompress_expect_singleStreamContainer, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_plan_whenCompressRepeatedly_expect_roundTripOfEachField, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_plan_whenDecompressOtherContainer_expect_zero, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_plan_whenCompress_expect_ompThreadCountUnchanged, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_numaFlags_whenCompressSingleStream_expect_sameBytesAsDynamic, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_numaPlan_whenCompress_expect_fixedRunsPerThread, setup, teardown),
+#ifdef ZFP_BLOCKS_FILE_IO
+    cmocka_unit_test_setup_teardown(given_containerFile_whenMapOpen_expect_roundTrip, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_truncatedOrMissingFile_whenMapOpen_expect_null, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_fd_whenCompressToFdAtOffset_expect_singleStreamAfterPrefix, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_sinkWrittenFile_whenDecompressFromFd_expect_roundTrip, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_statsFlag_whenMapOpen_expect_statsFromHeader, setup, teardown),
+#endif
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,244 @@
+/* exercise block container modes of the zfp command-line tool */
+#define main zfp_main
+#include "utils/zfp.c"
+#undef main
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NX 32
+#define NY 24
+#define NZ 20
+#define RAW_PATH "testOmpCmd.raw"
+#define ZFP_PATH "testOmpCmd.zfp"
+#define OUT_PATH "testOmpCmd.out"
+#define REF_PATH "testOmpCmd.ref"
+
+struct setupVars {
+  double* input;
+  double* output;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  FILE* file;
+  size_t i;
+  assert_non_null(bundle);
+
+  bundle->input = malloc(NX * NY * NZ * sizeof(double));
+  bundle->output = malloc(NX * NY * NZ * sizeof(double));
+  assert_non_null(bundle->input);
+  assert_non_null(bundle->output);
+  for (i = 0; i < NX * NY * NZ; i++)
+    bundle->input[i] = (double)(i % 97) - 0.25 * (double)(i % 13);
+
+  file = fopen(RAW_PATH, "wb");
+  assert_non_null(file);
+  assert_int_equal(fwrite(bundle->input, sizeof(double), NX * NY * NZ, file), NX * NY * NZ);
+  fclose(file);
+
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  remove(RAW_PATH);
+  remove(ZFP_PATH);
+  remove(OUT_PATH);
+  remove(REF_PATH);
+  free(bundle->input);
+  free(bundle->output);
+  free(bundle);
+
+  return 0;
+}
+
+/* run zfp tool on null-terminated argument list and return its exit status */
+static int
+runCmd(const char* arg, ...)
+{
+  char* argv[32];
+  int argc = 0;
+  va_list ap;
+
+  argv[argc++] = "zfp";
+  va_start(ap, arg);
+  for (; arg; arg = va_arg(ap, const char*))
+    argv[argc++] = (char*)arg;
+  va_end(ap);
+  argv[argc] = NULL;
+
+  return zfp_main(argc, argv);
+}
+
+/* read whole file into malloc'd buffer and return its size in bytes */
+static size_t
+readFile(const char* path, void** data)
+{
+  FILE* file = fopen(path, "rb");
+  long bytes;
+  assert_non_null(file);
+  fseek(file, 0, SEEK_END);
+  bytes = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  assert_true(bytes > 0);
+  *data = malloc((size_t)bytes);
+  assert_non_null(*data);
+  assert_int_equal(fread(*data, 1, (size_t)bytes, file), (size_t)bytes);
+  fclose(file);
+  return (size_t)bytes;
+}
+
+/* decompress block container to output using given execution policy */
+static void
+decompressContainer(struct setupVars *bundle, const char* threads)
+{
+  void* data;
+  size_t bytes;
+
+  assert_int_equal(runCmd("-q", "-z", ZFP_PATH, "-o", OUT_PATH, "-b", "-x", threads, NULL), EXIT_SUCCESS);
+  bytes = readFile(OUT_PATH, &data);
+  assert_int_equal(bytes, NX * NY * NZ * sizeof(double));
+  memcpy(bundle->output, data, bytes);
+  free(data);
+}
+
+static void
+given_equalChunks_whenBlockContainer_expect_roundTrip(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-R", "-B", "equal", "6", "-x", "omp=4", NULL), EXIT_SUCCESS);
+  decompressContainer(bundle, "omp=4");
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+}
+
+static void
+given_cacheChunks_whenBlockContainer_expect_roundTrip(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-R", "-B", "cache", "16", "-x", "omp=4", NULL), EXIT_SUCCESS);
+  decompressContainer(bundle, "omp=2");
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+}
+
+static void
+given_threadCounts_whenBlockContainer_expect_sameFile(void **state)
+{
+  void* one;
+  void* four;
+  size_t oneBytes, fourBytes;
+  (void)state;
+
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-r", "12", "-B", "equal", "4", "-x", "omp=1", NULL), EXIT_SUCCESS);
+  oneBytes = readFile(ZFP_PATH, &one);
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-r", "12", "-B", "equal", "4", "-x", "omp=4", NULL), EXIT_SUCCESS);
+  fourBytes = readFile(ZFP_PATH, &four);
+
+  assert_int_equal(fourBytes, oneBytes);
+  assert_memory_equal(four, one, oneBytes);
+
+  free(one);
+  free(four);
+}
+
+static void
+given_slabs_whenPipelined_expect_roundTrip(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-R", "-P", "8", "-x", "omp=4", NULL), EXIT_SUCCESS);
+  decompressContainer(bundle, "omp=4");
+  assert_memory_equal(bundle->output, bundle->input, NX * NY * NZ * sizeof(double));
+}
+
+static void
+given_slabs_whenPipelinedFixedRate_expect_sameValuesAsSerial(void **state)
+{
+  struct setupVars *bundle = *state;
+  void* ref;
+  size_t bytes;
+
+  /* fixed-rate blocks are independent, so slab boundaries do not change values */
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-o", REF_PATH, "-d", "-3", "32", "24", "20", "-r", "12", NULL), EXIT_SUCCESS);
+  bytes = readFile(REF_PATH, &ref);
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-r", "12", "-P", "5", "-x", "omp=3", NULL), EXIT_SUCCESS);
+  decompressContainer(bundle, "omp=3");
+
+  assert_int_equal(bytes, NX * NY * NZ * sizeof(double));
+  assert_memory_equal(bundle->output, ref, bytes);
+
+  free(ref);
+}
+
+static void
+given_threadCounts_whenPipelined_expect_sameFile(void **state)
+{
+  void* one;
+  void* four;
+  size_t oneBytes, fourBytes;
+  (void)state;
+
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-a", "0.01", "-P", "4", "-x", "omp=1", NULL), EXIT_SUCCESS);
+  oneBytes = readFile(ZFP_PATH, &one);
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-a", "0.01", "-P", "4", "-x", "omp=4", NULL), EXIT_SUCCESS);
+  fourBytes = readFile(ZFP_PATH, &four);
+
+  assert_int_equal(fourBytes, oneBytes);
+  assert_memory_equal(four, one, oneBytes);
+
+  free(one);
+  free(four);
+}
+
+static void
+given_conflictingOptions_whenPipelined_expect_failure(void **state)
+{
+  (void)state;
+
+  /* pipelined output is a block container, which carries its own header */
+  assert_int_equal(runCmd("-q", "-h", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-R", "-P", "8", NULL), EXIT_FAILURE);
+  /* pipelined compression needs a compressed output file */
+  assert_int_equal(runCmd("-q", "-i", RAW_PATH, "-o", OUT_PATH, "-d", "-3", "32", "24", "20", "-R", "-P", "8", NULL), EXIT_FAILURE);
+}
+
+static void
+given_conflictingOptions_whenBlockContainer_expect_failure(void **state)
+{
+  (void)state;
+
+  /* block containers carry their own header */
+  assert_int_equal(runCmd("-q", "-h", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-R", "-B", "equal", "4", NULL), EXIT_FAILURE);
+  /* compressing to a container needs a chunk shape */
+  assert_int_equal(runCmd("-q", "-b", "-i", RAW_PATH, "-z", ZFP_PATH, "-d", "-3", "32", "24", "20", "-R", NULL), EXIT_FAILURE);
+}
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_equalChunks_whenBlockContainer_expect_roundTrip, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_cacheChunks_whenBlockContainer_expect_roundTrip, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_threadCounts_whenBlockContainer_expect_sameFile, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_slabs_whenPipelined_expect_roundTrip, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_slabs_whenPipelinedFixedRate_expect_sameValuesAsSerial, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_threadCounts_whenPipelined_expect_sameFile, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_conflictingOptions_whenPipelined_expect_failure, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_conflictingOptions_whenBlockContainer_expect_failure, setup, teardown),
+  };
+
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
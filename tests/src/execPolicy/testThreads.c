@@ -0,0 +1,402 @@
+#ifdef ZFP_TEST_SINGLE_CPU
+  /* RTLD_NEXT */
+  #define _GNU_SOURCE
+#endif
+#include "zfp.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef ZFP_WITH_THREADS
+#include <pthread.h>
+#endif
+
+#ifdef ZFP_TEST_SINGLE_CPU
+#include <dlfcn.h>
+#include <unistd.h>
+
+/* report one online processor so that the thread pool starts no workers */
+long
+sysconf(int name)
+{
+  static long (*next)(int) = NULL;
+  if (name == _SC_NPROCESSORS_ONLN)
+    return 1;
+  if (!next)
+    *(void**)&next = dlsym(RTLD_NEXT, "sysconf");
+  return next(name);
+}
+#endif
+
+#define NX 32
+#define NY 24
+#define NZ 20
+
+struct setupVars {
+  zfp_stream* stream;
+  zfp_field* field;
+  bitstream* bs;
+  void* buffer;
+  size_t streamSize;
+};
+
+static int
+setup(void **state)
+{
+  struct setupVars *bundle = malloc(sizeof(struct setupVars));
+  assert_non_null(bundle);
+
+  bundle->stream = zfp_stream_open(NULL);
+  *state = bundle;
+
+  return 0;
+}
+
+static int
+teardown(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_stream_close(bundle->stream);
+  free(bundle);
+
+  return 0;
+}
+
+static int
+setupForCompress(void **state)
+{
+  if (setup(state))
+    return 1;
+
+  struct setupVars *bundle = *state;
+
+  /* create a bitstream with buffer */
+  size_t bufferSize = 50 * sizeof(int);
+  bundle->buffer = malloc(bufferSize);
+  assert_non_null(bundle->buffer);
+  memset(bundle->buffer, 0, bufferSize);
+
+  /* offset bitstream, so we can distinguish 0 from stream_size() returned from zfp_decompress() */
+  bundle->bs = stream_open(bundle->buffer, bufferSize);
+  stream_skip(bundle->bs, (uint)(stream_word_bits + 1));
+
+  bundle->streamSize = stream_size(bundle->bs);
+  assert_int_not_equal(bundle->streamSize, 0);
+
+  /* manually set thread pool policy (needed for tests compiled without threads) */
+  bundle->stream->exec.policy = zfp_exec_threads;
+
+  bundle->field = zfp_field_1d(NULL, zfp_type_int32, 9);
+  assert_non_null(bundle->field);
+
+  return 0;
+}
+
+static int
+teardownForCompress(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  zfp_field_free(bundle->field);
+  stream_close(bundle->bs);
+  free(bundle->buffer);
+
+  return teardown(state);
+}
+
+static void
+recordBytes(void* context, size_t bytes)
+{
+  *(size_t*)context = bytes;
+}
+
+static void
+given_reversible_whenCompressAsync_expect_matchesCompress(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = bundle->field;
+  int32 input[9] = {1, -2, 3, -4, 5, -6, 7, -8, 9};
+  int32 output[9];
+  size_t reported = 0;
+  size_t size;
+  zfp_async* handle;
+
+  zfp_stream_set_execution(stream, zfp_exec_serial);
+  zfp_stream_set_reversible(stream);
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, input);
+  handle = zfp_compress_async(stream, field, recordBytes, &reported);
+  assert_non_null(handle);
+  size = zfp_wait(handle);
+  assert_int_not_equal(size, 0);
+  assert_int_equal(reported, size);
+
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, output);
+  assert_int_equal(zfp_decompress(stream, field), size);
+  assert_memory_equal(output, input, sizeof(input));
+}
+
+#ifdef _OPENMP
+struct blocksAsync {
+  size_t bytes;
+#ifdef ZFP_WITH_THREADS
+  pthread_t thread;
+#endif
+};
+
+static void
+recordBlocksAsync(void* context, size_t bytes)
+{
+  struct blocksAsync* async = context;
+  async->bytes = bytes;
+#ifdef ZFP_WITH_THREADS
+  async->thread = pthread_self();
+#endif
+}
+
+/* read header of block container in buffer; returns its blocks */
+static zfp_blocks*
+readBlocks(void* buffer, size_t bytes)
+{
+  bitstream* bs = stream_open(buffer, bytes);
+  zfp_stream* zfp = zfp_stream_open(bs);
+  zfp_field* field = zfp_field_alloc();
+  zfp_blocks* blocks = zfp_blocks_alloc();
+
+  assert_int_not_equal(zfp_read_blocks_header(zfp, field, blocks), 0);
+
+  zfp_field_free(field);
+  zfp_stream_close(zfp);
+  stream_close(bs);
+  return blocks;
+}
+
+static void
+given_blockContainer_whenCompressAsync_expect_matchesSingleStream(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  double* input = malloc(NX * NY * NZ * sizeof(double));
+  struct blocksAsync async = {0};
+  zfp_blocks* expectedBlocks;
+  zfp_blocks* blocks;
+  zfp_field* field;
+  zfp_async* handle;
+  bitstream* bs;
+  void* expected;
+  size_t bytes, i;
+
+  assert_non_null(input);
+  for (i = 0; i < NX * NY * NZ; i++)
+    input[i] = (double)(i % 97) - 0.25 * (double)(i % 13);
+  field = zfp_field_3d(input, zfp_type_double, NX, NY, NZ);
+  zfp_stream_set_reversible(stream);
+
+  /* block containers are compressed to a buffer owned by their bit stream */
+  bytes = zfp_blocks_compress_single_stream(stream, field, 4, 16, ZFP_MAKE_EQUAL);
+  assert_int_not_equal(bytes, 0);
+  bs = zfp_stream_bit_stream(stream);
+  expected = malloc(bytes);
+  assert_non_null(expected);
+  memcpy(expected, stream_data(bs), bytes);
+  free(stream_data(bs));
+  stream_close(bs);
+  zfp_stream_set_bit_stream(stream, NULL);
+
+  handle = zfp_blocks_compress_async(stream, field, 4, 16, ZFP_MAKE_EQUAL, recordBlocksAsync, &async);
+  assert_non_null(handle);
+  assert_int_equal(zfp_wait(handle), bytes);
+  assert_int_equal(async.bytes, bytes);
+#ifdef ZFP_WITH_THREADS
+  /* compression ran on a pool worker, which is a spare one on a single processor */
+  assert_false(pthread_equal(async.thread, pthread_self()));
+#endif
+
+  bs = zfp_stream_bit_stream(stream);
+  assert_memory_equal(stream_data(bs), expected, bytes);
+  expectedBlocks = readBlocks(expected, bytes);
+  blocks = readBlocks(stream_data(bs), bytes);
+  assert_int_equal(blocks->nbeg, expectedBlocks->nbeg);
+  assert_memory_equal(blocks->begs, expectedBlocks->begs, (blocks->nbeg + 1) * sizeof(size_t));
+
+  zfp_blocks_free(expectedBlocks);
+  zfp_blocks_free(blocks);
+  free(stream_data(bs));
+  stream_close(bs);
+  zfp_stream_set_bit_stream(stream, NULL);
+  zfp_field_free(field);
+  free(expected);
+  free(input);
+}
+#endif
+
+#ifdef ZFP_WITH_THREADS
+static void
+given_withThreads_when_setExecutionThreads_expect_set(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+
+  assert_int_equal(zfp_stream_set_execution(stream, zfp_exec_threads), 1);
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_threads);
+  assert_int_equal(zfp_stream_threads(stream), 0);
+}
+
+static void
+given_withThreads_serialExec_when_setThreads_expect_setToExecThreads(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_serial);
+
+  assert_int_equal(zfp_stream_set_threads(stream, 5), 1);
+
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_threads);
+  assert_int_equal(zfp_stream_threads(stream), 5);
+}
+
+static void
+given_withThreads_when_setThreadsIndex_expect_set(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  uint64 index[3];
+
+  assert_int_equal(zfp_stream_set_threads_index(stream, index, 3), 1);
+  assert_ptr_equal(zfp_stream_threads_index(stream), index);
+  assert_int_equal(zfp_stream_threads_index_size(stream), 3);
+
+  assert_int_equal(zfp_stream_set_threads_index(stream, index, 1), 0);
+}
+
+static void
+given_withThreads_threadsIndex_whenDecompressThreadsPolicy_expect_matchesInput(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = bundle->field;
+  int32 input[9] = {1, -2, 3, -4, 5, -6, 7, -8, 9};
+  int32 output[9];
+  uint64 index[3];
+  size_t size;
+
+  /* replace manually set policy with one that has parameters allocated */
+  zfp_stream_set_execution(stream, zfp_exec_serial);
+  zfp_stream_set_reversible(stream);
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  assert_int_equal(zfp_stream_set_threads(stream, 2), 1);
+  assert_int_equal(zfp_stream_set_threads_index(stream, index, 3), 1);
+
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, input);
+  size = zfp_compress(stream, field);
+  assert_int_not_equal(size, 0);
+  assert_int_equal(index[0], 0);
+  assert_true(index[1] <= index[2]);
+
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, output);
+  assert_int_equal(zfp_decompress(stream, field), size);
+  assert_memory_equal(output, input, sizeof(input));
+}
+
+/* callback context that waits for its handle before testing it */
+struct asyncState {
+  pthread_mutex_t mutex;
+  zfp_async* handle;
+  zfp_bool done;
+};
+
+static void
+testOwnHandle(void* context, size_t bytes)
+{
+  struct asyncState* async = context;
+  (void)bytes;
+  pthread_mutex_lock(&async->mutex);
+  async->done = zfp_test(async->handle);
+  pthread_mutex_unlock(&async->mutex);
+}
+
+static void
+given_withThreads_whenTestFromCallback_expect_done(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+  zfp_field* field = bundle->field;
+  int32 input[9] = {1, -2, 3, -4, 5, -6, 7, -8, 9};
+  struct asyncState async;
+
+  zfp_stream_set_execution(stream, zfp_exec_serial);
+  zfp_stream_set_reversible(stream);
+  zfp_stream_set_bit_stream(stream, bundle->bs);
+  zfp_stream_rewind(stream);
+  zfp_field_set_pointer(field, input);
+
+  /* hold the mutex so that the callback sees the handle */
+  pthread_mutex_init(&async.mutex, NULL);
+  async.done = zfp_false;
+  pthread_mutex_lock(&async.mutex);
+  async.handle = zfp_compress_async(stream, field, testOwnHandle, &async);
+  pthread_mutex_unlock(&async.mutex);
+  assert_non_null(async.handle);
+  assert_int_not_equal(zfp_wait(async.handle), 0);
+  pthread_mutex_destroy(&async.mutex);
+
+  assert_true(async.done);
+}
+
+#else
+static void
+given_withoutThreads_when_setExecutionThreads_expect_unableTo(void **state)
+{
+  struct setupVars *bundle = *state;
+  zfp_stream* stream = bundle->stream;
+
+  assert_int_equal(zfp_stream_set_execution(stream, zfp_exec_threads), 0);
+  assert_int_equal(zfp_stream_set_threads(stream, 5), 0);
+  assert_int_equal(zfp_stream_execution(stream), zfp_exec_serial);
+}
+
+static void
+given_withoutThreads_whenCompressThreadsPolicy_expect_noop(void **state)
+{
+  struct setupVars *bundle = *state;
+
+  assert_int_equal(zfp_compress(bundle->stream, bundle->field), 0);
+  assert_int_equal(stream_size(bundle->bs), bundle->streamSize);
+}
+
+#endif
+
+int main()
+{
+  const struct CMUnitTest tests[] = {
+    cmocka_unit_test_setup_teardown(given_reversible_whenCompressAsync_expect_matchesCompress, setupForCompress, teardownForCompress),
+#ifdef _OPENMP
+    cmocka_unit_test_setup_teardown(given_blockContainer_whenCompressAsync_expect_matchesSingleStream, setup, teardown),
+#endif
+
+#ifdef ZFP_WITH_THREADS
+    cmocka_unit_test_setup_teardown(given_withThreads_when_setExecutionThreads_expect_set, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withThreads_serialExec_when_setThreads_expect_setToExecThreads, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_withThreads_when_setThreadsIndex_expect_set, setup, teardown),
+
+    cmocka_unit_test_setup_teardown(given_withThreads_threadsIndex_whenDecompressThreadsPolicy_expect_matchesInput, setupForCompress, teardownForCompress),
+    cmocka_unit_test_setup_teardown(given_withThreads_whenTestFromCallback_expect_done, setupForCompress, teardownForCompress),
+#else
+    cmocka_unit_test_setup_teardown(given_withoutThreads_when_setExecutionThreads_expect_unableTo, setup, teardown),
+
+    cmocka_unit_test_setup_teardown(given_withoutThreads_whenCompressThreadsPolicy_expect_noop, setupForCompress, teardownForCompress),
+#endif
+  };
+  return cmocka_run_group_tests(tests, NULL, NULL);
+}
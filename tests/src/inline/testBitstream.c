@@ -323,6 +323,45 @@ when_ReadBitsSpreadsAcrossTwoWords_expect_BitsCombinedFromBothWords(void **state
   assert_int_equal(s->buffer, WORD2 >> NUM_OVERFLOWED_BITS);
 }
 
+static void
+when_ReadZerosSpreadsAcrossTwoWords_expect_ZerosAndOneBitConsumed(void **state)
+{
+  const uint READ_BIT_COUNT = 5;
+  const uint ONE_BIT_OFFSET = 3;
+  const bitstream_word ONE_WORD = (WORD2 << ONE_BIT_OFFSET) & WORD_MASK;
+
+  bitstream* s = ((struct setupVars *)*state)->b;
+  stream_write_bits(s, 0, wsize);
+  stream_write_bits(s, ONE_WORD, wsize);
+
+  stream_rewind(s);
+  stream_read_bits(s, READ_BIT_COUNT);
+
+  bitstream_count zeros = stream_read_zeros(s, 2 * wsize);
+
+  assert_int_equal(zeros, wsize - READ_BIT_COUNT + ONE_BIT_OFFSET);
+  assert_int_equal(s->bits, wsize - ONE_BIT_OFFSET - 1);
+  assert_int_equal(s->buffer, ONE_WORD >> (ONE_BIT_OFFSET + 1));
+}
+
+static void
+given_NoOneBitWithinLimit_when_ReadZeros_expect_LimitBitsRead(void **state)
+{
+  const uint ZERO_BIT_COUNT = 10;
+  const uint READ_LIMIT = 7;
+  const bitstream_word ONE_WORD = (WORD1 << ZERO_BIT_COUNT) & WORD_MASK;
+
+  bitstream* s = ((struct setupVars *)*state)->b;
+  s->buffer = ONE_WORD;
+  s->bits = wsize;
+
+  bitstream_count zeros = stream_read_zeros(s, READ_LIMIT);
+
+  assert_int_equal(zeros, READ_LIMIT);
+  assert_int_equal(s->bits, wsize - READ_LIMIT);
+  assert_int_equal(s->buffer, ONE_WORD >> READ_LIMIT);
+}
+
 static void
 given_BitstreamBufferEmptyWithNextWordAvailable_when_ReadBitsWsize_expect_EntireNextWordReturned(void **state)
 {
@@ -654,6 +693,8 @@ int main()
     cmocka_unit_test_setup_teardown(when_ReadBits_expect_BitsReadInOrderLSB, setup, teardown),
     cmocka_unit_test_setup_teardown(given_BitstreamBufferEmptyWithNextWordAvailable_when_ReadBitsWsize_expect_EntireNextWordReturned, setup, teardown),
     cmocka_unit_test_setup_teardown(when_ReadBitsSpreadsAcrossTwoWords_expect_BitsCombinedFromBothWords, setup, teardown),
+    cmocka_unit_test_setup_teardown(when_ReadZerosSpreadsAcrossTwoWords_expect_ZerosAndOneBitConsumed, setup, teardown),
+    cmocka_unit_test_setup_teardown(given_NoOneBitWithinLimit_when_ReadZeros_expect_LimitBitsRead, setup, teardown),
     cmocka_unit_test_setup_teardown(when_Wtell_expect_ReturnsWrittenBitCount, setup, teardown),
     cmocka_unit_test_setup_teardown(when_Rtell_expect_ReturnsReadBitCount, setup, teardown),
     cmocka_unit_test_setup_teardown(when_WseekToMultipleOfWsize_expect_PtrAlignedBufferEmpty, setup, teardown),
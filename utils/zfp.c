@@ -24,8 +24,346 @@ The 7 major tasks to be accomplished are:
 - decompress:         o || s || (!i && z)
 - write uncompressed: o
 - compute stats:      s
+
+With -B or -b, the compressed data is a block container of independently
+compressed chunks, which is (de)compressed in parallel using OpenMP.
+
+With -P, the input is instead read, compressed, and written one slab of
+layers along the slowest dimension at a time by OpenMP tasks, so that these
+phases overlap and the whole array never resides in memory.  The output is
+a block container with one chunk per slab.
 */
 
+/* set execution policy and parameters */
+static zfp_bool
+set_execution(zfp_stream* zfp, zfp_exec_policy exec, uint threads, uint chunk_size)
+{
+  switch (exec) {
+    case zfp_exec_cuda:
+      if (!zfp_stream_set_execution(zfp, exec)) {
+        fprintf(stderr, "cuda execution not available\n");
+        return zfp_false;
+      }
+      break;
+    case zfp_exec_omp:
+      if (!zfp_stream_set_execution(zfp, exec) ||
+          !zfp_stream_set_omp_threads(zfp, threads) ||
+          !zfp_stream_set_omp_chunk_size(zfp, chunk_size)) {
+        fprintf(stderr, "OpenMP execution not available\n");
+        return zfp_false;
+      }
+      break;
+    case zfp_exec_threads:
+      if (!zfp_stream_set_execution(zfp, exec) ||
+          !zfp_stream_set_threads(zfp, threads)) {
+        fprintf(stderr, "thread pool execution not available\n");
+        return zfp_false;
+      }
+      break;
+    case zfp_exec_serial:
+    default:
+      if (!zfp_stream_set_execution(zfp, exec)) {
+        fprintf(stderr, "serial execution not available\n");
+        return zfp_false;
+      }
+      break;
+  }
+  return zfp_true;
+}
+
+#ifdef _OPENMP
+/* slab being read, compressed, or written */
+typedef struct {
+  void* raw;          /* uncompressed slab */
+  void* buffer;       /* compressed slab */
+  bitstream* stream;  /* bit stream over buffer */
+  zfp_stream* zfp;    /* compressed stream over bit stream */
+  zfp_field* field;   /* slab metadata */
+  size_t bytes;       /* compressed size */
+} slab;
+
+/* state shared by the reading, compressing, and writing tasks */
+typedef struct {
+  slab* slot;         /* ring of slabs */
+  size_t slots;       /* number of slabs in ring */
+  FILE* in;           /* uncompressed input */
+  FILE* out;          /* compressed output */
+  const size_t* first; /* first layer of each slab */
+  const size_t* last; /* one past last layer of each slab */
+  size_t* begs;       /* bit offset of each slab and end of last */
+  size_t count;       /* number of slabs */
+  size_t layer;       /* number of values per layer */
+  size_t typesize;    /* bytes per value */
+  uint dims;          /* dimensionality */
+  zfp_bool ok;        /* false once reading, compression, or writing failed */
+} pipeline;
+
+/* true unless an earlier stage failed */
+static zfp_bool
+pipeline_ok(pipeline* p)
+{
+  zfp_bool ok;
+#pragma omp atomic read
+  ok = p->ok;
+  return ok;
+}
+
+/* report failure and make remaining stages skip their work */
+static void
+pipeline_fail(pipeline* p, const char* message)
+{
+  fprintf(stderr, "%s\n", message);
+#pragma omp atomic write
+  p->ok = zfp_false;
+}
+
+/* read slab k into its slot */
+static void
+read_slab(pipeline* p, size_t k)
+{
+  slab* s = &p->slot[k % p->slots];
+  size_t layers = p->last[k] - p->first[k];
+  size_t count = layers * p->layer;
+  if (!pipeline_ok(p))
+    return;
+  if (fread(s->raw, p->typesize, count, p->in) != count) {
+    pipeline_fail(p, "cannot read input file");
+    return;
+  }
+  switch (p->dims) {
+    case 1: s->field->nx = layers; break;
+    case 2: s->field->ny = layers; break;
+    case 3: s->field->nz = layers; break;
+    case 4: s->field->nw = layers; break;
+  }
+}
+
+/* compress slab k as one chunk spanning its slot */
+static void
+compress_slab(pipeline* p, size_t k)
+{
+  slab* s = &p->slot[k % p->slots];
+  zfp_chunk chunk;
+  if (!pipeline_ok(p))
+    return;
+  chunk.fx = chunk.fy = chunk.fz = chunk.fw = 0;
+  chunk.ex = s->field->nx;
+  chunk.ey = s->field->ny;
+  chunk.ez = s->field->nz;
+  chunk.ew = s->field->nw;
+  zfp_stream_rewind(s->zfp);
+  s->bytes = zfp_compress_chunk(s->zfp, &chunk, s->field);
+  if (!s->bytes)
+    pipeline_fail(p, "compression failed");
+}
+
+/* write compressed slab k and record where the next one begins */
+static void
+write_slab(pipeline* p, size_t k)
+{
+  slab* s = &p->slot[k % p->slots];
+  if (!pipeline_ok(p))
+    return;
+  if (fwrite(s->buffer, 1, s->bytes, p->out) != s->bytes) {
+    pipeline_fail(p, "cannot write compressed file");
+    return;
+  }
+  p->begs[k + 1] = p->begs[k] + CHAR_BIT * s->bytes;
+}
+
+/* write block container header for count slabs (zero upon failure) */
+static size_t
+write_pipeline_header(zfp_stream* zfp, const zfp_field* field, size_t count, FILE* out)
+{
+  uint dims = zfp_field_dimensionality(field);
+  size_t hbytes = (ZFP_HEADER_BLOCKS_MAX_BITS + 64 * (count + 1)) / CHAR_BIT;
+  void* header = malloc(hbytes);
+  zfp_blocks* blocks = zfp_blocks_alloc();
+  bitstream* hs;
+  size_t k;
+
+  if (!header || !blocks) {
+    fprintf(stderr, "cannot allocate memory\n");
+    free(header);
+    if (blocks)
+      zfp_blocks_free(blocks);
+    return 0;
+  }
+
+  /* describe slabs as a chunk grid whose begs follow the chunks */
+  blocks->bx = blocks->by = blocks->bz = blocks->bw = 1;
+  switch (dims) {
+    case 1: blocks->bx = count; break;
+    case 2: blocks->by = count; break;
+    case 3: blocks->bz = count; break;
+    case 4: blocks->bw = count; break;
+  }
+  zfp_alloc_nblocks(blocks, count);
+  for (k = 0; k <= count; k++)
+    blocks->begs[k] = ZFP_BLOCKS_BEGS_TRAILER;
+
+  hs = stream_open(header, hbytes);
+  zfp_stream_set_bit_stream(zfp, hs);
+  hbytes = zfp_write_blocks_header(zfp, field, blocks, 0) / CHAR_BIT;
+  zfp_stream_set_bit_stream(zfp, NULL);
+  stream_close(hs);
+  if (fwrite(header, 1, hbytes, out) != hbytes) {
+    fprintf(stderr, "cannot write compressed file\n");
+    hbytes = 0;
+  }
+  free(header);
+  zfp_blocks_free(blocks);
+  return hbytes;
+}
+
+/* write trailer holding slab begs as absolute bit offsets (zero upon failure) */
+static size_t
+write_pipeline_trailer(const size_t* begs, size_t count, FILE* out)
+{
+  size_t tbytes = sizeof(uint64) * (count + 1);
+  void* trailer = malloc(tbytes);
+  bitstream* ts;
+  size_t k;
+
+  if (!trailer) {
+    fprintf(stderr, "cannot allocate memory\n");
+    return 0;
+  }
+  ts = stream_open(trailer, tbytes);
+  for (k = 0; k <= count; k++)
+    stream_write_bits(ts, (uint64)begs[k], 64);
+  stream_flush(ts);
+  stream_close(ts);
+  if (fwrite(trailer, 1, tbytes, out) != tbytes) {
+    fprintf(stderr, "cannot write compressed file\n");
+    tbytes = 0;
+  }
+  free(trailer);
+  return tbytes;
+}
+
+/*
+** Read, compress, and write field in slabs of layers along slowest dimension.
+** Each slab is compressed serially on an OpenMP worker thread, with one slot
+** per worker plus one each for the slab being read and the one being written.
+** Tasks are ordered by dependences: reads and writes occur in slab order, and
+** a slot is reused only once its slab has been written.
+*/
+static size_t /* number of compressed bytes written (zero upon failure) */
+compress_pipelined(zfp_stream* zfp, zfp_field* field, int nthreads, size_t layers, FILE* in, FILE* out)
+{
+  size_t n[4];
+  uint dims = zfp_field_dimensionality(field);
+  size_t* first;
+  size_t* last;
+  uint minbits, maxbits, maxprec;
+  int minexp;
+  pipeline p;
+  size_t hbytes = 0;
+  size_t tbytes = 0;
+  size_t bufsize, k;
+  uint i;
+
+  /* partition slowest dimension into slabs whose layers are multiples of 4 */
+  zfp_field_to_n(field, n);
+  p.layer = 1;
+  for (i = 0; i + 1 < dims; i++)
+    p.layer *= n[i];
+  layers = (layers + 3) & ~(size_t)3;
+  p.count = (n[dims - 1] + layers - 1) / layers;
+  p.slots = MIN((size_t)nthreads + 2, p.count);
+  p.typesize = zfp_type_size(field->type);
+  p.dims = dims;
+  p.in = in;
+  p.out = out;
+  p.ok = zfp_true;
+  first = malloc(p.count * sizeof(size_t));
+  last = malloc(p.count * sizeof(size_t));
+  p.begs = malloc((p.count + 1) * sizeof(size_t));
+  p.slot = calloc(p.slots, sizeof(slab));
+  if (!first || !last || !p.begs || !p.slot) {
+    fprintf(stderr, "cannot allocate memory\n");
+    p.ok = zfp_false;
+  }
+  else {
+    zfp_break_axis(n[dims - 1], p.count, first, last);
+    p.first = first;
+    p.last = last;
+  }
+
+  /* allocate ring of slabs, each with its own serial compressed stream */
+  zfp_stream_params(zfp, &minbits, &maxbits, &maxprec, &minexp);
+  for (k = 0; p.ok && k < p.slots; k++) {
+    slab* s = &p.slot[k];
+    s->field = zfp_field_alloc();
+    s->zfp = zfp_stream_open(NULL);
+    if (!s->field || !s->zfp) {
+      fprintf(stderr, "cannot allocate memory\n");
+      p.ok = zfp_false;
+      break;
+    }
+    *s->field = *field;
+    s->field->data = NULL;
+    switch (dims) {
+      case 1: s->field->nx = layers; break;
+      case 2: s->field->ny = layers; break;
+      case 3: s->field->nz = layers; break;
+      case 4: s->field->nw = layers; break;
+    }
+    zfp_stream_set_params(s->zfp, minbits, maxbits, maxprec, minexp);
+    bufsize = zfp_stream_maximum_size(s->zfp, s->field);
+    s->raw = malloc(layers * p.layer * p.typesize);
+    s->buffer = malloc(bufsize);
+    s->stream = s->buffer ? stream_open(s->buffer, bufsize) : NULL;
+    if (!s->raw || !s->stream) {
+      fprintf(stderr, "cannot allocate memory\n");
+      p.ok = zfp_false;
+      break;
+    }
+    zfp_field_set_pointer(s->field, s->raw);
+    zfp_stream_set_bit_stream(s->zfp, s->stream);
+  }
+
+  /* write header, then read, compress, and write slabs as tasks */
+  if (p.ok)
+    hbytes = write_pipeline_header(zfp, field, p.count, out);
+  if (hbytes) {
+    p.begs[0] = CHAR_BIT * hbytes;
+#pragma omp parallel num_threads(nthreads)
+#pragma omp single
+    for (k = 0; k < p.count; k++) {
+#pragma omp task firstprivate(k) depend(inout: p.in) depend(inout: p.slot[k % p.slots])
+      read_slab(&p, k);
+#pragma omp task firstprivate(k) depend(inout: p.slot[k % p.slots])
+      compress_slab(&p, k);
+#pragma omp task firstprivate(k) depend(inout: p.out) depend(inout: p.slot[k % p.slots])
+      write_slab(&p, k);
+    }
+    if (p.ok)
+      tbytes = write_pipeline_trailer(p.begs, p.count, out);
+  }
+
+  /* release slabs, whether or not all stages succeeded */
+  for (k = 0; p.slot && k < p.slots; k++) {
+    slab* s = &p.slot[k];
+    if (s->zfp)
+      zfp_stream_close(s->zfp);
+    if (s->stream)
+      stream_close(s->stream);
+    if (s->field)
+      zfp_field_free(s->field);
+    free(s->buffer);
+    free(s->raw);
+  }
+  hbytes = tbytes ? p.begs[p.count] / CHAR_BIT + tbytes : 0;
+  free(p.slot);
+  free(p.begs);
+  free(first);
+  free(last);
+  return hbytes;
+}
+#endif
+
 /* compute and print reconstruction error */
 static void
 print_error(const void* fin, const void* fout, zfp_type type, size_t n)
@@ -113,7 +451,14 @@ usage(void)
   fprintf(stderr, "Execution parameters:\n");
   fprintf(stderr, "  -x serial : serial compression (default)\n");
   fprintf(stderr, "  -x omp[=threads[,chunk_size]] : OpenMP parallel compression\n");
+  fprintf(stderr, "  -x threads[=threads] : thread pool parallel compression\n");
   fprintf(stderr, "  -x cuda : CUDA fixed rate parallel compression/decompression\n");
+  fprintf(stderr, "  -B <cache|equal> <blocks> : write block container of chunks of about <blocks>\n");
+  fprintf(stderr, "      blocks each, shaped for cache use or equal sides (needs OpenMP)\n");
+  fprintf(stderr, "  -b : read block container, e.g., written via -B or -P (needs OpenMP)\n");
+  fprintf(stderr, "  -P <layers> : pipelined compression of -i to -z in slabs of <layers> (rounded\n");
+  fprintf(stderr, "      up to a multiple of 4) along the slowest dimension; writes a block container\n");
+  fprintf(stderr, "      (needs OpenMP)\n");
   fprintf(stderr, "Examples:\n");
   fprintf(stderr, "  -i file : read uncompressed file and compress to memory\n");
   fprintf(stderr, "  -z file : read compressed file and decompress to memory\n");
@@ -128,6 +473,9 @@ usage(void)
   fprintf(stderr, "  -d -1 1000000 -a 1e-9 : compression of 1M doubles with < 1e-9 max error\n");
   fprintf(stderr, "  -d -1 1000000 -c 64 64 0 -1074 : 4x fixed-rate compression of 1M doubles\n");
   fprintf(stderr, "  -x omp=16,256 : parallel compression with 16 threads, 256-block chunks\n");
+  fprintf(stderr, "  -i ifile -z zfile -B cache 256 -x omp=16 : 16-thread block container compression\n");
+  fprintf(stderr, "  -z zfile -o ofile -b -x omp=16 : 16-thread block container decompression\n");
+  fprintf(stderr, "  -i ifile -z zfile -P 64 : overlap reading, compressing, and writing 64-layer slabs\n");
   exit(EXIT_FAILURE);
 }
 
@@ -159,6 +507,10 @@ int main(int argc, char* argv[])
   zfp_exec_policy exec = zfp_exec_serial;
   uint threads = 0;
   uint chunk_size = 0;
+  size_t layers = 0;
+  zfp_bool blocks = zfp_false;
+  int method = 0;
+  float blocks_per_chunk = 0;
 
   /* local variables */
   int i;
@@ -209,11 +561,27 @@ int main(int argc, char* argv[])
           usage();
         dims = 4;
         break;
+      case 'B':
+        if (++i == argc)
+          usage();
+        if (!strcmp(argv[i], "cache"))
+          method = ZFP_BEST_CACHE;
+        else if (!strcmp(argv[i], "equal"))
+          method = ZFP_MAKE_EQUAL;
+        else
+          usage();
+        if (++i == argc || sscanf(argv[i], "%f", &blocks_per_chunk) != 1 || !(blocks_per_chunk >= 1))
+          usage();
+        blocks = zfp_true;
+        break;
       case 'a':
         if (++i == argc || sscanf(argv[i], "%lf", &tolerance) != 1)
           usage();
         mode = 'a';
         break;
+      case 'b':
+        blocks = zfp_true;
+        break;
       case 'c':
         if (++i == argc || sscanf(argv[i], "%u", &minbits) != 1 ||
             ++i == argc || sscanf(argv[i], "%u", &maxbits) != 1 ||
@@ -246,6 +614,10 @@ int main(int argc, char* argv[])
           usage();
         mode = 'p';
         break;
+      case 'P':
+        if (++i == argc || sscanf(argv[i], "%zu", &layers) != 1 || !layers)
+          usage();
+        break;
       case 'q':
         quiet = zfp_true;
         break;
@@ -290,6 +662,12 @@ int main(int argc, char* argv[])
           threads = 0;
           chunk_size = 0;
         }
+        else if (sscanf(argv[i], "threads=%u", &threads) == 1)
+          exec = zfp_exec_threads;
+        else if (!strcmp(argv[i], "threads")) {
+          exec = zfp_exec_threads;
+          threads = 0;
+        }
         else if (!strcmp(argv[i], "cuda"))
           exec = zfp_exec_cuda;
         else
@@ -327,8 +705,8 @@ int main(int argc, char* argv[])
       fprintf(stderr, "must specify scalar type via -f, -d, or -t to compress\n");
       return EXIT_FAILURE;
     }
-    else if (!header) {
-      fprintf(stderr, "must specify scalar type via -f, -d, or -t or header via -h to decompress\n");
+    else if (!header && !blocks) {
+      fprintf(stderr, "must specify scalar type via -f, -d, or -t or header via -h or -b to decompress\n");
       return EXIT_FAILURE;
     }
   }
@@ -339,8 +717,8 @@ int main(int argc, char* argv[])
       fprintf(stderr, "must specify array dimensions via -1, -2, -3, or -4 to compress\n");
       return EXIT_FAILURE;
     }
-    else if (!header) {
-      fprintf(stderr, "must specify array dimensions via -1, -2, -3, or -4 or header via -h to decompress\n");
+    else if (!header && !blocks) {
+      fprintf(stderr, "must specify array dimensions via -1, -2, -3, or -4 or header via -h or -b to decompress\n");
       return EXIT_FAILURE;
     }
   }
@@ -351,8 +729,8 @@ int main(int argc, char* argv[])
       fprintf(stderr, "must specify compression parameters via -a, -c, -p, or -r to compress\n");
       return EXIT_FAILURE;
     }
-    else if (!header) {
-      fprintf(stderr, "must specify compression parameters via -a, -c, -p, or -r or header via -h to decompress\n");
+    else if (!header && !blocks) {
+      fprintf(stderr, "must specify compression parameters via -a, -c, -p, or -r or header via -h or -b to decompress\n");
       return EXIT_FAILURE;
     }
   }
@@ -364,16 +742,51 @@ int main(int argc, char* argv[])
   }
 
   /* make sure meta data comes from header or command line, not both */
-  if (!inpath && zfppath && header && (typesize || dims)) {
+  if (!inpath && zfppath && (header || blocks) && (typesize || dims)) {
     fprintf(stderr, "cannot specify both field type/size and header\n");
     return EXIT_FAILURE;
   }
 
+  /* make sure block container settings are consistent */
+  if (blocks) {
+#ifdef _OPENMP
+    if (header || layers) {
+      fprintf(stderr, "block containers store their own header; cannot combine -B or -b with -h or -P\n");
+      return EXIT_FAILURE;
+    }
+    if (inpath && !method) {
+      fprintf(stderr, "must specify chunk shape and size via -B to compress to block container\n");
+      return EXIT_FAILURE;
+    }
+#else
+    (void)method;
+    (void)blocks_per_chunk;
+    fprintf(stderr, "block containers require OpenMP\n");
+    return EXIT_FAILURE;
+#endif
+  }
+
+  /* make sure pipelined compression streams from input to compressed file */
+  if (layers) {
+#ifdef _OPENMP
+    if (!inpath || !zfppath || outpath || stats || header) {
+      fprintf(stderr, "pipelined compression via -P requires -i and -z and excludes -h, -o, and -s\n");
+      return EXIT_FAILURE;
+    }
+#else
+    fprintf(stderr, "pipelined compression requires OpenMP\n");
+    return EXIT_FAILURE;
+#endif
+  }
+
   zfp = zfp_stream_open(NULL);
   field = zfp_field_alloc();
 
   /* read uncompressed or compressed file */
-  if (inpath) {
+  if (layers) {
+    /* input is read one slab at a time during compression */
+  }
+  else if (inpath) {
     /* read uncompressed input file */
     FILE* file = !strcmp(inpath, "-") ? stdin : fopen(inpath, "rb");
     if (!file) {
@@ -426,7 +839,7 @@ int main(int argc, char* argv[])
   }
 
   /* set field dimensions and (de)compression parameters */
-  if (inpath || !header) {
+  if (inpath || (!header && !blocks)) {
     /* initialize uncompressed field */
     zfp_field_set_type(field, type);
     switch (dims) {
@@ -472,30 +885,62 @@ int main(int argc, char* argv[])
   }
 
   /* specify execution policy */
-  switch (exec) {
-    case zfp_exec_cuda:
-      if (!zfp_stream_set_execution(zfp, exec)) {
-        fprintf(stderr, "cuda execution not available\n");
-        return EXIT_FAILURE;
-      }
-      break;
-    case zfp_exec_omp:
-      if (!zfp_stream_set_execution(zfp, exec) ||
-          !zfp_stream_set_omp_threads(zfp, threads) ||
-          !zfp_stream_set_omp_chunk_size(zfp, chunk_size)) {
-        fprintf(stderr, "OpenMP execution not available\n");
+  if (!set_execution(zfp, exec, threads, chunk_size))
+    return EXIT_FAILURE;
+
+#ifdef _OPENMP
+  /* compress input file in slabs if requested */
+  if (layers) {
+    int nthreads = threads ? (int)threads : omp_get_max_threads();
+    FILE* in = !strcmp(inpath, "-") ? stdin : fopen(inpath, "rb");
+    FILE* out;
+    if (!in) {
+      fprintf(stderr, "cannot open input file\n");
+      return EXIT_FAILURE;
+    }
+    out = !strcmp(zfppath, "-") ? stdout : fopen(zfppath, "wb");
+    if (!out) {
+      fprintf(stderr, "cannot create compressed file\n");
+      fclose(in);
+      return EXIT_FAILURE;
+    }
+    zfpsize = compress_pipelined(zfp, field, nthreads, layers, in, out);
+    fclose(in);
+    fclose(out);
+    if (!zfpsize)
+      return EXIT_FAILURE;
+    rawsize = typesize * count;
+  }
+
+  /* compress input file to block container in parallel */
+  else if (inpath && blocks) {
+    int nthreads = threads ? (int)threads : omp_get_max_threads();
+    zfpsize = zfp_blocks_compress_single_stream(zfp, field, nthreads, blocks_per_chunk, method);
+    if (zfpsize == 0) {
+      fprintf(stderr, "compression failed\n");
+      return EXIT_FAILURE;
+    }
+    /* the container is compressed to a buffer owned by its own bit stream */
+    stream = zfp_stream_bit_stream(zfp);
+    buffer = stream_data(stream);
+
+    /* optionally write compressed data */
+    if (zfppath) {
+      FILE* file = !strcmp(zfppath, "-") ? stdout : fopen(zfppath, "wb");
+      if (!file) {
+        fprintf(stderr, "cannot create compressed file\n");
         return EXIT_FAILURE;
       }
-      break;
-    case zfp_exec_serial:
-    default:
-      if (!zfp_stream_set_execution(zfp, exec)) {
-        fprintf(stderr, "serial execution not available\n");
+      if (fwrite(buffer, 1, zfpsize, file) != zfpsize) {
+        fprintf(stderr, "cannot write compressed file\n");
         return EXIT_FAILURE;
       }
-      break;
+      fclose(file);
+    }
   }
 
+  else
+#endif
   /* compress input file if provided */
   if (inpath) {
     /* allocate buffer for compressed data */
@@ -549,12 +994,25 @@ int main(int argc, char* argv[])
   /* decompress data if necessary */
   if ((!inpath && zfppath) || outpath || stats) {
     /* obtain metadata from header when present */
+    if (blocks) {
+      /* a trailing chunk offset table is located relative to the end of the stream */
+      stream_close(stream);
+      stream = stream_open(buffer, zfpsize);
+      if (!stream) {
+        fprintf(stderr, "cannot open compressed stream\n");
+        return EXIT_FAILURE;
+      }
+      zfp_stream_set_bit_stream(zfp, stream);
+    }
     zfp_stream_rewind(zfp);
-    if (header) {
-      if (!zfp_read_header(zfp, field, ZFP_HEADER_FULL)) {
+    if (header || blocks) {
+      zfp_blocks* container = blocks ? zfp_blocks_alloc() : NULL;
+      if (blocks ? !zfp_read_blocks_header(zfp, field, container) : !zfp_read_header(zfp, field, ZFP_HEADER_FULL)) {
         fprintf(stderr, "incorrect or missing header\n");
         return EXIT_FAILURE;
       }
+      if (container)
+        zfp_blocks_free(container);
       type = field->type;
       typesize = zfp_type_size(type);
       if (!typesize) {
@@ -577,6 +1035,18 @@ int main(int argc, char* argv[])
     }
     zfp_field_set_pointer(field, fo);
 
+#ifdef _OPENMP
+    /* decompress block container in parallel */
+    if (blocks) {
+      int nthreads = threads ? (int)threads : omp_get_max_threads();
+      zfp_stream_rewind(zfp);
+      if (!zfp_blocks_decompress_single_stream(zfp, field, nthreads)) {
+        fprintf(stderr, "decompression failed\n");
+        return EXIT_FAILURE;
+      }
+    }
+    else
+#endif
     /* decompress data */
     while (!zfp_decompress(zfp, field)) {
       /* fall back on serial decompression if execution policy not supported */
@@ -2,4 +2,5 @@ from .zfpy_c import (compress_numpy, decompress_numpy,
                        mode_expert, mode_fixed_accuracy, mode_fixed_precision,
                        mode_fixed_rate)
 from ._zfp_par import zfp_p as zfp_parallel
+from ._zfp_lazy import zfp_lazy_array
 
@@ -0,0 +1,154 @@
+import numpy as np
+from collections import OrderedDict
+from multiprocess import cpu_count
+from zfpy_c import(zfp_chunkit,
+                       header,
+                       decompress_numpy_chunk_list)
+
+class zfp_lazy_array:
+    def __init__(self, compress_data, offsets, chunkit, cache_bytes: int = 1 << 28,
+                 nthreads: int = -1):
+        """Read-only array that decompresses chunks only when sliced.
+
+        Args:
+            compress_data: Data written by zfp_p.compress (compress_numpy_chunks).
+            offsets: Byte offset of each chunk within compress_data.
+            chunkit (zfp_chunkit): Chunks the data was compressed with.
+            cache_bytes (int): Memory budget for recently decompressed chunks.
+            nthreads (int): Number of threads to use (defaults to all).
+        """
+        if len(offsets) != chunkit.get_nchunks() + 1:
+            raise ValueError("Offsets do not match the chunks of chunkit")
+        self._compress_data = compress_data
+        self._offsets = np.asarray(offsets, dtype=np.uint64)
+        self._chunkit = chunkit
+        self._extents = chunkit.get_chunk_extents()
+        self.shape = tuple(chunkit.get_shape())
+        self.dtype = np.dtype(chunkit.get_dtype())
+        self.ndim = len(self.shape)
+        self.cache_bytes = cache_bytes
+        self.nthreads = cpu_count() if nthreads == -1 else nthreads
+        self._cache = OrderedDict()
+        self._cached_bytes = 0
+
+    @classmethod
+    def from_compressed(cls, compress_data, offsets, chunks_per_block: float,
+                        method="BEST_CACHE", cache_bytes: int = 1 << 28,
+                        nthreads: int = -1):
+        """Open compressed data without the uncompressed array.
+
+        The chunks are recreated from the shape and type in the zfp header,
+        so chunks_per_block and method must match those used to compress.
+        """
+        info = header(compress_data)
+        shape = tuple(n for n in (info["nw"], info["nz"], info["ny"], info["nx"]) if n > 0)
+        # chunking only looks at shape and type, so a zero-stride view will do
+        proxy = np.broadcast_to(np.zeros((), dtype=info["type"]), shape)
+        return cls(compress_data, offsets, zfp_chunkit(proxy, chunks_per_block, method),
+                   cache_bytes, nthreads)
+
+    def __len__(self):
+        return self.shape[0]
+
+    @property
+    def size(self):
+        return int(np.prod(self.shape))
+
+    @property
+    def nbytes(self):
+        return self.size * self.dtype.itemsize
+
+    def clear_cache(self):
+        """Drop all cached chunks"""
+        self._cache.clear()
+        self._cached_bytes = 0
+
+    def __array__(self, dtype=None, copy=None):
+        arr = self[...]
+        return arr if dtype is None else arr.astype(dtype, copy=False)
+
+    def __getitem__(self, key):
+        box, local = self._index(key)
+        out = np.empty(tuple(len(r) for r in box), dtype=self.dtype)
+        if out.size:
+            self._fill(box, out)
+        return out[local]
+
+    def _index(self, key):
+        """Split key into the box of elements it touches (one range per axis)
+        and the index that picks the result out of that box"""
+        if not isinstance(key, tuple):
+            key = (key,)
+        if sum(1 for k in key if k is Ellipsis) > 1:
+            raise IndexError("an index can only have a single ellipsis")
+        if Ellipsis in key:
+            i = key.index(Ellipsis)
+            key = key[:i] + (slice(None),) * (self.ndim - len(key) + 1) + key[i + 1:]
+        if len(key) > self.ndim:
+            raise IndexError("too many indices for array")
+        key = key + (slice(None),) * (self.ndim - len(key))
+
+        box = []
+        local = []
+        for k, n in zip(key, self.shape):
+            if isinstance(k, slice):
+                r = range(*k.indices(n))
+                if len(r) == 0:
+                    box.append(range(0))
+                    local.append(slice(0, 0))
+                else:
+                    lo = min(r[0], r[-1])
+                    box.append(range(lo, max(r[0], r[-1]) + 1))
+                    local.append(slice(r[0] - lo, None, r.step))
+            elif isinstance(k, (int, np.integer)):
+                i = int(k) + n if k < 0 else int(k)
+                if not 0 <= i < n:
+                    raise IndexError("index {} is out of bounds for axis with size {}".format(k, n))
+                box.append(range(i, i + 1))
+                local.append(0)
+            else:
+                raise IndexError("only integers, slices and ellipsis are valid indices")
+        return box, tuple(local)
+
+    def _fill(self, box, out):
+        """Copy the part of each chunk that intersects box into out"""
+        lo = np.array([r.start for r in box])
+        hi = np.array([r.stop for r in box])
+        first = self._extents[:, :, 0]
+        end = self._extents[:, :, 1]
+        ichunks = np.nonzero(np.all((first < hi) & (end > lo), axis=1))[0]
+
+        def copy(ichunk, chunk):
+            a = np.maximum(first[ichunk], lo)
+            b = np.minimum(end[ichunk], hi)
+            out[tuple(slice(x, y) for x, y in zip(a - lo, b - lo))] = \
+                chunk[tuple(slice(x, y) for x, y in zip(a - first[ichunk], b - first[ichunk]))]
+
+        missing = []
+        for ichunk in ichunks:
+            if ichunk in self._cache:
+                self._cache.move_to_end(ichunk)
+                copy(ichunk, self._cache[ichunk])
+            else:
+                missing.append(ichunk)
+
+        # decompress a few chunks per thread at a time to bound memory use
+        batch = 4 * self.nthreads
+        for i in range(0, len(missing), batch):
+            ichunk_batch = missing[i:i + batch]
+            chunks = [np.empty(tuple(end[j] - first[j]), dtype=self.dtype) for j in ichunk_batch]
+            decompress_numpy_chunk_list(self._compress_data, self._offsets, self._chunkit,
+                                        ichunk_batch, chunks, self.nthreads)
+            for ichunk, chunk in zip(ichunk_batch, chunks):
+                copy(ichunk, chunk)
+                self._insert(ichunk, chunk)
+
+    def _insert(self, ichunk, chunk):
+        """Cache chunk, evicting the least recently used ones over budget"""
+        if chunk.nbytes > self.cache_bytes:
+            return
+        self._cache[ichunk] = chunk
+        self._cached_bytes += chunk.nbytes
+        while self._cached_bytes > self.cache_bytes:
+            _, old = self._cache.popitem(last=False)
+            self._cached_bytes -= old.nbytes
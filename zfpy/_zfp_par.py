@@ -1,10 +1,10 @@
 import numpy as np
 from multiprocess import RawArray, cpu_count
-from multiprocessing.pool import ThreadPool as Pool
 import math
 from zfpy_c import(zfp_chunkit,
-                       compress_numpy_portion, 
-                       decompress_numpy_portion)
+                       compress_numpy_chunks,
+                       decompress_numpy_chunks)
+from ._zfp_lazy import zfp_lazy_array
 
 class zfp_p:
     def __init__(self, shape: tuple, dtype: np.dtype, est_compression_rate: float = 3,
@@ -77,28 +77,17 @@ class zfp_p:
         """Return numpy array representation"""
         return self._np_array
     
-    def _init_pool(self, nthreads):
-        # Initialize the multiprocessing pool
-        if nthreads == -1:
-            pool = Pool(initializer=self._init_shared_array, initargs=(self._raw_arr,))
-        else:
-            pool = Pool(processes=nthreads, initializer=self._init_shared_array, initargs=(self._raw_arr,))
-        return pool
-
-    @staticmethod
-    def _pool_initializer(shared_arr_, chunkit_):
-        global shared_arr
-        global chunkit
-        shared_arr = shared_arr_
-        chunkit = chunkit_
-    
-    @staticmethod
-    def _compress_chunk(ichunk, tolerance, rate, precision):
-        # Wrap the shared RawArray in a NumPy array
-        #np_arr = np.frombuffer(shared_arr, dtype=chunkit.get_dtype()).reshape(chunkit.get_shape())
-        # Compress the chunk
-        return compress_numpy_portion(shared_arr, chunkit, ichunk, tolerance, rate, precision)
-
+    def get_compressed_data(self):
+        """Return compressed data and byte offset of each chunk within it"""
+        return self._compress_data, self._offsets
+
+    def get_lazy_array(self, cache_bytes=1 << 28, nthreads=-1):
+        """Return read-only array decompressing only the chunks a slice touches
+            cache_bytes - Memory budget for recently decompressed chunks
+            nthreads    - Number of threads to use (defaults to all)
+        """
+        return zfp_lazy_array(self._compress_data, self._offsets, self._chunkit,
+                              cache_bytes, nthreads)
 
     def compress(self,nthreads=-1,tolerance = -1,rate = -1,precision = -1):
         """Compress 
@@ -110,51 +99,20 @@ class zfp_p:
         
         if nthreads==-1:
             nthreads=cpu_count()
-        
-        """Parallelized compress method."""
-        self._compress_data = []
-        # Initialize multiprocessing pool
-        pool = Pool(processes=nthreads, initializer=self._pool_initializer, 
-                    initargs=(self._raw_arr, self._chunkit))
-
-        # Create tasks for the pool
-        tasks = [(ichunk, tolerance, rate, precision) for ichunk in range(self._chunkit.get_nchunks())]
 
-        # Execute the tasks in parallel
-        self._compress_data = pool.starmap(self._compress_chunk, tasks)
-
-        # Close the pool and wait for tasks to complete
-        pool.close()
-        pool.join()
-    
-    @staticmethod
-    def _decompress_chunk(ichunk):
-        # Wrap the shared RawArray in a NumPy array
-        np_arr = np.frombuffer(shared_arr, dtype=chunkit.get_dtype()).reshape(chunkit.get_shape())
-        # Decompress the chunk
+        # all chunks are compressed by native threads into one buffer
+        self._compress_data, self._offsets = compress_numpy_chunks(
+            self._raw_arr, self._chunkit, nthreads, tolerance, rate, precision)
 
-        decompress_numpy_portion(compress_data[ichunk], np_arr, chunkit, ichunk)
     def decompress(self,nthreads=-1):
-        """Compress array
+        """Decompress array
             nthreads - Number of threads to use (defaults to all)
         """
         
         if nthreads==-1:
             nthreads=cpu_count()
-        global compress_data
-        compress_data = self._compress_data
-        # Initialize multiprocessing pool
-        pool = Pool(processes=nthreads, initializer=self._pool_initializer, 
-                    initargs=(self._raw_arr, self._chunkit))
-        # Create tasks for the pool
-        tasks = [ichunk for ichunk in range(self._chunkit.get_nchunks())]
-
-        # Execute the tasks in parallel
-        pool.map(self._decompress_chunk, tasks)
-
-        # Close the pool and wait for tasks to complete
-        pool.close()
-        pool.join()
+        decompress_numpy_chunks(self._compress_data, self._offsets,
+                                self._raw_arr, self._chunkit, nthreads)
 
 def write_json_header(filename, dimensions, block_splits, compressed_files):
     """